@@ -0,0 +1,191 @@
+// disc_bench.cpp
+// Disc-image reader (src/iso_titles_extras.cpp) on the host, through its
+// public API only, so "make DISC_REV=<rev> build/disc_bench_rev" builds
+// the same bench against an earlier revision of the reader to compare.
+//
+//   disc_bench read|meta <fixture-dir> [reps]
+//
+// Every image under <fixture-dir>/ISO is grouped by the layout the reader
+// detects (ISO, CSO v1, CSO v2, ZSO, JSO with LZO or zlib, DAX). zlib's
+// inflateInit_/inflateInit2_ are wrapped at link time (see Makefile) to
+// count how often a call sets up an inflate context.
+//   read   ExtractIcon0PNG, reps times per image: a long sequential read
+//          (use a fixture with large icons, --icon-kb). Sectors and MB
+//          per second, the seek+read syscalls each sector cost and the
+//          inflate inits per call.
+//   meta   readDiscMeta for title, DISC_ID, layout and icon, as the app's
+//          title/icon paths do: time, opens and seek+read syscalls per
+//          call, and a hash of everything returned, which must not change
+//          between revisions.
+
+#include "psp_host.h"
+#include "iso_titles_extras.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include <zlib.h>
+
+namespace {
+
+const uint32_t SECTOR = 2048;
+const char* const LAYOUTS[] = { "ISO", "CSO v1", "CSO v2", "ZSO", "JSO", "JSO zl", "DAX" };
+enum { L_COUNT = 7 };
+
+// JSO's codec from the header's method byte (0 LZO, 1 zlib): older readers
+// probe it and report whichever decoded first.
+bool jsoIsZlib(const std::string& path) {
+    uint8_t h[12] = {0};
+    SceUID fd = sceIoOpen(path.c_str(), PSP_O_RDONLY, 0);
+    if (fd < 0) return false;
+    const bool ok = sceIoRead(fd, h, sizeof(h)) == (int)sizeof(h);
+    sceIoClose(fd);
+    return ok && h[10] == 1;
+}
+
+int layoutOf(const std::string& path, const DiscParams& p) {
+    switch (p.format) {
+    case DF_ISO: return 0;
+    case DF_CSO: return p.method == 2 ? 2 : 1;
+    case DF_ZSO: return 3;
+    case DF_JSO: return jsoIsZlib(path) ? 5 : 4;
+    case DF_DAX: return 6;
+    }
+    return -1;
+}
+
+unsigned long long nowUS() { return sceKernelGetSystemTimeWide(); }
+
+unsigned long long gInflateInits = 0;
+
+} // namespace
+
+// -Wl,--wrap: the reader's calls land here, the real ones are __real_*.
+extern "C" {
+int __real_inflateInit_(z_streamp strm, const char* version, int size);
+int __real_inflateInit2_(z_streamp strm, int windowBits, const char* version, int size);
+int __wrap_inflateInit_(z_streamp strm, const char* version, int size) {
+    ++gInflateInits;
+    return __real_inflateInit_(strm, version, size);
+}
+int __wrap_inflateInit2_(z_streamp strm, int windowBits, const char* version, int size) {
+    ++gInflateInits;
+    return __real_inflateInit2_(strm, windowBits, version, size);
+}
+}
+
+namespace {
+
+// Images by layout; the probe's own reads are not measured.
+void findImages(const std::string& dir, std::vector<std::string> (&out)[L_COUNT]) {
+    SceUID d = sceIoDopen(dir.c_str());
+    if (d < 0) return;
+    SceIoDirent ent; memset(&ent, 0, sizeof(ent));
+    while (sceIoDread(d, &ent) > 0) {
+        const std::string path = dir + "/" + ent.d_name;
+        if (ent.d_name[0] == '.') {
+            // "." and ".."
+        } else if (FIO_S_ISDIR(ent.d_stat.st_mode)) {
+            findImages(path, out);
+        } else {
+            DiscParams p;
+            const int l = readDiscMeta(path, nullptr, nullptr, &p, nullptr) ? layoutOf(path, p) : -1;
+            if (l >= 0) out[l].push_back(path);
+            else fprintf(stderr, "disc_bench: %s not readable\n", path.c_str());
+        }
+        memset(&ent, 0, sizeof(ent));
+    }
+    sceIoDclose(d);
+}
+
+void benchRead(const std::vector<std::string> (&images)[L_COUNT], int reps) {
+    printf("%-7s %6s %9s %11s %8s %12s %11s\n", "layout", "calls", "sectors", "sectors/s", "MB/s", "syscalls/sec",
+           "inits/call");
+    for (int l = 0; l < L_COUNT; ++l) {
+        if (images[l].empty()) continue;
+        unsigned calls = 0, failed = 0;
+        unsigned long long sectors = 0, bytes = 0, us = 0, syscalls = 0;
+        std::vector<uint8_t> icon;
+        gInflateInits = 0;
+        for (int r = 0; r < reps; ++r) {
+            for (const std::string& path : images[l]) {
+                pspHostResetIo();
+                const unsigned long long t0 = nowUS();
+                const bool ok = ExtractIcon0PNG(path, icon);
+                us += nowUS() - t0;
+                syscalls += gPspHostIo.seek + gPspHostIo.read;
+                ++calls;
+                if (!ok) { ++failed; continue; }
+                bytes   += icon.size();
+                sectors += (icon.size() + SECTOR - 1) / SECTOR;
+            }
+        }
+        const double s = us ? us / 1e6 : 1e-6;
+        printf("%-7s %6u %9llu %11.0f %8.1f %12.2f %11.1f%s\n", LAYOUTS[l], calls, sectors, sectors / s,
+               bytes / s / (1024.0 * 1024.0), sectors ? (double)syscalls / sectors : 0.0,
+               (double)gInflateInits / calls, failed ? "  [FAILED]" : "");
+    }
+}
+
+// FNV-1a
+void hashBytes(uint64_t& h, const void* p, size_t n) {
+    for (size_t i = 0; i < n; ++i) { h ^= ((const uint8_t*)p)[i]; h *= 0x100000001b3ULL; }
+}
+
+void benchMeta(const std::vector<std::string> (&images)[L_COUNT], int reps) {
+    printf("%-7s %6s %9s %8s %13s %10s  %s\n", "layout", "calls", "us/call", "opens", "seek+read/call",
+           "KB/call", "result hash");
+    for (int l = 0; l < L_COUNT; ++l) {
+        if (images[l].empty()) continue;
+        unsigned calls = 0, failed = 0;
+        unsigned long long us = 0, opens = 0, syscalls = 0, bytes = 0;
+        uint64_t hash = 0xcbf29ce484222325ULL;
+        for (int r = 0; r < reps; ++r) {
+            for (const std::string& path : images[l]) {
+                std::string title, discId;
+                DiscParams params;
+                std::vector<uint8_t> icon;
+                pspHostResetIo();
+                const unsigned long long t0 = nowUS();
+                const bool ok = readDiscMeta(path, &title, &discId, &params, &icon);
+                us += nowUS() - t0;
+                opens += gPspHostIo.open;
+                syscalls += gPspHostIo.seek + gPspHostIo.read;
+                bytes += gPspHostIo.readBytes;
+                ++calls;
+                if (!ok) ++failed;
+                if (r) continue;
+                hashBytes(hash, title.c_str(), title.size() + 1);
+                hashBytes(hash, discId.c_str(), discId.size() + 1);
+                hashBytes(hash, icon.data(), icon.size());
+            }
+        }
+        printf("%-7s %6u %9.1f %8.2f %13.2f %10.1f  %016llx%s\n", LAYOUTS[l], calls, (double)us / calls,
+               (double)opens / calls, (double)syscalls / calls, bytes / 1024.0 / calls,
+               (unsigned long long)hash, failed ? "  [FAILED]" : "");
+    }
+}
+
+int usage() {
+    fprintf(stderr, "usage: disc_bench read|meta <fixture-dir> [reps]\n");
+    return 2;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if (argc < 3) return usage();
+    const std::string mode = argv[1];
+    const int reps = (argc > 3) ? atoi(argv[3]) : 5;
+    pspHostMount("ms0:", argv[2]);
+
+    std::vector<std::string> images[L_COUNT];
+    findImages("ms0:/ISO", images);
+
+    if (mode == "read") benchRead(images, reps);
+    else if (mode == "meta") benchMeta(images, reps);
+    else return usage();
+    return 0;
+}
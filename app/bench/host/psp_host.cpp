@@ -0,0 +1,636 @@
+// psp_host.cpp
+// POSIX/pthread implementations of the PSP calls declared in psp_host.h.
+
+#include "psp_host.h"
+
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <time.h>
+#include <unistd.h>
+#include <utime.h>
+
+#include <intraFont.h>
+#include <kubridge.h>
+
+PspHostIoStats gPspHostIo;
+
+#define COUNT(field) __atomic_add_fetch(&gPspHostIo.field, 1, __ATOMIC_RELAXED)
+
+void pspHostResetIo(void) { memset(&gPspHostIo, 0, sizeof(gPspHostIo)); }
+
+static unsigned gLatencyUs = 0;
+void pspHostSetLatency(unsigned us) { gLatencyUs = us; }
+static void mediaWait() { if (gLatencyUs) usleep(gLatencyUs); }
+
+void pspHostOneCpu(void) {
+    cpu_set_t one;
+    CPU_ZERO(&one);
+    CPU_SET(sched_getcpu() < 0 ? 0 : sched_getcpu(), &one);
+    sched_setaffinity(0, sizeof(one), &one);
+}
+
+// PSP error codes are negative 0x8001xxxx values carrying the errno.
+static int ioError() { return (int)(0x80010000u | (unsigned)(errno & 0xFFFF)); }
+
+// ================================================================
+// Device mounts. Paths are built in fixed buffers: the stand-ins must not
+// allocate, or a bench measuring the app's heap would count them too.
+// ================================================================
+namespace {
+enum { HOST_PATH = 1024 };
+struct Mount { char dev[8]; char dir[HOST_PATH / 2]; };
+Mount gMounts[4];
+int   gMountCount = 0;
+}
+
+void pspHostMount(const char* dev, const char* hostDir) {
+    int i = 0;
+    while (i < gMountCount && strcasecmp(gMounts[i].dev, dev)) ++i;
+    if (i == 4) return;
+    if (i == gMountCount) ++gMountCount;
+    snprintf(gMounts[i].dev, sizeof(gMounts[i].dev), "%s", dev);
+    snprintf(gMounts[i].dir, sizeof(gMounts[i].dir), "%s", hostDir);
+}
+
+// "ms0:/PSP/GAME" -> "<mount>/PSP/GAME"; false for an unmapped device.
+static bool hostPath(const char* psp, char (&out)[HOST_PATH]) {
+    const char* colon = psp ? strchr(psp, ':') : nullptr;
+    if (!colon) { errno = ENOENT; return false; }
+    const size_t devLen = (size_t)(colon - psp) + 1;
+    for (int i = 0; i < gMountCount; ++i) {
+        const Mount& m = gMounts[i];
+        if (strlen(m.dev) != devLen || strncasecmp(m.dev, psp, devLen)) continue;
+        const char* rest = colon + 1;
+        while (*rest == '/') ++rest;
+        const int n = snprintf(out, HOST_PATH, *rest ? "%s/%s" : "%s", m.dir, rest);
+        if (n >= HOST_PATH) { errno = ENAMETOOLONG; return false; }
+        return true;
+    }
+    errno = ENODEV;
+    return false;
+}
+
+static void toDateTime(time_t t, ScePspDateTime& dt) {
+    struct tm tm;
+    localtime_r(&t, &tm);
+    dt.year   = (unsigned short)(tm.tm_year + 1900);
+    dt.month  = (unsigned short)(tm.tm_mon + 1);
+    dt.day    = (unsigned short)tm.tm_mday;
+    dt.hour   = (unsigned short)tm.tm_hour;
+    dt.minute = (unsigned short)tm.tm_min;
+    dt.second = (unsigned short)tm.tm_sec;
+    dt.microsecond = 0;
+}
+
+static void toSceStat(const struct stat& st, SceIoStat* out) {
+    memset(out, 0, sizeof(*out));
+    const bool dir = S_ISDIR(st.st_mode);
+    out->st_mode = (dir ? FIO_S_IFDIR : FIO_S_IFREG) | (st.st_mode & 0777);
+    out->st_attr = dir ? FIO_SO_IFDIR : FIO_SO_IFREG;
+    out->st_size = dir ? 0 : (SceOff)st.st_size;
+    toDateTime(st.st_ctime, out->sce_st_ctime);
+    toDateTime(st.st_atime, out->sce_st_atime);
+    toDateTime(st.st_mtime, out->sce_st_mtime);
+}
+
+// ================================================================
+// Files
+// ================================================================
+SceUID sceIoOpen(const char* file, int flags, SceMode mode) {
+    COUNT(open);
+    const char* leaf = file ? strrchr(file, '/') : nullptr;
+    if (leaf && !strncmp(leaf + 1, "KFE_", 4)) COUNT(openApp);
+    char p[HOST_PATH];
+    if (!hostPath(file, p)) return ioError();
+    int f = 0;
+    switch (flags & PSP_O_RDWR) {
+    case PSP_O_RDONLY: f = O_RDONLY; break;
+    case PSP_O_WRONLY: f = O_WRONLY; break;
+    default:           f = O_RDWR;   break;
+    }
+    if (flags & PSP_O_APPEND) f |= O_APPEND;
+    if (flags & PSP_O_CREAT)  f |= O_CREAT;
+    if (flags & PSP_O_TRUNC)  f |= O_TRUNC;
+    if (flags & PSP_O_EXCL)   f |= O_EXCL;
+    mediaWait();
+    const int fd = open(p, f, mode ? (mode & 0777) : 0666);
+    return fd < 0 ? ioError() : fd;
+}
+
+int sceIoClose(SceUID fd) { return close(fd) < 0 ? ioError() : 0; }
+
+int sceIoRead(SceUID fd, void* data, SceSize size) {
+    COUNT(read);
+    mediaWait();
+    const ssize_t r = read(fd, data, size);
+    if (r < 0) return ioError();
+    __atomic_add_fetch(&gPspHostIo.readBytes, (unsigned long long)r, __ATOMIC_RELAXED);
+    return (int)r;
+}
+
+int sceIoWrite(SceUID fd, const void* data, SceSize size) {
+    COUNT(write);
+    const ssize_t r = write(fd, data, size);
+    return r < 0 ? ioError() : (int)r;
+}
+
+int sceIoLseek32(SceUID fd, int offset, int whence) {
+    COUNT(seek);
+    const off_t r = lseek(fd, offset, whence);
+    return r < 0 ? ioError() : (int)r;
+}
+
+SceOff sceIoLseek(SceUID fd, SceOff offset, int whence) {
+    COUNT(seek);
+    const off_t r = lseek(fd, (off_t)offset, whence);
+    return r < 0 ? (SceOff)ioError() : (SceOff)r;
+}
+
+int sceIoGetstat(const char* file, SceIoStat* out) {
+    COUNT(getstat);
+    char p[HOST_PATH];
+    struct stat st;
+    if (!hostPath(file, p) || stat(p, &st) < 0) return ioError();
+    toSceStat(st, out);
+    return 0;
+}
+
+int sceIoChstat(const char* file, SceIoStat*, int) {
+    char p[HOST_PATH];
+    struct stat st;
+    if (!hostPath(file, p) || stat(p, &st) < 0) return ioError();
+    return 0;   // times are left as they are
+}
+
+int sceIoRemove(const char* file) {
+    COUNT(remove);
+    char p[HOST_PATH];
+    return (hostPath(file, p) && unlink(p) == 0) ? 0 : ioError();
+}
+
+int sceIoRename(const char* oldname, const char* newname) {
+    COUNT(rename);
+    char a[HOST_PATH], b[HOST_PATH];
+    if (!hostPath(oldname, a)) return ioError();
+    // Like the PSP, a bare name renames within the same directory.
+    if (!strchr(newname, ':')) {
+        const char* leaf = strrchr(newname, '/') ? strrchr(newname, '/') + 1 : newname;
+        const int dirLen = (int)(strrchr(a, '/') - a);
+        if (snprintf(b, sizeof(b), "%.*s/%s", dirLen, a, leaf) >= (int)sizeof(b)) { errno = ENAMETOOLONG; return ioError(); }
+    } else if (!hostPath(newname, b)) {
+        return ioError();
+    }
+    return rename(a, b) == 0 ? 0 : ioError();
+}
+
+int sceIoMkdir(const char* dir, SceMode mode) {
+    COUNT(mkdir);
+    char p[HOST_PATH];
+    return (hostPath(dir, p) && mkdir(p, mode ? (mode & 0777) : 0777) == 0) ? 0 : ioError();
+}
+
+int sceIoRmdir(const char* dir) {
+    COUNT(remove);
+    char p[HOST_PATH];
+    return (hostPath(dir, p) && rmdir(p) == 0) ? 0 : ioError();
+}
+
+int sceIoDevctl(const char*, unsigned int, void*, int, void*, int) { return (int)0x80020324; }   // unsupported
+
+// ================================================================
+// Directories: the PSP returns each entry's stat with its name
+// ================================================================
+namespace {
+enum { MAX_DIRS = 256, DIR_BASE = 0x1000 };
+struct OpenDir { DIR* d; char path[HOST_PATH]; };
+OpenDir         gDirs[MAX_DIRS];
+pthread_mutex_t gDirLock = PTHREAD_MUTEX_INITIALIZER;
+}
+
+SceUID sceIoDopen(const char* dirname) {
+    COUNT(dopen);
+    char p[HOST_PATH];
+    if (!hostPath(dirname, p)) return ioError();
+    DIR* d = opendir(p);
+    if (!d) return ioError();
+    pthread_mutex_lock(&gDirLock);
+    int slot = -1;
+    for (int i = 0; i < MAX_DIRS && slot < 0; ++i) if (!gDirs[i].d) slot = i;
+    if (slot >= 0) { gDirs[slot].d = d; memcpy(gDirs[slot].path, p, sizeof(p)); }
+    pthread_mutex_unlock(&gDirLock);
+    if (slot < 0) { closedir(d); errno = EMFILE; return ioError(); }
+    return DIR_BASE + slot;
+}
+
+static OpenDir* dirOf(SceUID fd) {
+    const int slot = fd - DIR_BASE;
+    return (slot >= 0 && slot < MAX_DIRS && gDirs[slot].d) ? &gDirs[slot] : nullptr;
+}
+
+int sceIoDread(SceUID fd, SceIoDirent* dir) {
+    COUNT(dread);
+    OpenDir* od = dirOf(fd);
+    if (!od) { errno = EBADF; return ioError(); }
+    for (;;) {
+        errno = 0;
+        struct dirent* e = readdir(od->d);
+        if (!e) return errno ? ioError() : 0;
+        struct stat st;
+        char full[HOST_PATH];
+        if (snprintf(full, sizeof(full), "%s/%s", od->path, e->d_name) >= (int)sizeof(full)) continue;
+        if (stat(full, &st) < 0) continue;   // vanished meanwhile
+        toSceStat(st, &dir->d_stat);
+        snprintf(dir->d_name, sizeof(dir->d_name), "%s", e->d_name);
+        return 1;
+    }
+}
+
+int sceIoDclose(SceUID fd) {
+    OpenDir* od = dirOf(fd);
+    if (!od) return (int)0x80010009;
+    pthread_mutex_lock(&gDirLock);
+    closedir(od->d);
+    od->d = nullptr;
+    pthread_mutex_unlock(&gDirLock);
+    return 0;
+}
+
+int pspIoOpenDir(const char* dirname)                    { return sceIoDopen(dirname); }
+int pspIoReadDir(SceUID dir, SceIoDirent* dirent)        { return sceIoDread(dir, dirent); }
+int pspIoCloseDir(SceUID dir)                            { return sceIoDclose(dir); }
+int pspIoGetstat(const char* file, SceIoStat* stat)      { return sceIoGetstat(file, stat); }
+int pspIoChstat(const char* file, SceIoStat* stat, int bits) { return sceIoChstat(file, stat, bits); }
+int pspIoDevctl(const char* dev, unsigned int cmd, void* in, int inlen, void* out, int outlen) {
+    return sceIoDevctl(dev, cmd, in, inlen, out, outlen);
+}
+
+// ================================================================
+// Threads
+// ================================================================
+namespace {
+enum { MAX_THREADS = 64, THREAD_BASE = 0x100 };
+struct Thread {
+    bool                 used;
+    pthread_t            th;
+    bool                 started;
+    SceKernelThreadEntry entry;
+    SceSize              arglen;
+    char                 args[256];
+};
+Thread          gThreads[MAX_THREADS];
+pthread_mutex_t gThreadLock = PTHREAD_MUTEX_INITIALIZER;
+__thread int    tThreadId = 0;   // 0 = the process's main thread
+}
+
+static Thread* threadOf(SceUID id) {
+    const int slot = id - THREAD_BASE;
+    return (slot >= 0 && slot < MAX_THREADS && gThreads[slot].used) ? &gThreads[slot] : nullptr;
+}
+
+static void* threadMain(void* p) {
+    Thread* t = (Thread*)p;
+    tThreadId = THREAD_BASE + (int)(t - gThreads);
+    t->entry(t->arglen, t->arglen ? t->args : nullptr);
+    return nullptr;
+}
+
+SceUID sceKernelCreateThread(const char*, SceKernelThreadEntry entry, int, int, SceUInt, SceKernelThreadOptParam*) {
+    pthread_mutex_lock(&gThreadLock);
+    int slot = -1;
+    for (int i = 0; i < MAX_THREADS && slot < 0; ++i) if (!gThreads[i].used) slot = i;
+    if (slot >= 0) { memset(&gThreads[slot], 0, sizeof(Thread)); gThreads[slot].used = true; gThreads[slot].entry = entry; }
+    pthread_mutex_unlock(&gThreadLock);
+    return slot < 0 ? (int)0x80020064 : THREAD_BASE + slot;
+}
+
+int sceKernelStartThread(SceUID thid, SceSize arglen, void* argp) {
+    Thread* t = threadOf(thid);
+    if (!t || t->started || arglen > sizeof(t->args)) return (int)0x80020198;
+    t->arglen = arglen;
+    if (arglen) memcpy(t->args, argp, arglen);   // the kernel copies args to the new stack too
+    t->started = pthread_create(&t->th, nullptr, threadMain, t) == 0;
+    return t->started ? 0 : (int)0x80020190;
+}
+
+int sceKernelWaitThreadEnd(SceUID thid, SceUInt*) {
+    Thread* t = threadOf(thid);
+    if (!t) return (int)0x80020198;
+    if (t->started) { pthread_join(t->th, nullptr); t->started = false; }
+    return 0;
+}
+
+int sceKernelDeleteThread(SceUID thid) {
+    Thread* t = threadOf(thid);
+    if (!t) return (int)0x80020198;
+    if (t->started) { pthread_detach(t->th); t->started = false; }
+    pthread_mutex_lock(&gThreadLock);
+    t->used = false;
+    pthread_mutex_unlock(&gThreadLock);
+    return 0;
+}
+
+int sceKernelExitDeleteThread(int)         { pthread_exit(nullptr); }
+int sceKernelTerminateDeleteThread(SceUID) { return (int)0x80020198; }   // not needed by the app
+int sceKernelGetThreadId(void)             { return tThreadId ? tThreadId : 1; }
+int sceKernelChangeThreadPriority(SceUID, int) { return 0; }
+
+int sceKernelReferThreadStatus(SceUID thid, SceKernelThreadInfo* info) {
+    if (!info) return (int)0x80020198;
+    memset(info, 0, sizeof(*info));
+    info->size = sizeof(*info);
+    info->initPriority = info->currentPriority = 0x20;
+    info->status = (thid == 0 || threadOf(thid)) ? 1 : 0;
+    return 0;
+}
+
+int sceKernelDelayThread(SceUInt delay) {
+    if (delay) usleep(delay); else sched_yield();
+    return 0;
+}
+int sceKernelDelayThreadCB(SceUInt delay) { return sceKernelDelayThread(delay); }
+int sceKernelSleepThread(void)   { for (;;) pause(); }
+int sceKernelSleepThreadCB(void) { for (;;) pause(); }
+int sceKernelCreateCallback(const char*, SceKernelCallbackFunction, void*) { return 1; }
+int sceKernelRegisterExitCallback(int) { return 0; }
+void sceKernelExitGame(void) { exit(0); }
+
+// ================================================================
+// Semaphores and LwMutexes
+// ================================================================
+namespace {
+enum { MAX_SEMAS = 128, MAX_LWMUTEXES = 64 };
+struct Sema { bool used; int count, max; pthread_mutex_t m; pthread_cond_t c; };
+Sema            gSemas[MAX_SEMAS];
+pthread_mutex_t gLwMutexes[MAX_LWMUTEXES];
+int             gLwMutexCount = 0;
+pthread_mutex_t gSemaLock = PTHREAD_MUTEX_INITIALIZER;
+}
+
+static Sema* semaOf(SceUID id) {
+    return (id >= 1 && id <= MAX_SEMAS && gSemas[id - 1].used) ? &gSemas[id - 1] : nullptr;
+}
+
+SceUID sceKernelCreateSema(const char*, SceUInt, int initVal, int maxVal, SceKernelSemaOptParam*) {
+    pthread_mutex_lock(&gSemaLock);
+    int slot = -1;
+    for (int i = 0; i < MAX_SEMAS && slot < 0; ++i) if (!gSemas[i].used) slot = i;
+    if (slot >= 0) {
+        Sema& s = gSemas[slot];
+        s.used = true; s.count = initVal; s.max = maxVal;
+        pthread_mutex_init(&s.m, nullptr);
+        pthread_cond_init(&s.c, nullptr);
+    }
+    pthread_mutex_unlock(&gSemaLock);
+    return slot < 0 ? (int)0x80020190 : slot + 1;
+}
+
+int sceKernelDeleteSema(SceUID id) {
+    Sema* s = semaOf(id);
+    if (!s) return (int)0x80020199;
+    pthread_mutex_lock(&gSemaLock);
+    s->used = false;
+    pthread_mutex_unlock(&gSemaLock);
+    return 0;
+}
+
+int sceKernelSignalSema(SceUID id, int signal) {
+    Sema* s = semaOf(id);
+    if (!s) return (int)0x80020199;
+    pthread_mutex_lock(&s->m);
+    const bool over = s->count + signal > s->max;
+    if (!over) s->count += signal;
+    pthread_cond_broadcast(&s->c);
+    pthread_mutex_unlock(&s->m);
+    return over ? (int)0x8002019d : 0;
+}
+
+int sceKernelWaitSema(SceUID id, int signal, SceUInt* timeout) {
+    Sema* s = semaOf(id);
+    if (!s) return (int)0x80020199;
+    struct timespec until;
+    if (timeout) {
+        clock_gettime(CLOCK_REALTIME, &until);
+        until.tv_sec  += *timeout / 1000000;
+        until.tv_nsec += (long)(*timeout % 1000000) * 1000;
+        if (until.tv_nsec >= 1000000000L) { until.tv_sec++; until.tv_nsec -= 1000000000L; }
+    }
+    int ret = 0;
+    pthread_mutex_lock(&s->m);
+    while (s->count < signal) {
+        if (!timeout) pthread_cond_wait(&s->c, &s->m);
+        else if (pthread_cond_timedwait(&s->c, &s->m, &until) == ETIMEDOUT) { ret = (int)0x800201a8; break; }
+    }
+    if (!ret) s->count -= signal;
+    pthread_mutex_unlock(&s->m);
+    return ret;
+}
+
+int sceKernelPollSema(SceUID id, int signal) {
+    Sema* s = semaOf(id);
+    if (!s) return (int)0x80020199;
+    pthread_mutex_lock(&s->m);
+    const bool ok = s->count >= signal;
+    if (ok) s->count -= signal;
+    pthread_mutex_unlock(&s->m);
+    return ok ? 0 : (int)0x800201a4;
+}
+
+int sceKernelCreateLwMutex(SceLwMutexWorkarea* work, const char*, SceUInt32 attr, int count, int*) {
+    pthread_mutex_lock(&gSemaLock);
+    const int slot = (gLwMutexCount < MAX_LWMUTEXES) ? gLwMutexCount++ : -1;
+    pthread_mutex_unlock(&gSemaLock);
+    if (slot < 0) return (int)0x80020190;
+    pthread_mutexattr_t a;
+    pthread_mutexattr_init(&a);
+    if (attr & 0x200) pthread_mutexattr_settype(&a, PTHREAD_MUTEX_RECURSIVE);
+    pthread_mutex_init(&gLwMutexes[slot], &a);
+    pthread_mutexattr_destroy(&a);
+    memset(work, 0, sizeof(*work));
+    work->attr = (int)attr;
+    work->uid  = slot + 1;
+    for (int i = 0; i < count; ++i) pthread_mutex_lock(&gLwMutexes[slot]);
+    return 0;
+}
+
+int sceKernelDeleteLwMutex(SceLwMutexWorkarea* work) { work->uid = 0; return 0; }
+
+int sceKernelLockLwMutex(SceLwMutexWorkarea* work, int count, unsigned int*) {
+    if (work->uid < 1) return (int)0x800201ca;
+    for (int i = 0; i < count; ++i) pthread_mutex_lock(&gLwMutexes[work->uid - 1]);
+    return 0;
+}
+
+int sceKernelUnlockLwMutex(SceLwMutexWorkarea* work, int count) {
+    if (work->uid < 1) return (int)0x800201ca;
+    for (int i = 0; i < count; ++i) pthread_mutex_unlock(&gLwMutexes[work->uid - 1]);
+    return 0;
+}
+
+// ================================================================
+// Clock, cache, modules, memory
+// ================================================================
+u64 sceKernelGetSystemTimeWide(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (u64)ts.tv_sec * 1000000ULL + (u64)ts.tv_nsec / 1000ULL;
+}
+unsigned int sceKernelGetSystemTimeLow(void) { return (unsigned int)sceKernelGetSystemTimeWide(); }
+
+void sceKernelDcacheWritebackRange(const void*, unsigned int) {}
+void sceKernelDcacheWritebackAll(void) {}
+void sceKernelDcacheWritebackInvalidateAll(void) {}
+
+SceUID sceKernelLoadModule(const char*, int, SceKernelLMOption*) { return (int)0x8002012e; }
+int sceKernelStartModule(SceUID, SceSize, void*, int*, SceKernelSMOption*) { return (int)0x8002012e; }
+SceUID kuKernelLoadModule(const char*, int, SceKernelLMOption*) { return (int)0x8002012e; }
+SceSize sceKernelMaxFreeMemSize(void)   { return 24u << 20; }
+SceSize sceKernelTotalFreeMemSize(void) { return 24u << 20; }
+
+// RTC ticks are microseconds since 0001-01-01.
+static long long daysFromCivil(int y, unsigned m, unsigned d) {
+    y -= m <= 2;
+    const long long era = (y >= 0 ? y : y - 399) / 400;
+    const unsigned yoe = (unsigned)(y - era * 400);
+    const unsigned doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+    const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + (long long)doe - 719468;   // days since 1970-01-01
+}
+static const long long DAYS_0001_TO_1970 = 719162;
+
+int sceRtcGetCurrentClockLocalTime(ScePspDateTime* time) {
+    struct timeval tv;
+    gettimeofday(&tv, nullptr);
+    toDateTime(tv.tv_sec, *time);
+    time->microsecond = (unsigned)tv.tv_usec;
+    return 0;
+}
+
+int sceRtcGetTick(const ScePspDateTime* dt, u64* tick) {
+    const long long days = daysFromCivil(dt->year, dt->month, dt->day) + DAYS_0001_TO_1970;
+    const long long secs = days * 86400LL + dt->hour * 3600LL + dt->minute * 60LL + dt->second;
+    *tick = (u64)secs * 1000000ULL + dt->microsecond;
+    return 0;
+}
+
+int sceRtcSetTick(ScePspDateTime* dt, const u64* tick) {
+    long long secs = (long long)(*tick / 1000000ULL);
+    long long z = secs / 86400 - DAYS_0001_TO_1970 + 719468;
+    const long long rem = secs % 86400;
+    const long long era = (z >= 0 ? z : z - 146096) / 146097;
+    const unsigned doe = (unsigned)(z - era * 146097);
+    const unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    const unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    const unsigned mp = (5 * doy + 2) / 153;
+    const unsigned d = doy - (153 * mp + 2) / 5 + 1;
+    const unsigned m = mp < 10 ? mp + 3 : mp - 9;
+    dt->year   = (unsigned short)((long long)yoe + era * 400 + (m <= 2));
+    dt->month  = (unsigned short)m;
+    dt->day    = (unsigned short)d;
+    dt->hour   = (unsigned short)(rem / 3600);
+    dt->minute = (unsigned short)(rem / 60 % 60);
+    dt->second = (unsigned short)(rem % 60);
+    dt->microsecond = (unsigned)(*tick % 1000000ULL);
+    return 0;
+}
+
+// ================================================================
+// Display, GU, controller, power, OSK, debug screen, intraFont: no-ops
+// ================================================================
+int sceDisplaySetMode(int, int, int) { return 0; }
+int sceDisplaySetFrameBuf(void*, int, int, int) { return 0; }
+int sceDisplayWaitVblankStart(void) { return 0; }
+int sceDisplayWaitVblankStartCB(void) { return 0; }
+
+static char   gGuList[256 * 1024] __attribute__((aligned(16)));
+static size_t gGuUsed = 0;
+void  sceGuInit(void) {}
+void  sceGuTerm(void) {}
+void  sceGuStart(int, void*) { gGuUsed = 0; }
+int   sceGuFinish(void) { return 0; }
+int   sceGuSync(int, int) { return 0; }
+void* sceGuGetMemory(int size) {
+    const size_t n = ((size_t)size + 15) & ~(size_t)15;
+    if (gGuUsed + n > sizeof(gGuList)) gGuUsed = 0;
+    void* p = gGuList + gGuUsed;
+    gGuUsed += n;
+    return p;
+}
+void* sceGuSwapBuffers(void) { return nullptr; }
+int   sceGuDisplay(int) { return 0; }
+void  sceGuDrawBuffer(int, void*, int) {}
+void  sceGuDispBuffer(int, int, void*, int) {}
+void  sceGuDepthBuffer(void*, int) {}
+void  sceGuOffset(unsigned int, unsigned int) {}
+void  sceGuViewport(int, int, int, int) {}
+void  sceGuDepthRange(int, int) {}
+void  sceGuDepthFunc(int) {}
+void  sceGuDepthMask(int) {}
+void  sceGuScissor(int, int, int, int) {}
+void  sceGuEnable(int) {}
+void  sceGuDisable(int) {}
+void  sceGuFrontFace(int) {}
+void  sceGuShadeModel(int) {}
+void  sceGuAmbientColor(unsigned int) {}
+void  sceGuColor(unsigned int) {}
+void  sceGuClearColor(unsigned int) {}
+void  sceGuClearDepth(unsigned int) {}
+void  sceGuClear(int) {}
+void  sceGuBlendFunc(int, int, int, unsigned int, unsigned int) {}
+void  sceGuTexMode(int, int, int, int) {}
+void  sceGuTexFunc(int, int) {}
+void  sceGuTexImage(int, int, int, int, const void*) {}
+void  sceGuTexFilter(int, int) {}
+void  sceGuTexWrap(int, int) {}
+void  sceGuTexScale(float, float) {}
+void  sceGuTexOffset(float, float) {}
+void  sceGuTexFlush(void) {}
+void  sceGuTexSync(void) {}
+void  sceGuDrawArray(int, int, int, const void*, const void*) {}
+void  sceGumMatrixMode(int) {}
+void  sceGumLoadIdentity(void) {}
+
+int sceCtrlSetSamplingCycle(int) { return 0; }
+int sceCtrlSetSamplingMode(int) { return 0; }
+int sceCtrlReadBufferPositive(SceCtrlData* pad, int) { memset(pad, 0, sizeof(*pad)); return 1; }
+int sceCtrlPeekBufferPositive(SceCtrlData* pad, int) { memset(pad, 0, sizeof(*pad)); return 1; }
+
+int scePowerGetCpuClockFrequencyInt(void) { return 333; }
+int scePowerGetBusClockFrequencyInt(void) { return 166; }
+int scePowerSetClockFrequency(int, int, int) { return 0; }
+int scePowerLock(int) { return 0; }
+int scePowerUnlock(int) { return 0; }
+
+int sceUtilityOskInitStart(SceUtilityOskParams*) { return (int)0x80110005; }
+int sceUtilityOskShutdownStart(void) { return 0; }
+int sceUtilityOskUpdate(int) { return 0; }
+int sceUtilityOskGetStatus(void) { return PSP_UTILITY_DIALOG_NONE; }
+
+void pspDebugScreenInit(void) {}
+void pspDebugScreenClear(void) {}
+void pspDebugScreenSetXY(int, int) {}
+void pspDebugScreenSetTextColor(unsigned int) {}
+void pspDebugScreenSetBackColor(unsigned int) {}
+void pspDebugScreenPrintf(const char* fmt, ...) {
+    va_list ap; va_start(ap, fmt);
+    vfprintf(stderr, fmt, ap);
+    va_end(ap);
+}
+
+int   intraFontInit(void) { return 1; }
+void  intraFontShutdown(void) {}
+intraFont* intraFontLoad(const char*, unsigned int) { return nullptr; }
+void  intraFontUnload(intraFont*) {}
+void  intraFontActivate(intraFont*) {}
+void  intraFontSetStyle(intraFont*, float, unsigned int, unsigned int, float, unsigned int) {}
+float intraFontPrint(intraFont*, float x, float, const char*) { return x; }
+float intraFontPrintf(intraFont*, float x, float, const char*, ...) { return x; }
+float intraFontMeasureText(intraFont*, const char*) { return 0.0f; }
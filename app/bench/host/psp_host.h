@@ -0,0 +1,426 @@
+// psp_host.h
+// Host (Linux/macOS) stand-in for the PSP SDK headers the app includes, so
+// main.cpp and src/ build as plain C++ for the benchmarks in app/bench.
+// Every <psp*.h> in this directory includes this file.
+//
+// sceIo and the fs_driver calls (pspIo*) go to POSIX under a directory
+// mounted per device (pspHostMount) and are counted (gPspHostIo). Threads,
+// semaphores and LwMutexes map to pthreads. Display, GU, controller,
+// power, OSK, intraFont and kubridge calls do nothing.
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ---------- types ----------
+typedef int            SceUID;
+typedef unsigned int   SceSize;
+typedef int            SceMode;
+typedef long long      SceOff;
+typedef unsigned int   SceUInt;
+typedef int            SceInt32;
+typedef unsigned int   SceUInt32;
+typedef unsigned short SceWChar16;
+typedef uint8_t  u8;  typedef uint16_t u16; typedef uint32_t u32; typedef unsigned long long u64;
+typedef int8_t   s8;  typedef int16_t  s16; typedef int32_t  s32; typedef long long s64;
+typedef struct SceKernelLMOption SceKernelLMOption;
+typedef struct SceKernelSMOption SceKernelSMOption;
+typedef struct SceModule SceModule;
+typedef struct ScePspFVector3 { float x, y, z; } ScePspFVector3;
+
+typedef struct ScePspDateTime {
+    unsigned short year, month, day, hour, minute, second;
+    unsigned int   microsecond;
+} ScePspDateTime;
+
+// ---------- pspiofilemgr ----------
+typedef struct SceIoStat {
+    SceMode        st_mode;
+    unsigned int   st_attr;
+    SceOff         st_size;
+    ScePspDateTime sce_st_ctime, sce_st_atime, sce_st_mtime;
+    unsigned int   st_private[6];
+} SceIoStat;
+typedef struct SceIoDirent {
+    SceIoStat d_stat;
+    char      d_name[256];
+    void*     d_private;
+    int       dummy;
+} SceIoDirent;
+
+#define FIO_S_IFMT   0xF000
+#define FIO_S_IFLNK  0x4000
+#define FIO_S_IFDIR  0x1000
+#define FIO_S_IFREG  0x2000
+#define FIO_S_ISDIR(m) (((m) & FIO_S_IFMT) == FIO_S_IFDIR)
+#define FIO_S_ISREG(m) (((m) & FIO_S_IFMT) == FIO_S_IFREG)
+#define FIO_SO_IFMT  0x0038
+#define FIO_SO_IFDIR 0x0010
+#define FIO_SO_IFREG 0x0020
+#define FIO_CST_MODE 0x0001
+#define FIO_CST_ATTR 0x0002
+#define FIO_CST_SIZE 0x0004
+#define FIO_CST_CT   0x0008
+#define FIO_CST_AT   0x0010
+#define FIO_CST_MT   0x0020
+
+#define PSP_O_RDONLY 0x0001
+#define PSP_O_WRONLY 0x0002
+#define PSP_O_RDWR   (PSP_O_RDONLY | PSP_O_WRONLY)
+#define PSP_O_NBLOCK 0x0004
+#define PSP_O_DIROPEN 0x0008
+#define PSP_O_APPEND 0x0100
+#define PSP_O_CREAT  0x0200
+#define PSP_O_TRUNC  0x0400
+#define PSP_O_EXCL   0x0800
+#define PSP_SEEK_SET 0
+#define PSP_SEEK_CUR 1
+#define PSP_SEEK_END 2
+
+SceUID sceIoOpen(const char* file, int flags, SceMode mode);
+int    sceIoClose(SceUID fd);
+int    sceIoRead(SceUID fd, void* data, SceSize size);
+int    sceIoWrite(SceUID fd, const void* data, SceSize size);
+int    sceIoLseek32(SceUID fd, int offset, int whence);
+SceOff sceIoLseek(SceUID fd, SceOff offset, int whence);
+int    sceIoGetstat(const char* file, SceIoStat* stat);
+int    sceIoChstat(const char* file, SceIoStat* stat, int bits);
+int    sceIoRemove(const char* file);
+int    sceIoRename(const char* oldname, const char* newname);
+int    sceIoMkdir(const char* dir, SceMode mode);
+int    sceIoRmdir(const char* dir);
+SceUID sceIoDopen(const char* dirname);
+int    sceIoDread(SceUID fd, SceIoDirent* dir);
+int    sceIoDclose(SceUID fd);
+int    sceIoDevctl(const char* dev, unsigned int cmd, void* indata, int inlen, void* outdata, int outlen);
+
+// fs_driver.prx exports (kernel-mode twins of the sceIo calls)
+int pspIoOpenDir(const char* dirname);
+int pspIoReadDir(SceUID dir, SceIoDirent* dirent);
+int pspIoCloseDir(SceUID dir);
+int pspIoGetstat(const char* file, SceIoStat* stat);
+int pspIoChstat(const char* file, SceIoStat* stat, int bits);
+int pspIoDevctl(const char* dev, unsigned int cmd, void* indata, int inlen, void* outdata, int outlen);
+
+// ---------- pspthreadman / pspkernel ----------
+typedef int (*SceKernelThreadEntry)(SceSize args, void* argp);
+typedef int (*SceKernelCallbackFunction)(int arg1, int arg2, void* arg);
+typedef struct SceKernelThreadOptParam SceKernelThreadOptParam;
+typedef struct SceKernelSemaOptParam SceKernelSemaOptParam;
+typedef struct SceKernelThreadInfo {
+    SceSize size;
+    char    name[32];
+    SceUInt attr;
+    int     status;
+    SceKernelThreadEntry entry;
+    void*   stack;
+    int     stackSize;
+    void*   gpReg;
+    int     initPriority, currentPriority;
+    int     waitType;
+    SceUID  waitId;
+    int     wakeupCount, exitStatus;
+    int     runClocks[2];
+    SceUInt intrPreemptCount, threadPreemptCount, releaseCount;
+} SceKernelThreadInfo;
+typedef struct SceLwMutexWorkarea {
+    int    count;
+    SceUID thread;
+    int    attr;
+    int    numWaitThreads;
+    SceUID uid;
+    int    pad[3];
+} SceLwMutexWorkarea;
+
+#define THREAD_ATTR_VFPU 0x00004000
+#define THREAD_ATTR_USER 0x80000000
+#define PSP_MODULE_INFO(name, attr, major, minor) \
+    static const char psp_host_module_name[] __attribute__((unused)) = name
+#define PSP_MAIN_THREAD_ATTR(attr) \
+    static const unsigned psp_host_main_attr __attribute__((unused)) = (attr)
+#define PSP_HEAP_SIZE_KB(kb) \
+    static const int psp_host_heap_kb __attribute__((unused)) = (kb)
+
+SceUID sceKernelCreateThread(const char* name, SceKernelThreadEntry entry, int initPriority,
+                             int stackSize, SceUInt attr, SceKernelThreadOptParam* option);
+int    sceKernelStartThread(SceUID thid, SceSize arglen, void* argp);
+int    sceKernelWaitThreadEnd(SceUID thid, SceUInt* timeout);
+int    sceKernelDeleteThread(SceUID thid);
+int    sceKernelExitDeleteThread(int status);
+int    sceKernelTerminateDeleteThread(SceUID thid);
+int    sceKernelGetThreadId(void);
+int    sceKernelChangeThreadPriority(SceUID thid, int priority);
+int    sceKernelReferThreadStatus(SceUID thid, SceKernelThreadInfo* info);
+int    sceKernelDelayThread(SceUInt delay);
+int    sceKernelDelayThreadCB(SceUInt delay);
+int    sceKernelSleepThread(void);
+int    sceKernelSleepThreadCB(void);
+int    sceKernelCreateCallback(const char* name, SceKernelCallbackFunction func, void* arg);
+int    sceKernelRegisterExitCallback(int cbid);
+void   sceKernelExitGame(void);
+
+SceUID sceKernelCreateSema(const char* name, SceUInt attr, int initVal, int maxVal, SceKernelSemaOptParam* option);
+int    sceKernelDeleteSema(SceUID semaid);
+int    sceKernelSignalSema(SceUID semaid, int signal);
+int    sceKernelWaitSema(SceUID semaid, int signal, SceUInt* timeout);
+int    sceKernelPollSema(SceUID semaid, int signal);
+
+int sceKernelCreateLwMutex(SceLwMutexWorkarea* work, const char* name, SceUInt32 attr, int count, int* option);
+int sceKernelDeleteLwMutex(SceLwMutexWorkarea* work);
+int sceKernelLockLwMutex(SceLwMutexWorkarea* work, int count, unsigned int* timeout);
+int sceKernelUnlockLwMutex(SceLwMutexWorkarea* work, int count);
+
+u64          sceKernelGetSystemTimeWide(void);
+unsigned int sceKernelGetSystemTimeLow(void);
+void   sceKernelDcacheWritebackRange(const void* p, unsigned int size);
+void   sceKernelDcacheWritebackAll(void);
+void   sceKernelDcacheWritebackInvalidateAll(void);
+SceUID sceKernelLoadModule(const char* path, int flags, SceKernelLMOption* option);
+int    sceKernelStartModule(SceUID modid, SceSize argsize, void* argp, int* status, SceKernelSMOption* option);
+SceSize sceKernelMaxFreeMemSize(void);
+SceSize sceKernelTotalFreeMemSize(void);
+
+// ---------- psprtc ----------
+int sceRtcGetCurrentClockLocalTime(ScePspDateTime* time);
+int sceRtcGetTick(const ScePspDateTime* date, u64* tick);
+int sceRtcSetTick(ScePspDateTime* date, const u64* tick);
+
+// ---------- pspdisplay / pspgu / pspgum ----------
+#define PSP_DISPLAY_PIXEL_FORMAT_565  0
+#define PSP_DISPLAY_PIXEL_FORMAT_8888 3
+#define PSP_DISPLAY_SETBUF_IMMEDIATE  0
+#define PSP_DISPLAY_SETBUF_NEXTFRAME  1
+int sceDisplaySetMode(int mode, int width, int height);
+int sceDisplaySetFrameBuf(void* topaddr, int bufferwidth, int pixelformat, int sync);
+int sceDisplayWaitVblankStart(void);
+int sceDisplayWaitVblankStartCB(void);
+
+#define GU_FALSE 0
+#define GU_TRUE  1
+#define GU_DIRECT 0
+#define GU_ALPHA_TEST   0
+#define GU_DEPTH_TEST   1
+#define GU_SCISSOR_TEST 2
+#define GU_STENCIL_TEST 3
+#define GU_BLEND        4
+#define GU_CULL_FACE    5
+#define GU_DITHER       6
+#define GU_FOG          7
+#define GU_CLIP_PLANES  8
+#define GU_TEXTURE_2D   9
+#define GU_LIGHTING     10
+#define GU_POINTS 0
+#define GU_LINES  1
+#define GU_LINE_STRIP 2
+#define GU_TRIANGLES  3
+#define GU_TRIANGLE_STRIP 4
+#define GU_TRIANGLE_FAN   5
+#define GU_SPRITES 6
+#define GU_TEXTURE_8BIT   (1 << 0)
+#define GU_TEXTURE_16BIT  (2 << 0)
+#define GU_TEXTURE_32BITF (3 << 0)
+#define GU_COLOR_5650 (4 << 2)
+#define GU_COLOR_5551 (5 << 2)
+#define GU_COLOR_4444 (6 << 2)
+#define GU_COLOR_8888 (7 << 2)
+#define GU_VERTEX_8BIT   (1 << 7)
+#define GU_VERTEX_16BIT  (2 << 7)
+#define GU_VERTEX_32BITF (3 << 7)
+#define GU_TRANSFORM_3D (0 << 23)
+#define GU_TRANSFORM_2D (1 << 23)
+#define GU_PSM_5650 0
+#define GU_PSM_5551 1
+#define GU_PSM_4444 2
+#define GU_PSM_8888 3
+#define GU_PSM_T8   5
+#define GU_FLAT   0
+#define GU_SMOOTH 1
+#define GU_CW  0
+#define GU_CCW 1
+#define GU_NEVER 0
+#define GU_ALWAYS 1
+#define GU_EQUAL 2
+#define GU_NOTEQUAL 3
+#define GU_LESS 4
+#define GU_LEQUAL 5
+#define GU_GREATER 6
+#define GU_GEQUAL 7
+#define GU_ADD 0
+#define GU_SRC_COLOR 0
+#define GU_ONE_MINUS_SRC_COLOR 1
+#define GU_SRC_ALPHA 2
+#define GU_ONE_MINUS_SRC_ALPHA 3
+#define GU_FIX 10
+#define GU_NEAREST 0
+#define GU_LINEAR  1
+#define GU_REPEAT 0
+#define GU_CLAMP  1
+#define GU_TFX_MODULATE 0
+#define GU_TFX_DECAL    1
+#define GU_TFX_BLEND    2
+#define GU_TFX_REPLACE  3
+#define GU_TFX_ADD      4
+#define GU_TCC_RGB  0
+#define GU_TCC_RGBA 1
+#define GU_COLOR_BUFFER_BIT   1
+#define GU_STENCIL_BUFFER_BIT 2
+#define GU_DEPTH_BUFFER_BIT   4
+#define GU_FAST_CLEAR_BIT     16
+#define GU_SYNC_FINISH 0
+#define GU_SYNC_WAIT   0
+#define GU_ABGR(a,b,g,r) (((a) << 24)|((b) << 16)|((g) << 8)|(r))
+#define GU_RGBA(r,g,b,a) GU_ABGR((a),(b),(g),(r))
+
+void  sceGuInit(void);
+void  sceGuTerm(void);
+void  sceGuStart(int cid, void* list);
+int   sceGuFinish(void);
+int   sceGuSync(int mode, int what);
+void* sceGuGetMemory(int size);
+void* sceGuSwapBuffers(void);
+int   sceGuDisplay(int state);
+void  sceGuDrawBuffer(int psm, void* fbp, int fbw);
+void  sceGuDispBuffer(int width, int height, void* dispbp, int dispbw);
+void  sceGuDepthBuffer(void* zbp, int zbw);
+void  sceGuOffset(unsigned int x, unsigned int y);
+void  sceGuViewport(int cx, int cy, int width, int height);
+void  sceGuDepthRange(int near, int far);
+void  sceGuDepthFunc(int function);
+void  sceGuDepthMask(int mask);
+void  sceGuScissor(int x, int y, int w, int h);
+void  sceGuEnable(int state);
+void  sceGuDisable(int state);
+void  sceGuFrontFace(int order);
+void  sceGuShadeModel(int mode);
+void  sceGuAmbientColor(unsigned int color);
+void  sceGuColor(unsigned int color);
+void  sceGuClearColor(unsigned int color);
+void  sceGuClearDepth(unsigned int depth);
+void  sceGuClear(int flags);
+void  sceGuBlendFunc(int op, int src, int dest, unsigned int srcfix, unsigned int destfix);
+void  sceGuTexMode(int tpsm, int maxmips, int a2, int swizzle);
+void  sceGuTexFunc(int tfx, int tcc);
+void  sceGuTexImage(int mipmap, int width, int height, int tbw, const void* tbp);
+void  sceGuTexFilter(int min, int mag);
+void  sceGuTexWrap(int u, int v);
+void  sceGuTexScale(float u, float v);
+void  sceGuTexOffset(float u, float v);
+void  sceGuTexFlush(void);
+void  sceGuTexSync(void);
+void  sceGuDrawArray(int prim, int vtype, int count, const void* indices, const void* vertices);
+void  sceGumMatrixMode(int mode);
+void  sceGumLoadIdentity(void);
+
+// ---------- pspctrl ----------
+enum PspCtrlButtons {
+    PSP_CTRL_SELECT   = 0x000001,
+    PSP_CTRL_START    = 0x000008,
+    PSP_CTRL_UP       = 0x000010,
+    PSP_CTRL_RIGHT    = 0x000020,
+    PSP_CTRL_DOWN     = 0x000040,
+    PSP_CTRL_LEFT     = 0x000080,
+    PSP_CTRL_LTRIGGER = 0x000100,
+    PSP_CTRL_RTRIGGER = 0x000200,
+    PSP_CTRL_TRIANGLE = 0x001000,
+    PSP_CTRL_CIRCLE   = 0x002000,
+    PSP_CTRL_CROSS    = 0x004000,
+    PSP_CTRL_SQUARE   = 0x008000,
+    PSP_CTRL_HOME     = 0x010000,
+    PSP_CTRL_HOLD     = 0x020000,
+    PSP_CTRL_NOTE     = 0x800000
+};
+#define PSP_CTRL_MODE_DIGITAL 0
+#define PSP_CTRL_MODE_ANALOG  1
+typedef struct SceCtrlData {
+    unsigned int  TimeStamp;
+    unsigned int  Buttons;
+    unsigned char Lx, Ly;
+    unsigned char Rsrv[6];
+} SceCtrlData;
+int sceCtrlSetSamplingCycle(int cycle);
+int sceCtrlSetSamplingMode(int mode);
+int sceCtrlReadBufferPositive(SceCtrlData* pad, int count);
+int sceCtrlPeekBufferPositive(SceCtrlData* pad, int count);
+
+// ---------- pspdebug ----------
+void pspDebugScreenInit(void);
+void pspDebugScreenClear(void);
+void pspDebugScreenSetXY(int x, int y);
+void pspDebugScreenSetTextColor(unsigned int color);
+void pspDebugScreenSetBackColor(unsigned int color);
+void pspDebugScreenPrintf(const char* fmt, ...) __attribute__((format(printf, 1, 2)));
+
+// ---------- psppower ----------
+int scePowerGetCpuClockFrequencyInt(void);
+int scePowerGetBusClockFrequencyInt(void);
+int scePowerSetClockFrequency(int pllfreq, int cpufreq, int busfreq);
+int scePowerLock(int unknown);
+int scePowerUnlock(int unknown);
+
+// ---------- psputility / psputility_osk ----------
+#define PSP_SYSTEMPARAM_LANGUAGE_ENGLISH 1
+#define PSP_UTILITY_ACCEPT_CIRCLE 0
+#define PSP_UTILITY_ACCEPT_CROSS  1
+enum { PSP_UTILITY_DIALOG_NONE = 0, PSP_UTILITY_DIALOG_INIT, PSP_UTILITY_DIALOG_VISIBLE,
+       PSP_UTILITY_DIALOG_QUIT, PSP_UTILITY_DIALOG_FINISHED };
+enum { PSP_UTILITY_OSK_RESULT_UNCHANGED = 0, PSP_UTILITY_OSK_RESULT_CANCELLED, PSP_UTILITY_OSK_RESULT_CHANGED };
+#define PSP_UTILITY_OSK_LANGUAGE_DEFAULT 0x00
+#define PSP_UTILITY_OSK_INPUTTYPE_ALL    0x00000000
+#define PSP_UTILITY_OSK_INPUTTYPE_LATIN_DIGIT         0x00000001
+#define PSP_UTILITY_OSK_INPUTTYPE_LATIN_SYMBOL        0x00000002
+#define PSP_UTILITY_OSK_INPUTTYPE_LATIN_LOWERCASE     0x00000004
+#define PSP_UTILITY_OSK_INPUTTYPE_LATIN_UPPERCASE     0x00000008
+typedef struct pspUtilityDialogCommon {
+    unsigned int size;
+    int language, buttonSwap, graphicsThread, accessThread, fontThread, soundThread, result;
+    int reserved[4];
+} pspUtilityDialogCommon;
+typedef struct SceUtilityOskData {
+    int unk_00, unk_04, language, unk_12, inputtype, lines, unk_24;
+    unsigned short* desc;
+    unsigned short* intext;
+    int outtextlength;
+    unsigned short* outtext;
+    int result;
+    int outtextlimit;
+} SceUtilityOskData;
+typedef struct SceUtilityOskParams {
+    pspUtilityDialogCommon base;
+    int datacount;
+    SceUtilityOskData* data;
+    int state;
+    int unk_60;
+} SceUtilityOskParams;
+int sceUtilityOskInitStart(SceUtilityOskParams* params);
+int sceUtilityOskShutdownStart(void);
+int sceUtilityOskUpdate(int n);
+int sceUtilityOskGetStatus(void);
+
+// ---------- host side ----------
+// Map a device ("ms0:", "ef0:") to a host directory; paths on an unmapped
+// device fail like a missing device.
+void pspHostMount(const char* dev, const char* hostDir);
+
+// Syscalls made through the stand-ins, by kind; pspHostResetIo() zeroes them.
+// openApp: the opens of the app's own KFE_* files (catalog, log), so
+// open - openApp is what the library itself cost.
+typedef struct PspHostIoStats {
+    unsigned open, openApp, read, write, seek, getstat, dopen, dread, mkdir, remove, rename;
+    unsigned long long readBytes;
+} PspHostIoStats;
+extern PspHostIoStats gPspHostIo;
+void pspHostResetIo(void);
+
+// Memory stick latency: every open and read waits us microseconds (0, the
+// default, is off). Host files come from the page cache otherwise.
+void pspHostSetLatency(unsigned us);
+// Run every thread of the process on one CPU, as the PSP runs the app's:
+// threads then only help where one waits on I/O while another computes.
+void pspHostOneCpu(void);
+
+#ifdef __cplusplus
+}
+#endif
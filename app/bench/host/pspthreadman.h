@@ -0,0 +1,3 @@
+// Host stand-in, see psp_host.h.
+#pragma once
+#include "psp_host.h"
@@ -0,0 +1,402 @@
+// mkfixture.cpp
+// Synthetic memory-stick trees for the host benchmarks (see README.md).
+//
+//   mkfixture card <dir> [--iso N] [--cso N] [--cso2 N] [--zso N] [--jso N]
+//                        [--jsoz N] [--dax N] [--eboot N] [--cats N] [--iso-kb K] [--icon-kb K]
+//                        [--icon-fill noise|data]
+//   mkfixture deep <dir> <depth> <fanout> <files>
+//
+// "card" lays out ISO/, ISO/CAT_*, PSP/GAME/, PSP/GAME/CAT_* and the other
+// game roots the scanner walks. Every disc image carries its own TITLE,
+// DISC_ID and ICON0.PNG in PSP_GAME; every EBOOT folder an EBOOT.PBP with a
+// PARAM.SFO, and every fourth one subfolders for the size walk. Images are
+// really compressed (deflate / zlib / LZ4 / LZO), so decoding costs what it
+// costs on a card. "deep" builds a balanced tree of small files for the
+// walkers. Output is deterministic for the same arguments.
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include <zlib.h>
+#include "lz4.h"
+#include "minilzo.h"
+
+namespace {
+
+const uint32_t SECTOR = 2048;
+
+struct Opts {
+    int iso = 40, cso = 40, cso2 = 20, zso = 20, jso = 10, jsoz = 0, dax = 10, eboot = 60, cats = 4;
+    unsigned isoKB = 512, iconKB = 24;
+    bool iconData = false;   // icon body compresses like game data, so reading it decodes blocks
+};
+
+// xorshift: the same fixture for the same arguments
+uint32_t gRng = 0x12345678u;
+uint32_t rnd() { gRng ^= gRng << 13; gRng ^= gRng >> 17; gRng ^= gRng << 5; return gRng; }
+
+void die(const char* what, const std::string& path) {
+    fprintf(stderr, "mkfixture: %s %s: %s\n", what, path.c_str(), strerror(errno));
+    exit(1);
+}
+
+void mkdirs(const std::string& path) {
+    std::string cur;
+    for (size_t i = 0; i <= path.size(); ++i) {
+        if (i == path.size() || path[i] == '/') {
+            if (!cur.empty() && mkdir(cur.c_str(), 0777) != 0 && errno != EEXIST) die("mkdir", cur);
+        }
+        if (i < path.size()) cur += path[i];
+    }
+}
+
+void writeFile(const std::string& path, const std::vector<uint8_t>& data, uint64_t sparseTo = 0) {
+    FILE* f = fopen(path.c_str(), "wb");
+    if (!f) die("open", path);
+    if (!data.empty() && fwrite(data.data(), 1, data.size(), f) != data.size()) die("write", path);
+    fclose(f);
+    if (sparseTo > data.size() && truncate(path.c_str(), (off_t)sparseTo) != 0) die("truncate", path);
+}
+
+void put16(std::vector<uint8_t>& v, size_t off, uint16_t x) { v[off] = (uint8_t)x; v[off+1] = (uint8_t)(x >> 8); }
+void put32(std::vector<uint8_t>& v, size_t off, uint32_t x) { for (int i = 0; i < 4; ++i) v[off+i] = (uint8_t)(x >> (8*i)); }
+void put32be(std::vector<uint8_t>& v, size_t off, uint32_t x) { for (int i = 0; i < 4; ++i) v[off+i] = (uint8_t)(x >> (8*(3-i))); }
+
+// ---------- PARAM.SFO ----------
+std::vector<uint8_t> makeSfo(const std::string& title, const std::string& discId, const char* category) {
+    struct Kv { const char* key; std::string val; uint32_t maxLen; };
+    const Kv kv[3] = { {"CATEGORY", category, 4}, {"DISC_ID", discId, 16}, {"TITLE", title, 128} };
+    std::string keys;
+    uint32_t keyOff[3], dataOff[3], data = 0;
+    for (int i = 0; i < 3; ++i) {
+        keyOff[i] = (uint32_t)keys.size(); keys += kv[i].key; keys += '\0';
+        dataOff[i] = data; data += kv[i].maxLen;
+    }
+    while (keys.size() % 4) keys += '\0';
+    const uint32_t keyTable  = 0x14 + 3 * 16;
+    const uint32_t dataTable = keyTable + (uint32_t)keys.size();
+    std::vector<uint8_t> v(dataTable + data, 0);
+    memcpy(&v[0], "\0PSF", 4);
+    put32(v, 4, 0x00000101);
+    put32(v, 8, keyTable);
+    put32(v, 12, dataTable);
+    put32(v, 16, 3);
+    for (int i = 0; i < 3; ++i) {
+        const size_t e = 0x14 + i * 16;
+        put16(v, e, (uint16_t)keyOff[i]);
+        v[e + 2] = 4; v[e + 3] = 2;   // utf8 string
+        put32(v, e + 4, (uint32_t)kv[i].val.size() + 1);
+        put32(v, e + 8, kv[i].maxLen);
+        put32(v, e + 12, dataOff[i]);
+        memcpy(&v[dataTable + dataOff[i]], kv[i].val.data(), kv[i].val.size());
+    }
+    memcpy(&v[keyTable], keys.data(), keys.size());
+    return v;
+}
+
+// About 50% for deflate, like game data.
+void fillData(uint8_t* p, size_t n) {
+    for (size_t i = 0; i + 4 <= n; i += 4) {
+        const uint32_t w = (rnd() & 0x0F0F0F0Fu) | 0x40404040u;
+        memcpy(p + i, &w, 4);
+    }
+}
+
+// A PNG signature and IHDR, then noise: like real ICON0s, it does not
+// compress (data: it does, for the read benchmarks).
+std::vector<uint8_t> makeIcon(unsigned kb, bool data) {
+    std::vector<uint8_t> v(kb * 1024u < 64 ? 64 : kb * 1024u);
+    static const uint8_t head[16] = {0x89,'P','N','G','\r','\n',0x1A,'\n', 0,0,0,13, 'I','H','D','R'};
+    memcpy(&v[0], head, sizeof(head));
+    put32be(v, 16, 144); put32be(v, 20, 80);
+    if (data) fillData(&v[24], v.size() - 24);
+    else for (size_t i = 24; i < v.size(); ++i) v[i] = (uint8_t)rnd();
+    return v;
+}
+
+// ---------- ISO 9660 ----------
+void dirRecord(std::vector<uint8_t>& img, size_t& pos, const char* name, size_t nameLen,
+               uint32_t lba, uint32_t size, bool dir) {
+    const uint8_t len = (uint8_t)((33 + nameLen + 1) & ~1u);
+    uint8_t* r = &img[pos];
+    r[0] = len;
+    for (int i = 0; i < 4; ++i) { r[2+i] = (uint8_t)(lba >> (8*i));  r[9-i]  = (uint8_t)(lba >> (8*i)); }
+    for (int i = 0; i < 4; ++i) { r[10+i] = (uint8_t)(size >> (8*i)); r[17-i] = (uint8_t)(size >> (8*i)); }
+    r[25] = dir ? 0x02 : 0x00;
+    r[28] = 1; r[31] = 1;   // volume sequence number
+    r[32] = (uint8_t)nameLen;
+    memcpy(r + 33, name, nameLen);
+    pos += len;
+}
+
+// PVD at 16, root at 18, PSP_GAME at 19, PARAM.SFO, ICON0.PNG, then filler
+// that compresses about as well as game data does.
+std::vector<uint8_t> makeIso(const std::string& title, const std::string& discId, const Opts& o) {
+    const std::vector<uint8_t> sfo  = makeSfo(title, discId, "UG");
+    const std::vector<uint8_t> icon = makeIcon(o.iconKB, o.iconData);
+    const uint32_t sfoLba  = 20;
+    const uint32_t iconLba = sfoLba + (uint32_t)((sfo.size() + SECTOR - 1) / SECTOR);
+    const uint32_t endLba  = iconLba + (uint32_t)((icon.size() + SECTOR - 1) / SECTOR);
+    uint32_t sectors = o.isoKB * 1024u / SECTOR;
+    if (sectors < endLba + 1) sectors = endLba + 1;
+    std::vector<uint8_t> img((size_t)sectors * SECTOR, 0);
+
+    uint8_t* pvd = &img[16 * SECTOR];
+    pvd[0] = 1; memcpy(pvd + 1, "CD001", 5); pvd[6] = 1;
+    memcpy(pvd + 40, "UMD_VIDEO_GAME                  ", 32);
+    for (int i = 0; i < 4; ++i) { pvd[80+i] = (uint8_t)(sectors >> (8*i)); pvd[87-i] = (uint8_t)(sectors >> (8*i)); }
+    size_t p = 16 * SECTOR + 156;
+    dirRecord(img, p, "\0", 1, 18, SECTOR, true);
+    uint8_t* term = &img[17 * SECTOR];
+    term[0] = 0xFF; memcpy(term + 1, "CD001", 5); term[6] = 1;
+
+    p = 18 * SECTOR;
+    dirRecord(img, p, "\0", 1, 18, SECTOR, true);
+    dirRecord(img, p, "\1", 1, 18, SECTOR, true);
+    dirRecord(img, p, "PSP_GAME", 8, 19, SECTOR, true);
+    p = 19 * SECTOR;
+    dirRecord(img, p, "\0", 1, 19, SECTOR, true);
+    dirRecord(img, p, "\1", 1, 18, SECTOR, true);
+    dirRecord(img, p, "ICON0.PNG;1", 11, iconLba, (uint32_t)icon.size(), false);
+    dirRecord(img, p, "PARAM.SFO;1", 11, sfoLba, (uint32_t)sfo.size(), false);
+
+    memcpy(&img[(size_t)sfoLba * SECTOR], sfo.data(), sfo.size());
+    memcpy(&img[(size_t)iconLba * SECTOR], icon.data(), icon.size());
+    fillData(&img[(size_t)endLba * SECTOR], img.size() - (size_t)endLba * SECTOR);
+    return img;
+}
+
+// ---------- compressed containers ----------
+enum Codec { C_Deflate, C_Lz4, C_Lzo, C_Zlib };
+
+bool compressBlock(Codec c, const uint8_t* in, uint32_t n, std::vector<uint8_t>& out) {
+    out.resize(n + n / 16 + 1024);
+    if (c == C_Lz4) {
+        const int r = LZ4_compress_default((const char*)in, (char*)out.data(), (int)n, (int)out.size());
+        if (r <= 0) return false;
+        out.resize((size_t)r);
+    } else if (c == C_Lzo) {
+        static std::vector<uint8_t> wrk(LZO1X_1_MEM_COMPRESS);
+        lzo_uint len = out.size();
+        if (lzo1x_1_compress(in, n, out.data(), &len, wrk.data()) != LZO_E_OK) return false;
+        out.resize(len);
+    } else {
+        z_stream z; memset(&z, 0, sizeof(z));
+        if (deflateInit2(&z, 9, Z_DEFLATED, c == C_Deflate ? -15 : 15, 8, Z_DEFAULT_STRATEGY) != Z_OK) return false;
+        z.next_in = (Bytef*)in; z.avail_in = n;
+        z.next_out = out.data(); z.avail_out = (uInt)out.size();
+        const int r = deflate(&z, Z_FINISH);
+        out.resize(z.total_out);
+        deflateEnd(&z);
+        if (r != Z_STREAM_END) return false;
+    }
+    return out.size() < n;
+}
+
+// Blocks of bs bytes after a header of hdrSize, index of n+1 u32 offsets.
+// pick(i) gives block i's codec; the MSB of an entry marks a stored block
+// (msbIsCodec: CSO v2, where it means LZ4 and a full-size block is stored).
+template <class Pick>
+std::vector<uint8_t> blockContainer(const std::vector<uint8_t>& iso, std::vector<uint8_t> hdr, uint32_t bs,
+                                    Pick pick, bool msbIsCodec) {
+    const uint32_t n = (uint32_t)((iso.size() + bs - 1) / bs);
+    const size_t indexOff = hdr.size();
+    std::vector<uint8_t> out = hdr;
+    out.resize(indexOff + (size_t)(n + 1) * 4, 0);
+    std::vector<uint8_t> comp, blk(bs);
+    for (uint32_t i = 0; i < n; ++i) {
+        const size_t off = (size_t)i * bs;
+        const size_t len = std::min<size_t>(bs, iso.size() - off);
+        memset(blk.data(), 0, bs);
+        memcpy(blk.data(), &iso[off], len);
+        const Codec c = pick(i);
+        uint32_t entry = (uint32_t)out.size();
+        if (compressBlock(c, blk.data(), bs, comp)) {
+            if (msbIsCodec && c == C_Lz4) entry |= 0x80000000u;
+            out.insert(out.end(), comp.begin(), comp.end());
+        } else {
+            if (!msbIsCodec) entry |= 0x80000000u;
+            out.insert(out.end(), blk.begin(), blk.end());
+        }
+        put32(out, indexOff + (size_t)i * 4, entry);
+    }
+    put32(out, indexOff + (size_t)n * 4, (uint32_t)out.size());
+    return out;
+}
+
+std::vector<uint8_t> cisoHeader(const char* magic, uint64_t total, uint32_t bs, uint8_t version) {
+    std::vector<uint8_t> h(0x18, 0);
+    memcpy(&h[0], magic, 4);
+    put32(h, 4, 0x18);
+    put32(h, 8, (uint32_t)total); put32(h, 12, (uint32_t)(total >> 32));
+    put32(h, 16, bs);
+    h[20] = version;
+    return h;
+}
+
+std::vector<uint8_t> makeCso(const std::vector<uint8_t>& iso) {
+    return blockContainer(iso, cisoHeader("CISO", iso.size(), SECTOR, 1), SECTOR,
+                          [](uint32_t){ return C_Deflate; }, false);
+}
+std::vector<uint8_t> makeCso2(const std::vector<uint8_t>& iso) {   // deflate and LZ4 blocks mixed
+    return blockContainer(iso, cisoHeader("CISO", iso.size(), SECTOR, 2), SECTOR,
+                          [](uint32_t i){ return (i & 1) ? C_Lz4 : C_Deflate; }, true);
+}
+std::vector<uint8_t> makeZso(const std::vector<uint8_t>& iso) {
+    return blockContainer(iso, cisoHeader("ZISO", iso.size(), SECTOR, 1), SECTOR,
+                          [](uint32_t){ return C_Lz4; }, false);
+}
+std::vector<uint8_t> jsoContainer(const std::vector<uint8_t>& iso, Codec c) {
+    std::vector<uint8_t> h(0x30, 0);
+    memcpy(&h[0], "JISO", 4);
+    h[4] = 3; h[5] = 1;
+    put16(h, 6, (uint16_t)SECTOR);
+    h[10] = (c == C_Zlib) ? 1 : 0;      // 0 LZO, 1 zlib
+    put32(h, 12, (uint32_t)iso.size());
+    put32(h, 0x20, 0x30);               // header size: the index follows
+    return blockContainer(iso, h, SECTOR, [c](uint32_t){ return c; }, false);
+}
+std::vector<uint8_t> makeJso(const std::vector<uint8_t>& iso)  { return jsoContainer(iso, C_Lzo); }
+std::vector<uint8_t> makeJsoz(const std::vector<uint8_t>& iso) { return jsoContainer(iso, C_Zlib); }
+std::vector<uint8_t> makeDax(const std::vector<uint8_t>& iso) {
+    std::vector<uint8_t> h(0x20, 0);
+    memcpy(&h[0], "DAX\0", 4);
+    put32(h, 4, (uint32_t)iso.size());
+    put32(h, 8, 1);
+    return blockContainer(iso, h, 8192, [](uint32_t){ return C_Zlib; }, false);
+}
+
+// ---------- EBOOT.PBP ----------
+std::vector<uint8_t> makePbp(const std::string& title, const std::string& discId, const Opts& o) {
+    const std::vector<uint8_t> sfo  = makeSfo(title, discId, "MG");
+    const std::vector<uint8_t> icon = makeIcon(o.iconKB, o.iconData);
+    std::vector<uint8_t> v(0x28, 0);
+    memcpy(&v[0], "\0PBP", 4);
+    put32(v, 4, 0x00010000);
+    const uint32_t sfoOff = 0x28, iconOff = sfoOff + (uint32_t)sfo.size();
+    const uint32_t end = iconOff + (uint32_t)icon.size();
+    put32(v, 8, sfoOff);
+    put32(v, 12, iconOff);
+    for (int i = 2; i < 8; ++i) put32(v, 8 + i * 4, end);
+    v.insert(v.end(), sfo.begin(), sfo.end());
+    v.insert(v.end(), icon.begin(), icon.end());
+    return v;
+}
+
+// ---------- layouts ----------
+void makeCard(const std::string& root, const Opts& o) {
+    const char* isoDirs[]  = {"ISO", "ISO/PSP"};
+    const char* gameDirs[] = {"PSP/GAME", "PSP/GAME/PSX", "PSP/GAME/Utility", "PSP/GAME150"};
+    for (auto d : isoDirs)  mkdirs(root + "/" + d);
+    for (auto d : gameDirs) mkdirs(root + "/" + d);
+    for (int c = 0; c < o.cats; ++c) {
+        char name[32]; snprintf(name, sizeof(name), "CAT_%02d Bench", c + 1);
+        mkdirs(root + "/ISO/" + name);
+        mkdirs(root + "/PSP/GAME/" + name);
+    }
+    // Every third item goes into a category, the rest stays uncategorized.
+    auto dirFor = [&](const char* base, unsigned i) {
+        std::string d = root + "/" + base;
+        if (o.cats && i % 3 == 0) { char c[32]; snprintf(c, sizeof(c), "/CAT_%02d Bench", (int)(i / 3 % o.cats) + 1); d += c; }
+        return d;
+    };
+
+    struct Kind { const char* ext; int count; std::vector<uint8_t> (*wrap)(const std::vector<uint8_t>&); };
+    const Kind kinds[] = {
+        {"iso", o.iso, nullptr}, {"cso", o.cso, makeCso}, {"cso", o.cso2, makeCso2},
+        {"zso", o.zso, makeZso}, {"jso", o.jso, makeJso},
+        {"jso", o.jsoz, makeJsoz}, {"dax", o.dax, makeDax},
+    };
+    unsigned serial = 0;
+    for (const Kind& k : kinds) {
+        for (int i = 0; i < k.count; ++i, ++serial) {
+            char title[64], id[16], file[64];
+            snprintf(title, sizeof(title), "Bench Disc %04u (%s)", serial, k.ext);
+            snprintf(id, sizeof(id), "ULUS%05u", serial);
+            snprintf(file, sizeof(file), "/Bench_%04u.%s", serial, k.ext);
+            const std::vector<uint8_t> iso = makeIso(title, id, o);
+            writeFile(dirFor("ISO", serial) + file, k.wrap ? k.wrap(iso) : iso);
+        }
+    }
+    for (int i = 0; i < o.eboot; ++i) {
+        char title[64], id[16], folder[32];
+        snprintf(title, sizeof(title), "Bench Homebrew %04d", i);
+        snprintf(id, sizeof(id), "NPUH%05d", i);
+        snprintf(folder, sizeof(folder), "/HB%04d", i);
+        const std::string dir = dirFor("PSP/GAME", (unsigned)i) + folder;
+        mkdirs(dir);
+        writeFile(dir + "/EBOOT.PBP", makePbp(title, id, o), 2u << 20);
+        if (i % 4 == 3) {   // saves/data subfolders: sized by the size walk
+            for (int s = 0; s < 3; ++s) {
+                char sub[32]; snprintf(sub, sizeof(sub), "/DATA%d", s);
+                mkdirs(dir + sub);
+                for (int f = 0; f < 5; ++f) {
+                    char fn[32]; snprintf(fn, sizeof(fn), "/file%d.bin", f);
+                    writeFile(dir + sub + fn, std::vector<uint8_t>(), 64u << 10);
+                }
+            }
+        }
+    }
+}
+
+void makeDeep(const std::string& dir, int depth, int fanout, int files) {
+    mkdirs(dir);
+    for (int f = 0; f < files; ++f) {
+        char fn[32]; snprintf(fn, sizeof(fn), "/f%02d.dat", f);
+        writeFile(dir + fn, std::vector<uint8_t>(512, (uint8_t)f));
+    }
+    if (depth == 0) return;
+    for (int s = 0; s < fanout; ++s) {
+        char sub[32]; snprintf(sub, sizeof(sub), "/d%02d", s);
+        makeDeep(dir + sub, depth - 1, fanout, files);
+    }
+}
+
+int usage() {
+    fprintf(stderr,
+        "usage: mkfixture card <dir> [--iso N] [--cso N] [--cso2 N] [--zso N] [--jso N] [--jsoz N]\n"
+        "                            [--dax N] [--eboot N] [--cats N] [--iso-kb K] [--icon-kb K]\n"
+        "                            [--icon-fill noise|data]\n"
+        "       mkfixture deep <dir> <depth> <fanout> <files>\n");
+    return 2;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if (argc < 3) return usage();
+    const std::string mode = argv[1];
+    if (lzo_init() != LZO_E_OK) return 1;
+    if (mode == "deep") {
+        if (argc != 6) return usage();
+        makeDeep(argv[2], atoi(argv[3]), atoi(argv[4]), atoi(argv[5]));
+        return 0;
+    }
+    if (mode != "card") return usage();
+    Opts o;
+    for (int i = 3; i + 1 < argc; i += 2) {
+        const std::string k = argv[i];
+        const int v = atoi(argv[i + 1]);
+        if (k == "--icon-fill") { o.iconData = !strcmp(argv[i + 1], "data"); continue; }
+        if      (k == "--iso")     o.iso = v;
+        else if (k == "--cso")     o.cso = v;
+        else if (k == "--cso2")    o.cso2 = v;
+        else if (k == "--zso")     o.zso = v;
+        else if (k == "--jso")     o.jso = v;
+        else if (k == "--jsoz")    o.jsoz = v;
+        else if (k == "--dax")     o.dax = v;
+        else if (k == "--eboot")   o.eboot = v;
+        else if (k == "--cats")    o.cats = v;
+        else if (k == "--iso-kb")  o.isoKB = (unsigned)v;
+        else if (k == "--icon-kb") o.iconKB = (unsigned)v;
+        else return usage();
+    }
+    makeCard(argv[2], o);
+    return 0;
+}
@@ -0,0 +1,221 @@
+// scan_bench.cpp
+// Device scan on the host, against a mkfixture tree mounted as ms0:.
+//
+//   scan_bench <fixture-dir> [runs]
+//   scan_bench --workers <fixture-dir> [latency-us]
+//
+// Each run is a cold start (no KFE_catalog.bin: the scan lists every item
+// under its name, then every deferred title is read from its image or
+// EBOOT.PBP) then a warm one served from the catalog the cold pass saved,
+// each in a fresh KernelFileExplorer like a relaunch. Per pass it prints
+// wall time, the catalog hits and misses, and the syscalls that reached
+// the (host) filesystem ("title opens" leaves out the app's own KFE_*
+// files), then the SCAN_PROFILE phases and the app's own I/O counters.
+// After the runs, "layout" prints the heap each listed item costs as a
+// GameItem record plus its share of the StringPool, against the record it
+// replaced (four std::strings and a ScePspDateTime, rebuilt from the same
+// items).
+//
+// --workers: cold scans plus titles with 1, 2 and 4 title workers on one
+// CPU, with every open and read waiting latency-us (default 500) like a
+// memory stick, so the table shows what overlapping decode with I/O buys
+// on a PSP. Items per second per worker count, best of three.
+//
+// main.cpp is compiled into this file (its main() renamed) so the bench
+// runs the app's own code; HostBench is a friend of KernelFileExplorer.
+
+#define main kfe_main
+#include "../main.cpp"
+#undef main
+
+struct HostBench {
+    static unsigned countItems(const KernelFileExplorer& app) {
+        unsigned n = (unsigned)app.uncategorized.size();
+        for (const auto& kv : app.categories) n += (unsigned)kv.second.size();
+        return n;
+    }
+    static unsigned countPending(const KernelFileExplorer& app) {
+        unsigned n = 0;
+        for (const GameItem& gi : app.arena) n += gi.titlePending ? 1 : 0;
+        return n;
+    }
+
+    static void begin() {
+        gIoCalls = IoCallStats{0, 0, 0, 0};
+        memset(&gScanPhases, 0, sizeof(gScanPhases));
+        pspHostResetIo();
+    }
+    // One line of host syscalls for the pass just timed, then its phases.
+    static unsigned print(const char* name, unsigned long long us, unsigned items, KernelFileExplorer& app) {
+        const PspHostIoStats& h = gPspHostIo;
+        const unsigned opens = h.open - h.openApp;
+        printf("%-6s %8.2f ms %5u item(s) | catalog hit %-4u miss %-4u | title opens %-4u read %-5u seek %-5u"
+               " %6llu KB | dopen %-4u dread %-5u getstat %-4u\n",
+               name, us / 1000.0, items, app.catalogFor("ms0:/").hits(), app.catalogFor("ms0:/").misses(),
+               opens, h.read, h.seek, h.readBytes / 1024ULL, h.dopen, h.dread, h.getstat);
+        const ScanPhaseStats& s = gScanPhases;
+        printf("       readdir %7.2f ms/%-5u stat %6.2f ms/%-4u title %7.2f ms/%-4u size %6.2f ms/%-3u"
+               " | app dopen %-4u dread %-5u getstat %-4u open %-4u\n",
+               s.us[SP_Readdir] / 1000.0, s.n[SP_Readdir], s.us[SP_Stat] / 1000.0, s.n[SP_Stat],
+               s.us[SP_Title] / 1000.0, s.n[SP_Title], s.us[SP_SizeWalk] / 1000.0, s.n[SP_SizeWalk],
+               gIoCalls.dopen, gIoCalls.dread, gIoCalls.getstat, gIoCalls.open);
+        return opens;
+    }
+
+    // Every deferred title, through the TitleFiller the way pumpTitles()
+    // feeds it: inline without workers, else queued and collected.
+    static void fillTitles(KernelFileExplorer& app) {
+        for (const GameItem& gi : app.arena) if (gi.titlePending) app.titles.request(gi, false);
+        std::vector<GameItem> batch;
+        while (!app.titles.idle()) {
+            app.titles.takeDone(batch);
+            for (auto& r : batch) app.applyTitle(r);
+            if (batch.empty()) sceKernelDelayThread(200);
+        }
+    }
+
+    // Cold start: the scan, then its deferred titles (the catalog saved
+    // after them, like the fill does). Returns the pass's title opens.
+    static unsigned cold() {
+        sceIoRemove("ms0:/KFE_catalog.bin");
+        FolderSizeTrim(nullptr);   // a relaunch starts with an empty size cache
+        KernelFileExplorer app;
+        app.titles.owner = &app;   // resolve inline, no worker thread
+        begin();
+        unsigned long long t0 = nowUS();
+        app.scanDevice("ms0:/");
+        const unsigned long long scanUs = nowUS() - t0;
+        unsigned opens = print("cold", scanUs, countItems(app), app);
+
+        const unsigned deferred = countPending(app);
+        begin();
+        t0 = nowUS();
+        fillTitles(app);
+        for (auto& c : app.catalogs) c.save();
+        const unsigned long long titleUs = nowUS() - t0;
+        opens += print("titles", titleUs, deferred, app);
+        printf("cold total %.2f ms, %u title opens\n", (scanUs + titleUs) / 1000.0, opens);
+        return opens;
+    }
+
+    static unsigned warm() {
+        FolderSizeTrim(nullptr);
+        KernelFileExplorer app;
+        app.titles.owner = &app;
+        begin();
+        const unsigned long long t0 = nowUS();
+        app.scanDevice("ms0:/");
+        const unsigned opens = print("warm", nowUS() - t0, countItems(app), app);
+        const unsigned missed = countPending(app);
+        if (missed) printf("warning: %u catalog miss(es) on the warm scan\n", missed);
+        return opens;
+    }
+
+    // The workers are never stopped (the app keeps its TitleFiller for the
+    // session): each config's threads stay blocked on their own semaphore.
+    static void workers(unsigned latencyUs) {
+        pspHostOneCpu();
+        pspHostSetLatency(latencyUs);
+        printf("title workers, one CPU, %u us per open/read: cold scan + titles\n", latencyUs);
+        printf("%8s %10s %10s %8s\n", "workers", "ms", "items/s", "speedup");
+        double base = 0;
+        for (int n : {1, 2, 4}) {
+            gTitleWorkers = n;
+            unsigned long long best = ~0ULL;
+            unsigned items = 0;
+            for (int r = 0; r < 3; ++r) {
+                sceIoRemove("ms0:/KFE_catalog.bin");
+                FolderSizeTrim(nullptr);
+                KernelFileExplorer* app = new KernelFileExplorer;
+                app->titles.start(app);
+                const unsigned long long t0 = nowUS();
+                app->scanDevice("ms0:/");
+                fillTitles(*app);
+                best = std::min(best, nowUS() - t0);
+                items = countItems(*app);
+                if (countPending(*app)) printf("warning: titles left pending\n");
+                // leaked: its workers hold a pointer to app->titles
+            }
+            const double rate = items * 1e6 / (double)best;
+            if (!base) base = rate;
+            printf("%8d %10.1f %10.0f %7.2fx\n", n, best / 1000.0, rate, rate / base);
+        }
+        pspHostSetLatency(0);
+    }
+
+    // The GameItem before the StringPool.
+    struct OldGameItem {
+        GameItem::Kind kind;
+        std::string    label, title, path;
+        ScePspDateTime time;
+        std::string    sortKey;
+        uint64_t       sizeBytes;
+    };
+    static std::string oldSortKey(const ScePspDateTime& dt) {
+        char buf[64];
+        snprintf(buf, sizeof(buf), "%04u%02u%02u%02u%02u%02u%06u", (unsigned)dt.year, (unsigned)dt.month,
+                 (unsigned)dt.day, (unsigned)dt.hour, (unsigned)dt.minute, (unsigned)dt.second,
+                 (unsigned)dt.microsecond);
+        return buf;
+    }
+    static size_t heapInUse() { return (size_t)mallinfo().uordblks; }
+
+    static void layout() {
+        KernelFileExplorer app;
+        app.titles.owner = &app;
+        app.scanDevice("ms0:/");
+        std::vector<const GameItem*> all;
+        for (const GameItem& gi : app.arena) all.push_back(&gi);
+        const size_t n = all.size();
+        if (!n) return;
+
+        size_t h0 = heapInUse();
+        std::vector<OldGameItem> olds;
+        olds.reserve(n);
+        for (const GameItem* gi : all)
+            olds.push_back(OldGameItem{gi->kind, gi->label(), gi->title(), gi->path(), gi->time(),
+                                       oldSortKey(gi->time()), gi->sizeBytes});
+        const size_t oldBytes = heapInUse() - h0;
+
+        h0 = heapInUse();
+        std::vector<GameItem> news;
+        news.reserve(n);
+        for (const GameItem* gi : all) news.push_back(*gi);
+        const size_t recBytes = heapInUse() - h0;
+        const size_t poolBytes = gStrings.bytes();
+
+        printf("layout %u item(s): old %u B/item (record %u B + 4 strings) | new %u B/item (record %u B,"
+               " pool %u B/item: %u strings in %u KB)\n",
+               (unsigned)n, (unsigned)(oldBytes / n), (unsigned)sizeof(OldGameItem),
+               (unsigned)((recBytes + poolBytes) / n), (unsigned)sizeof(GameItem), (unsigned)(poolBytes / n),
+               gStrings.count(), (unsigned)(poolBytes / 1024));
+    }
+
+    static void run(int pass) {
+        printf("-- run %d\n", pass);
+        const unsigned c = cold();
+        const unsigned w = warm();
+        printf("title opens: cold %u, warm %u\n", c, w);
+    }
+};
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        fprintf(stderr, "usage: scan_bench <fixture-dir> [runs]\n"
+                        "       scan_bench --workers <fixture-dir> [latency-us]\n");
+        return 2;
+    }
+    if (!strcmp(argv[1], "--workers")) {
+        if (argc < 3) return 2;
+        pspHostMount("ms0:", argv[2]);
+        hbInit((size_t)APP_HEAP_KB * 1024);
+        HostBench::workers(argc > 3 ? (unsigned)atoi(argv[3]) : 500);
+        return 0;
+    }
+    const int runs = (argc > 2) ? atoi(argv[2]) : 1;
+    pspHostMount("ms0:", argv[1]);
+    hbInit((size_t)APP_HEAP_KB * 1024);
+    for (int i = 1; i <= runs; ++i) HostBench::run(i);
+    HostBench::layout();
+    return 0;
+}
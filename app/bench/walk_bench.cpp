@@ -0,0 +1,255 @@
+// walk_bench.cpp
+// Heap allocations and time of the recursive walkers on a deep tree.
+//
+//   walk_bench <fixture-dir> [reps]
+//
+// <fixture-dir>/deep must be a "mkfixture deep" tree; it is mounted as ms0:.
+// Each walker runs in two versions: the app's (paths pushed and popped on
+// a PathBuf) and the one it replaced (a joinDirFile string per entry and
+// the caching io* wrappers), kept below with the app's current control
+// flow so that only the path handling differs. Allocations are operator
+// new calls made during the walk; time is the best of reps runs. The
+// mutating walks (move, copy, remove) work on their own copy of the tree.
+// Exits with 1 if an app walker allocates per entry (more than
+// MAX_ALLOCS_PER_WALK in one walk, whatever the tree size).
+
+#include <new>
+
+#define main kfe_main
+#include "../main.cpp"
+#undef main
+
+// ---------- allocation counter ----------
+static unsigned long long gNews = 0, gNewBytes = 0;
+
+static void* countedNew(size_t n) {
+    __atomic_add_fetch(&gNews, 1, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&gNewBytes, n, __ATOMIC_RELAXED);
+    void* p = malloc(n ? n : 1);
+    if (!p) abort();
+    return p;
+}
+void* operator new(size_t n)                 { return countedNew(n); }
+void* operator new[](size_t n)               { return countedNew(n); }
+void  operator delete(void* p) noexcept      { free(p); }
+void  operator delete[](void* p) noexcept    { free(p); }
+void  operator delete(void* p, size_t) noexcept   { free(p); }
+void  operator delete[](void* p, size_t) noexcept { free(p); }
+
+// a few one-off std::strings per walk (the wrappers' logs and cache keys)
+static const unsigned long long MAX_ALLOCS_PER_WALK = 16;
+
+struct HostBench {
+    // ---------- the walkers before PathBuf ----------
+    struct Before {
+        static bool sumDirBytes(const std::string& dir, uint64_t& out) {
+            SceUID d = scanOpenDir(dir.c_str()); if (d < 0) return false;
+            SceIoDirent ent; memset(&ent, 0, sizeof(ent));
+            while (scanReadDir(d, &ent) > 0) {
+                if (!strcmp(ent.d_name,".") || !strcmp(ent.d_name,"..")) { memset(&ent,0,sizeof(ent)); continue; }
+                std::string p = joinDirFile(dir, ent.d_name);
+                if (FIO_S_ISDIR(ent.d_stat.st_mode)) { if (!sumDirBytes(p, out)) { pspIoCloseDir(d); return false; } }
+                else out += (uint64_t)ent.d_stat.st_size;
+                memset(&ent, 0, sizeof(ent));
+            }
+            pspIoCloseDir(d);
+            return true;
+        }
+
+        // (without the copy fallback for a refused rename: it never runs here)
+        static bool fastMoveDirByRenames(const std::string& srcDir, const std::string& dstDir) {
+            logf("fastMoveDirByRenames: %s -> %s", srcDir.c_str(), dstDir.c_str());
+            if (!ensureDirRecursive(dstDir)) { logf("  ensureDirRecursive(dst) FAILED"); return false; }
+
+            SceUID d = pspIoOpenDir(srcDir.c_str());
+            if (d < 0) { logf("  open src failed %d", d); return false; }
+
+            bool ok = true;
+            SceIoDirent ent; memset(&ent, 0, sizeof(ent));
+            while (ok && pspIoReadDir(d, &ent) > 0) {
+                if (!strcmp(ent.d_name, ".") || !strcmp(ent.d_name, "..")) { memset(&ent,0,sizeof(ent)); continue; }
+                std::string s = joinDirFile(srcDir, ent.d_name);
+                std::string t = joinDirFile(dstDir, ent.d_name);
+
+                if (FIO_S_ISDIR(ent.d_stat.st_mode)) {
+                    ok = fastMoveDirByRenames(s, t);
+                    if (ok) ioRmdir(s.c_str());
+                } else {
+                    if (pathExists(t)) ioRemove(t.c_str());
+                    ok = ioRename(s.c_str(), t.c_str()) >= 0;
+                }
+                memset(&ent, 0, sizeof(ent));
+                sceKernelDelayThread(0);
+            }
+            pspIoCloseDir(d);
+            logf("fastMoveDirByRenames: %s", ok ? "OK" : "FAIL");
+            return ok;
+        }
+
+        static bool removeDirRecursive(const std::string& dir) {
+            SceUID d = pspIoOpenDir(dir.c_str());
+            if (d < 0) { logf("removeDirRecursive: open %s failed %d", dir.c_str(), d); return false; }
+            SceIoDirent ent; memset(&ent, 0, sizeof(ent));
+            while (pspIoReadDir(d, &ent) > 0) {
+                if (!strcmp(ent.d_name, ".") || !strcmp(ent.d_name, "..")) { memset(&ent,0,sizeof(ent)); continue; }
+                std::string child = joinDirFile(dir, ent.d_name);
+                if (FIO_S_ISDIR(ent.d_stat.st_mode)) removeDirRecursive(child);
+                else ioRemove(child.c_str());
+                memset(&ent, 0, sizeof(ent));
+                sceKernelDelayThread(0);
+            }
+            pspIoCloseDir(d);
+            return ioRmdir(dir.c_str()) >= 0;
+        }
+
+        static bool copyDirRecursive(const std::string& src, const std::string& dst, KernelFileExplorer* self) {
+            logf("copyDirRecursive: %s -> %s", src.c_str(), dst.c_str());
+            if (!KernelFileExplorer::ensureDirRecursive(dst)) { logf("  ensureDirRecursive failed"); return false; }
+            SceUID d = pspIoOpenDir(src.c_str());
+            if (d < 0) { logf("  open src failed %d", d); return false; }
+
+            SceIoDirent ent; memset(&ent, 0, sizeof(ent));
+            bool ok = true;
+            while (ok && pspIoReadDir(d, &ent) > 0) {
+                if (!strcmp(ent.d_name, ".") || !strcmp(ent.d_name, "..")) { memset(&ent,0,sizeof(ent)); continue; }
+                std::string s = joinDirFile(src, ent.d_name);
+                std::string t = joinDirFile(dst, ent.d_name);
+
+                if (FIO_S_ISDIR(ent.d_stat.st_mode)) {
+                    ok = KernelFileExplorer::ensureDir(t) && copyDirRecursive(s, t, self);
+                } else {
+                    logf("  file: %s -> %s (%ld bytes)", s.c_str(), t.c_str(), (long)ent.d_stat.st_size);
+                    ok = KernelFileExplorer::copyFile(s, t, self);
+                }
+                memset(&ent, 0, sizeof(ent));
+                sceKernelDelayThread(0);
+            }
+            pspIoCloseDir(d);
+            logf("copyDirRecursive: %s", ok ? "OK" : "FAIL");
+            return ok;
+        }
+
+        static bool removeDirRecursiveProgress(const std::string& dir) {
+            SceUID d = pspIoOpenDir(dir.c_str());
+            if (d < 0) return ioRmdir(dir.c_str()) >= 0;
+            bool ok = true;
+            SceIoDirent ent; memset(&ent, 0, sizeof(ent));
+            while (ok && pspIoReadDir(d, &ent) > 0) {
+                if (!strcmp(ent.d_name, ".") || !strcmp(ent.d_name, "..")) { memset(&ent, 0, sizeof(ent)); continue; }
+                std::string child = joinDirFile(dir, ent.d_name);
+                if (FIO_S_ISDIR(ent.d_stat.st_mode)) ok = removeDirRecursiveProgress(child);
+                else ok = (ioRemove(child.c_str()) >= 0);
+                memset(&ent, 0, sizeof(ent));
+                sceKernelDelayThread(0);
+            }
+            pspIoCloseDir(d);
+            if (ok) ok = (ioRmdir(dir.c_str()) >= 0);
+            return ok;
+        }
+    };
+
+    // ---------- measuring ----------
+    struct Result { double ms; unsigned long long news, bytes; bool ok; };
+    template <class Prep, class Op>
+    static Result measure(int reps, Prep prep, Op op) {
+        Result best{1e30, 0, 0, true};
+        for (int i = 0; i < reps; ++i) {
+            prep();
+            const unsigned long long n0 = gNews, b0 = gNewBytes;
+            const unsigned long long t0 = nowUS();
+            const bool ok = op();
+            const double ms = (nowUS() - t0) / 1000.0;
+            if (ms < best.ms) best.ms = ms;
+            best.news = gNews - n0; best.bytes = gNewBytes - b0;
+            best.ok = best.ok && ok;
+        }
+        return best;
+    }
+
+    static bool gOver;
+    static void row(const char* name, unsigned entries, const Result& before, const Result& after) {
+        if (after.news > MAX_ALLOCS_PER_WALK) {
+            printf("walk_bench: %s allocates %llu times over %u entries (limit %llu per walk)\n",
+                   name, after.news, entries, MAX_ALLOCS_PER_WALK);
+            gOver = true;
+        }
+        printf("%-22s %8.2f ms %8llu alloc %6.2f/entry %9llu KB | %8.2f ms %8llu alloc %6.2f/entry %9llu KB%s\n",
+               name, before.ms, before.news, (double)before.news / entries, before.bytes / 1024ULL,
+               after.ms, after.news, (double)after.news / entries, after.bytes / 1024ULL,
+               (before.ok && after.ok) ? "" : "  [FAILED]");
+    }
+
+    static unsigned countEntries(const std::string& dir) {
+        unsigned n = 0;
+        SceUID d = sceIoDopen(dir.c_str());
+        if (d < 0) return 0;
+        SceIoDirent ent; memset(&ent, 0, sizeof(ent));
+        while (sceIoDread(d, &ent) > 0) {
+            if (strcmp(ent.d_name, ".") && strcmp(ent.d_name, "..")) {
+                ++n;
+                if (FIO_S_ISDIR(ent.d_stat.st_mode)) n += countEntries(dir + "/" + ent.d_name);
+            }
+            memset(&ent, 0, sizeof(ent));
+        }
+        sceIoDclose(d);
+        return n;
+    }
+
+    static bool run(int reps) {
+        const std::string tree = "ms0:/deep", work = "ms0:/walk", moved = "ms0:/walk_moved", copy = "ms0:/walk_copy";
+        const unsigned entries = countEntries(tree);
+        if (!entries) { fprintf(stderr, "walk_bench: no tree at %s\n", tree.c_str()); exit(1); }
+        printf("%u entries; before (joinDirFile per entry) | after (PathBuf)\n", entries);
+
+        // scratch copies with the app's own walkers; not measured
+        auto fresh = [&](const std::string& p) {
+            if (pathExists(p)) KernelFileExplorer::removeDirRecursive(p);
+            KernelFileExplorer::copyDirRecursive(tree, p, nullptr);
+        };
+        auto gone  = [&](const std::string& p) { if (pathExists(p)) KernelFileExplorer::removeDirRecursive(p); };
+        auto none  = []{};
+        gDirCache.clear();
+
+        uint64_t b0 = 0, b1 = 0;
+        const Result sb = measure(reps, none, [&]{ b0 = 0; return Before::sumDirBytes(tree, b0); });
+        const Result sa = measure(reps, none, [&]{ b1 = 0; return sumDirBytes(tree, b1); });
+        row("sumDirBytes", entries, sb, sa);
+        if (b0 != b1) printf("  sizes differ: %llu vs %llu\n", (unsigned long long)b0, (unsigned long long)b1);
+
+        fresh(work);
+        const Result mb = measure(reps, [&]{ gone(moved); },
+            [&]{ return Before::fastMoveDirByRenames(work, moved) && ioRmdir(work.c_str()) >= 0
+                     && ioRename(moved.c_str(), work.c_str()) >= 0; });
+        const Result ma = measure(reps, [&]{ gone(moved); },
+            [&]{ return fastMoveDirByRenames(work, moved) && ioRmdir(work.c_str()) >= 0
+                     && ioRename(moved.c_str(), work.c_str()) >= 0; });
+        row("fastMoveDirByRenames", entries, mb, ma);
+        gone(work);
+
+        const Result cb = measure(reps, [&]{ gone(copy); }, [&]{ return Before::copyDirRecursive(tree, copy, nullptr); });
+        const Result ca = measure(reps, [&]{ gone(copy); }, [&]{ return KernelFileExplorer::copyDirRecursive(tree, copy, nullptr); });
+        row("copyDirRecursive", entries, cb, ca);
+
+        const Result rb = measure(reps, [&]{ fresh(copy); }, [&]{ return Before::removeDirRecursive(copy); });
+        const Result ra = measure(reps, [&]{ fresh(copy); }, [&]{ return KernelFileExplorer::removeDirRecursive(copy); });
+        row("removeDirRecursive", entries, rb, ra);
+
+        const Result pb = measure(reps, [&]{ fresh(copy); }, [&]{ return Before::removeDirRecursiveProgress(copy); });
+        const Result pa = measure(reps, [&]{ fresh(copy); },
+                                  [&]{ return KernelFileExplorer::removeDirRecursiveProgress(copy, nullptr); });
+        row("removeDirRecursiveProg", entries, pb, pa);
+        gone(copy);
+        return !gOver;
+    }
+};
+bool HostBench::gOver = false;
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        fprintf(stderr, "usage: walk_bench <fixture-dir> [reps]\n");
+        return 2;
+    }
+    pspHostMount("ms0:", argv[1]);
+    hbInit((size_t)APP_HEAP_KB * 1024);
+    return HostBench::run(argc > 2 ? atoi(argv[2]) : 3) ? 0 : 1;
+}
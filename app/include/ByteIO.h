@@ -0,0 +1,23 @@
+#pragma once
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+// Little-endian (de)serialization helpers for the app's small binary files
+// (catalog, session snapshot).
+static inline void putU8 (std::vector<uint8_t>& b, uint8_t v)  { b.push_back(v); }
+static inline void putU16(std::vector<uint8_t>& b, uint16_t v) { b.push_back((uint8_t)v); b.push_back((uint8_t)(v >> 8)); }
+static inline void putU32(std::vector<uint8_t>& b, uint32_t v) { for (int i = 0; i < 4; ++i) b.push_back((uint8_t)(v >> (8*i))); }
+static inline void putU64(std::vector<uint8_t>& b, uint64_t v) { for (int i = 0; i < 8; ++i) b.push_back((uint8_t)(v >> (8*i))); }
+static inline void putStr(std::vector<uint8_t>& b, const std::string& s) { b.insert(b.end(), s.begin(), s.end()); }
+
+struct Reader {
+    const uint8_t* p; size_t n; size_t off; bool ok;
+    Reader(const uint8_t* p_, size_t n_) : p(p_), n(n_), off(0), ok(true) {}
+    bool need(size_t k) { if (!ok || off + k > n) ok = false; return ok; }
+    uint8_t  u8 ()  { if (!need(1)) return 0; return p[off++]; }
+    uint16_t u16()  { if (!need(2)) return 0; uint16_t v = (uint16_t)(p[off] | (p[off+1] << 8)); off += 2; return v; }
+    uint32_t u32()  { if (!need(4)) return 0; uint32_t v = 0; for (int i = 0; i < 4; ++i) v |= (uint32_t)p[off+i] << (8*i); off += 4; return v; }
+    uint64_t u64()  { if (!need(8)) return 0; uint64_t v = 0; for (int i = 0; i < 8; ++i) v |= (uint64_t)p[off+i] << (8*i); off += 8; return v; }
+    void str(std::string& s, size_t k) { if (!need(k)) return; s.assign((const char*)p + off, k); off += k; }
+};
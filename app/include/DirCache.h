@@ -0,0 +1,63 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <deque>
+#include <unordered_map>
+#include <pspkerneltypes.h>
+#include <pspiofilemgr.h>
+#include "HeapBudget.h"
+
+// One directory entry as read from disk (name keeps its on-disk case).
+struct DirCacheEntry {
+    std::string name;
+    SceIoStat   st;
+};
+
+// Session cache of directory listings for existence checks and
+// case-insensitive lookups. Listings are keyed by lowercase path (no
+// trailing '/') and hold a lowercase-name → entry table, so a lookup in a
+// cached directory costs no I/O. Missing directories are cached too.
+//
+// The cache is only exact if every mutation the app makes reports itself:
+// invalidateEntry() when a path is created/removed/changed, invalidateTree()
+// when a directory is removed or renamed. Safe to use from several threads.
+class DirCache {
+public:
+    DirCache();
+    ~DirCache();
+
+    bool dirExists(const std::string& dir);
+    // Stat of path taken from its parent's listing; false if it does not exist.
+    bool stat(const std::string& path, SceIoStat* out = nullptr);
+    // Full path (on-disk case) of dir/name matched case-insensitively; "" if absent.
+    std::string find(const std::string& dir, const char* name, bool wantDir = false, SceIoStat* outSt = nullptr);
+    // Copy of the listing; false if dir does not exist.
+    bool list(const std::string& dir, std::vector<DirCacheEntry>& out);
+
+    void invalidateEntry(const std::string& path);
+    void invalidateTree(const std::string& dir);
+    void clear();
+    // Drop the oldest listings until at most keepDirs remain (heap pressure).
+    void trim(size_t keepDirs);
+    size_t size();
+
+    unsigned hits()   const { return _hits; }
+    unsigned misses() const { return _misses; }
+
+private:
+    struct Listing {
+        bool exists = false;
+        PooledMap<DirCacheEntry, HB_Caches> byName;               // lowercase name
+    };
+    const Listing& load(const std::string& dirNoSlash);          // caller holds _lock
+    const Listing* cached(const std::string& dirNoSlash);        // caller holds _lock
+    void erase(const std::string& key);                          // caller holds _lock
+
+    PooledMap<Listing, HB_Caches> _dirs;
+    std::deque<std::string> _order;                              // keys of _dirs in insertion order, for eviction
+    SceUID   _lock   = -1;
+    unsigned _hits   = 0;
+    unsigned _misses = 0;
+};
+
+extern DirCache gDirCache;
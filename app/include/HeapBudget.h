@@ -0,0 +1,107 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <unordered_map>
+
+// Accounting and pressure handling for the app's fixed heap.
+//
+// Big buffers (textures, copy buffers) come from hbAlloc(), which charges a
+// budget class. Node-heavy containers (catalog, directory and size caches)
+// use PoolAlloc, which packs small objects into slabs and charges its class
+// too. When a class runs over budget or the heap runs low, the registered
+// shrinkers (caches) give memory back; only if that is not enough does an
+// allocation fail, and failures are counted rather than silent. Container
+// nodes cannot fail (no exceptions): running out there is fatal.
+enum HeapClass { HB_Textures, HB_IoBuffers, HB_Catalog, HB_Caches, HB_CLASSES };
+
+struct HeapStats {
+    size_t   used[HB_CLASSES];
+    size_t   peak[HB_CLASSES];
+    size_t   budget[HB_CLASSES];
+    size_t   heapUsed, heapPeak, heapTotal;   // whole malloc heap
+    size_t   smallSlabs, smallUsed;           // small-object pool: slab bytes / bytes handed out
+    unsigned trims, failures;
+};
+
+// Call once from the UI thread before starting workers; heapBytes is the
+// PSP_HEAP_SIZE the app was linked with.
+void hbInit(size_t heapBytes);
+
+// nullptr only after shrinking could not make room. align 0 = malloc().
+void* hbAlloc(HeapClass c, size_t n, size_t align = 0);
+void  hbFree(HeapClass c, void* p, size_t n);
+// Memory a subsystem holds that did not come from hbAlloc().
+void  hbCharge(HeapClass c, ptrdiff_t delta);
+
+// Shrinkers run in registration order (cheapest first) and only on the UI
+// thread. c == HB_CLASSES: run only for whole-heap pressure.
+typedef void (*HeapShrinker)(void* ctx);
+void hbAddShrinker(HeapClass c, HeapShrinker fn, void* ctx);
+
+// UI thread, once per frame: trims when a class is over budget or the
+// heap is low. Cheap when there is no pressure.
+void hbTick();
+
+void hbGetStats(HeapStats& out);
+unsigned hbFailures();
+const char* hbClassName(HeapClass c);
+
+// Called once when a container node cannot be allocated, before the app
+// exits; logging only, it must not allocate from the pool.
+typedef void (*HeapFatalFn)(size_t bytes);
+void hbSetFatalHandler(HeapFatalFn fn);
+// Runs the fatal handler and exits the app; does not return.
+void hbOutOfMemory(size_t bytes);
+
+// Small objects (<= SMALL_MAX bytes) come from per-size free lists over
+// 4 KB aligned slabs, so churn in maps and sets does not fragment the main
+// heap; larger requests fall through to malloc(). Slabs that become empty
+// go back to malloc when trimming and from hbTick(). Before failing, the UI
+// thread trims and a worker waits for the UI thread to. c is charged for
+// the bytes (HB_CLASSES = uncharged).
+enum { SMALL_MAX = 256 };
+void* smallAlloc(size_t n, HeapClass c = HB_CLASSES);
+void  smallFree(void* p, size_t n, HeapClass c = HB_CLASSES);
+
+// STL allocator over smallAlloc() that charges class C.
+template <typename T, HeapClass C>
+struct PoolAlloc {
+    typedef T value_type;
+    template <typename U> struct rebind { typedef PoolAlloc<U, C> other; };
+
+    PoolAlloc() {}
+    template <typename U> PoolAlloc(const PoolAlloc<U, C>&) {}
+
+    T* allocate(size_t n) {
+        void* p = smallAlloc(n * sizeof(T), C);
+        if (!p) hbOutOfMemory(n * sizeof(T));
+        return (T*)p;
+    }
+    void deallocate(T* p, size_t n) { smallFree(p, n * sizeof(T), C); }
+};
+template <typename T, typename U, HeapClass C>
+inline bool operator==(const PoolAlloc<T, C>&, const PoolAlloc<U, C>&) { return true; }
+template <typename T, typename U, HeapClass C>
+inline bool operator!=(const PoolAlloc<T, C>&, const PoolAlloc<U, C>&) { return false; }
+
+// String-keyed hash map whose nodes live in the small-object pool.
+template <typename V, HeapClass C>
+using PooledMap = std::unordered_map<std::string, V, std::hash<std::string>, std::equal_to<std::string>,
+                                     PoolAlloc<std::pair<const std::string, V>, C> >;
+
+// Scoped hbAlloc() buffer that settles for less: the request is halved down
+// to minBytes before giving up (data == nullptr).
+struct HeapBuffer {
+    HeapClass cls;
+    uint8_t*  data = nullptr;
+    size_t    size = 0;
+
+    HeapBuffer(HeapClass c, size_t want, size_t minBytes) : cls(c) {
+        for (size_t n = want; !data && n >= minBytes && n; n >>= 1)
+            if ((data = (uint8_t*)hbAlloc(c, n, 64)) != nullptr) size = n;
+    }
+    ~HeapBuffer() { hbFree(cls, data, size); }
+    HeapBuffer(const HeapBuffer&) = delete;
+    HeapBuffer& operator=(const HeapBuffer&) = delete;
+};
@@ -0,0 +1,83 @@
+#pragma once
+#include <string>
+#include <unordered_map>
+#include <stdint.h>
+#include <psptypes.h>
+#include <pspkerneltypes.h>
+#include "iso_titles_extras.h"
+#include "HeapBudget.h"
+
+// Pack a ScePspDateTime into a monotonic 64-bit key (year..microsecond).
+uint64_t packDateTime(const ScePspDateTime& dt);
+ScePspDateTime unpackDateTime(uint64_t key);
+
+// One remembered scan result. An entry is valid while the item's key size
+// (ISO: file size, EBOOT folder: EBOOT.PBP size) and mtime are unchanged.
+struct CatalogEntry {
+    uint64_t    keySize  = 0;
+    uint64_t    mtimeKey = 0;
+    uint64_t    bytes    = 0;   // size shown in the list (ISO: file, EBOOT: whole folder)
+    uint8_t     kind     = 0;   // GameItem::Kind
+    std::string title;
+    std::string discId;
+    DiscParams  params;
+    bool        seen     = false; // hit/stored during the current scan
+};
+
+// Persistent per-device metadata catalog (<dev>KFE_catalog.bin).
+// Safe to share between the scanner/size workers and the UI thread.
+class ScanCatalog {
+public:
+    ScanCatalog();
+    ~ScanCatalog();
+
+    // Switch to dev ("ms0:/" / "ef0:/"), saving the previous device first if dirty.
+    void open(const std::string& dev);
+    bool save();
+    const std::string& device() const { return _dev; }
+
+    // Copies the entry into out; false on miss or when size/mtime no longer match.
+    bool lookup(const std::string& path, uint64_t keySize, uint64_t mtimeKey, CatalogEntry& out);
+    void store(const std::string& path, const CatalogEntry& e);
+    // Record a folder size measured later (ignored if the entry is gone or stale).
+    void setBytes(const std::string& path, uint64_t mtimeKey, uint64_t bytes);
+
+    // Keep entries valid across the app's own mutations.
+    void touch(const std::string& path, uint64_t newMtimeKey);
+    void rename(const std::string& from, const std::string& to);
+    void renamePrefix(const std::string& fromDir, const std::string& toDir);
+    void erase(const std::string& path);
+
+    // Full-scan bracket: beginScan() clears hit marks and stats, pruneUnseen()
+    // drops entries the scan did not encounter (deleted outside the app).
+    void beginScan();
+    void pruneUnseen();
+
+    // Visit every entry as fn(path, entry), under the lock (fn must not call
+    // back into the catalog). Used to rebuild the lists at a warm start.
+    template <typename Fn> void forEach(Fn fn) {
+        Guard g(_lock);
+        for (auto& kv : _entries) fn(kv.first, kv.second);
+    }
+
+    unsigned hits()   const { return _hits; }
+    unsigned misses() const { return _misses; }
+    void resetStats() { _hits = _misses = 0; }
+
+private:
+    bool load();
+    bool saveLocked();
+
+    struct Guard {
+        SceUID id;
+        explicit Guard(SceUID i);
+        ~Guard();
+    };
+
+    SceUID      _lock = -1;
+    std::string _dev;
+    PooledMap<CatalogEntry, HB_Catalog> _entries;
+    bool     _dirty  = false;
+    unsigned _hits   = 0;
+    unsigned _misses = 0;
+};
@@ -0,0 +1,23 @@
+#pragma once
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+// What was on screen when the app was last closed (KFE_session.bin next to
+// the log), so the next launch can show it before any scan. Item rows are
+// stored as paths in display order; the items themselves come from the
+// device's catalog.
+struct SessionSnapshot {
+    std::string device;              // "ms0:/" / "ef0:/"
+    uint8_t     view       = 0;      // KernelFileExplorer::View
+    bool        showTitles = false;
+    std::string category;            // open category ("" in the flat view)
+    int32_t     selected   = 0;
+    int32_t     scroll     = 0;
+    std::vector<std::string> rows;   // item paths of the list on screen, in order
+};
+
+bool sessionLoad(SessionSnapshot& out);
+bool sessionSave(const SessionSnapshot& s);
+// Forget the snapshot (e.g. the app was closed on the device list).
+void sessionClear();
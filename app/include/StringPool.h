@@ -0,0 +1,49 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <stdint.h>
+#include <stddef.h>
+#include <pspkerneltypes.h>
+
+// Append-only pool of interned, NUL-terminated strings packed into 8 KB
+// blocks. An ID encodes (block, offset), so str() is a plain array index
+// with no lock; IDs stay valid for the whole session. ID 0 is "".
+//
+// intern() dedupes: the same text always yields the same ID, so rescans
+// and repeated titles cost nothing extra. Safe to intern from several
+// threads (scanner, title workers) while the UI thread reads.
+class StringPool {
+public:
+    StringPool();
+    ~StringPool();
+
+    uint32_t intern(const char* s, size_t n);
+    uint32_t intern(const std::string& s) { return intern(s.data(), s.size()); }
+    // ID of already-interned text, or 0 if it was never interned. Never adds.
+    uint32_t find(const char* s, size_t n) const;
+    const char* str(uint32_t id) const { return _blocks[id >> BLOCK_SHIFT] + (id & BLOCK_MASK); }
+
+    unsigned count() const { return _count; }
+    size_t   bytes() const;   // blocks + hash table
+
+private:
+    enum {
+        BLOCK_SHIFT = 13,
+        BLOCK_SIZE  = 1 << BLOCK_SHIFT,
+        BLOCK_MASK  = BLOCK_SIZE - 1,
+        MAX_BLOCKS  = 1024,
+        MAX_LEN     = 511      // longer strings are truncated
+    };
+    bool equals(uint32_t id, const char* s, size_t n) const;
+    void grow();               // caller holds _lock
+
+    char*    _blocks[MAX_BLOCKS];
+    uint32_t _nBlocks = 0;
+    uint32_t _used    = 0;     // bytes used in the last block
+    std::vector<uint32_t> _table;   // open addressing, 0 = empty slot
+    unsigned _count   = 0;
+    SceUID   _lock    = -1;
+};
+
+// Names, parent directories and titles of every GameItem.
+extern StringPool gStrings;
@@ -3,6 +3,10 @@
 #include <vector>
 #include <stdint.h>
 
+// ---------- PARAM.SFO ----------
+// String value of wantKey (trailing NULs/spaces trimmed); false if absent or empty.
+bool sfoExtractString(const uint8_t* data, size_t size, const char* wantKey, std::string& out);
+
 // ---------- Titles ----------
 bool readIsoTitle(const std::string& path, std::string& outTitle);
 bool readCompressedIsoTitle(const std::string& path, std::string& outTitle); // .cso / .zso
@@ -16,5 +20,30 @@ bool readDaxIconPNG(const std::string& path, std::vector<uint8_t>& outVec);  //
 // Convenience: choose ISO/CSO/ZSO/DAX/JSO automatically; returns PNG bytes
 bool ExtractIcon0PNG(const std::string& path, std::vector<uint8_t>& outVec);
 
+// ---------- Container layout (what the opener detected) ----------
+enum DiscFormat { DF_UNKNOWN = 0, DF_ISO, DF_CSO, DF_ZSO, DF_JSO, DF_DAX };
+struct DiscParams {
+    uint8_t  format    = DF_UNKNOWN;
+    uint8_t  align     = 0;  // index shift
+    uint8_t  method    = 0;  // CSO/ZSO: header version; JSO: 1=zlib 2=lzo; DAX: 1=MSB marks stored
+    uint32_t blockSize = 0;
+    uint32_t indexOff  = 0;
+};
+
+// Title + DISC_ID + layout in a single open (format picked by extension).
+// outParams is filled even when PARAM.SFO has no title.
+bool readDiscInfo(const std::string& path, std::string& outTitle, std::string& outDiscId, DiscParams& outParams);
+
+// Title / DISC_ID / ICON0.PNG / layout from one open and one PSP_GAME walk
+// (the PVD and directory extents come from a single read-ahead window).
+// Pass nullptr for what you don't need; false if anything requested is missing.
+bool readDiscMeta(const std::string& path, std::string* outTitle, std::string* outDiscId,
+                  DiscParams* outParams, std::vector<uint8_t>* outIcon);
+
+// A layout already known for path (e.g. from the catalog). The next JSO/DAX
+// open of path checks it against the PVD before probing; readDiscMeta()
+// remembers what it detects itself. Other formats are ignored.
+void discRememberParams(const std::string& path, const DiscParams& params);
+
 // Optional tiny link-probe (used by your app)
 extern "C" int cmfe_titles_extras_present();
@@ -67,16 +67,24 @@
 #include <stdint.h>
 #include <map>
 #include <unordered_set>
+#include <unordered_map>
+#include <deque>
 #include <stdarg.h>
 
 #include "Texture.h"
 #include "MessageBox.h"
 #include "iso_titles_extras.h"
+#include "ScanCatalog.h"
+#include "DirCache.h"
+#include "StringPool.h"
+#include "HeapBudget.h"
+#include "Session.h"
 
 
 PSP_MODULE_INFO("KernelFileExplorer", 0x800, 1, 0);
 PSP_MAIN_THREAD_ATTR(THREAD_ATTR_USER | THREAD_ATTR_VFPU);
-PSP_HEAP_SIZE_KB(4096);
+#define APP_HEAP_KB 4096
+PSP_HEAP_SIZE_KB(APP_HEAP_KB);
 
 // Human-readable byte formatter (SI: kB/MB/GB) or binary (KiB/MiB/GiB)
 #define HUMAN_BYTES_SI 1  // 1 = kB/MB/GB (1000), 0 = KiB/MiB/GiB (1024)
@@ -155,6 +163,46 @@ extern "C" {
                     void* outdata, int outlen);
 }
 
+// Filesystem call counters for scan profiling (reset and logged per scan).
+struct IoCallStats { unsigned dopen, dread, getstat, open; };
+static IoCallStats gIoCalls = {0, 0, 0, 0};
+
+// ===== Optional: per-phase scan timing =====
+//   1 = time readdir, stat, title decode and folder-size walks and log the
+//       totals with every scan (KFE_move.log); 0 = compiled out
+//   Totals are summed over all threads and phases nest (a size walk is
+//   mostly readdir), so compare like with like between runs.
+//   app/bench builds with -DSCAN_PROFILE=1.
+#ifndef SCAN_PROFILE
+#define SCAN_PROFILE  0
+#endif
+
+enum ScanPhase { SP_Readdir, SP_Stat, SP_Title, SP_SizeWalk, SP_Count };
+struct ScanPhaseStats { unsigned long long us[SP_Count]; unsigned n[SP_Count]; };
+static ScanPhaseStats gScanPhases;
+
+struct PhaseTimer {
+#if SCAN_PROFILE
+    ScanPhase ph; unsigned long long t0;
+    explicit PhaseTimer(ScanPhase p) : ph(p), t0(sceKernelGetSystemTimeWide()) {}
+    ~PhaseTimer() { gScanPhases.us[ph] += sceKernelGetSystemTimeWide() - t0; ++gScanPhases.n[ph]; }
+#else
+    explicit PhaseTimer(ScanPhase) {}
+#endif
+};
+
+// Counted/timed directory reads for the scan paths.
+static inline SceUID scanOpenDir(const char* path) {
+    PhaseTimer pt(SP_Readdir);
+    ++gIoCalls.dopen;
+    return pspIoOpenDir(path);
+}
+static inline int scanReadDir(SceUID d, SceIoDirent* ent) {
+    PhaseTimer pt(SP_Readdir);
+    ++gIoCalls.dread;
+    return pspIoReadDir(d, ent);
+}
+
 // Path split helpers
 static std::string dirnameOf(const std::string& p) {
     size_t s = p.find_last_of("/\\");
@@ -170,15 +218,50 @@ static std::string fileExtOf(const std::string& name) {
     return (d == std::string::npos) ? "" : name.substr(d);
 }
 static bool dirExists(const std::string& path){
-    SceUID d = pspIoOpenDir(path.c_str());
-    if (d >= 0){ pspIoCloseDir(d); return true; }
-    return false;
+    return gDirCache.dirExists(path);
 }
 static std::string joinDirFile(const std::string& dir, const char* fname){
     if (!dir.empty() && dir[dir.size()-1]=='/') return dir + fname;
     return dir + "/" + fname;
 }
 
+// Fixed-size path the recursive walkers push and pop components on, so a
+// walk allocates nothing per entry. No trailing '/' except on a device
+// root ("ms0:/").
+struct PathBuf {
+    enum { CAP = 512 };          // FAT paths stay far below this
+    char   buf[CAP];
+    size_t len = 0;
+    bool   fits = true;          // false if the start path was too long
+
+    explicit PathBuf(const std::string& p) {
+        fits = p.size() < CAP;
+        len  = fits ? p.size() : 0;
+        memcpy(buf, p.data(), len);
+        while (len > 1 && buf[len-1] == '/' && buf[len-2] != ':') --len;
+        buf[len] = '\0';
+    }
+    const char* c_str() const { return buf; }
+    const char* leaf()  const { const char* s = strrchr(buf, '/'); return s ? s + 1 : buf; }
+
+    // Append "/name"; false (path unchanged) if it would not fit.
+    bool push(const char* name) {
+        const size_t n = strlen(name);
+        const size_t slash = (len && buf[len-1] != '/') ? 1 : 0;
+        if (len + slash + n + 1 > CAP) return false;
+        if (slash) buf[len++] = '/';
+        memcpy(buf + len, name, n + 1);
+        len += n;
+        return true;
+    }
+    // Drop the last pushed component.
+    void pop() {
+        while (len && buf[len-1] != '/') --len;
+        if (len > 1 && buf[len-2] != ':') --len;   // keep the '/' of a device root
+        buf[len] = '\0';
+    }
+};
+
 // ---------- OSK speed-tuning toggles ----------
 #define OSK_MINIMAL_BACKDROP   1
 #define OSK_USE_VBLANK_CB      1
@@ -193,6 +276,16 @@ extern "C" int scePowerUnlock(int);
 //   1 = set CPU=333, BUS=166 for the whole app session
 #define FORCE_APP_333  1
 
+// ===== Titles: deferred extraction =====
+//   catalog misses are listed under their names and titled afterwards: rows
+//   on screen first, then this many items per background batch; and the
+//   threads decoding them (one can inflate/LZ4-decode while another waits
+//   on the stick; at most TITLE_WORKERS_MAX, app/bench compares 1/2/4)
+#define TITLE_FILL_BATCH    8
+#define TITLE_WORKERS       2
+#define TITLE_WORKERS_MAX   4
+static int gTitleWorkers = TITLE_WORKERS;
+
 #define SCREEN_WIDTH   480
 #define SCREEN_HEIGHT  272
 #define LIST_START_Y    50
@@ -244,7 +337,17 @@ static const int CHECKBOX_Y_NUDGE = -6;
 static const int NAME_TEXT_X      = CHECKBOX_X + 14;     // ~154px     <--- new
 
 // ===== Exit callback (HOME menu) =====
-static int ExitCallback(int, int, void*) { sceKernelExitGame(); return 0; }
+// The UI thread saves the session snapshot first (see run()); give it up to
+// a second, then quit regardless.
+static volatile int gExitRequested = 0;
+static volatile int gSessionSaved  = 0;
+static unsigned long long gLaunchUS = 0;   // for the time-to-first-list log
+static int ExitCallback(int, int, void*) {
+    gExitRequested = 1;
+    for (int i = 0; i < 100 && !gSessionSaved; ++i) sceKernelDelayThread(10 * 1000);
+    sceKernelExitGame();
+    return 0;
+}
 static int CallbackThread(SceSize, void*) {
     int cb = sceKernelCreateCallback("ExitCallback", ExitCallback, nullptr);
     sceKernelRegisterExitCallback(cb);
@@ -256,6 +359,12 @@ static void SetupCallbacks() {
     if (th >= 0) sceKernelStartThread(th, 0, nullptr);
 }
 
+// 1 = also log each file a tree copy writes (KFE_move.log grows by two
+// lines per file); 0 = failures and one summary per operation
+#ifndef LOG_VERBOSE
+#define LOG_VERBOSE 0
+#endif
+
 static SceUID gLogFd = -1;
 static void logInit() {
     if (gLogFd >= 0) return;
@@ -271,6 +380,17 @@ static void logf(const char* fmt, ...) {
     logWrite(buf); logWrite("\r\n");
 }
 static void logClose(){ if (gLogFd >= 0) { sceIoClose(gLogFd); gLogFd = -1; } }
+// One line to the log even when no operation has it open (e.g. scan timings).
+static void logfOnce(const char* fmt, ...) {
+    char buf[512];
+    va_list ap; va_start(ap, fmt);
+    vsnprintf(buf, sizeof(buf), fmt, ap);
+    va_end(ap);
+    const bool wasOpen = (gLogFd >= 0);
+    logInit();
+    logWrite(buf); logWrite("\r\n");
+    if (!wasOpen) logClose();
+}
 
 
 // --- path/device helpers ---
@@ -282,16 +402,31 @@ static inline std::string parentOf(const std::string& p) { return dirnameOf(p);
 
 // --- stat/exists ---
 static inline bool pathExists(const std::string& p, SceIoStat* out=nullptr) {
-    SceIoStat st{}; int rc = sceIoGetstat(p.c_str(), &st);
-    if (rc >= 0 && out) *out = st;
-    return rc >= 0;
+    return gDirCache.stat(p, out);
 }
+
+// --- mutating calls: every change the app makes goes through these so the
+//     directory cache never serves a stale listing (files being written are
+//     invalidated once closed, see invalidateWritten; the raw PathBuf walks
+//     invalidate their whole tree when done) ---
+static int ioRemove(const char* p)                { int rc = sceIoRemove(p);   gDirCache.invalidateEntry(p); return rc; }
+static int ioRmdir(const char* p)                 { int rc = sceIoRmdir(p);    gDirCache.invalidateTree(p);  return rc; }
+static int ioMkdir(const char* p, SceMode m)      { int rc = sceIoMkdir(p, m); gDirCache.invalidateEntry(p); return rc; }
+static int ioRename(const char* a, const char* b) {
+    int rc = sceIoRename(a, b);
+    gDirCache.invalidateTree(a); gDirCache.invalidateTree(b);
+    return rc;
+}
+static int ioChstat(const char* p, SceIoStat* st, int bits) {
+    int rc = sceIoChstat(p, st, bits); gDirCache.invalidateEntry(p); return rc;
+}
+static inline void invalidateWritten(const std::string& p) { gDirCache.invalidateEntry(p); }
 static inline bool isDirMode(const SceIoStat& st){ return (st.st_mode & FIO_S_IFDIR) != 0; }
 
 // --- mkdir (no error if already exists) ---
 static bool ensureDir(const std::string& dirNoSlash) {
     if (dirExists(dirNoSlash)) return true;
-    int rc = sceIoMkdir(dirNoSlash.c_str(), 0777);
+    int rc = ioMkdir(dirNoSlash.c_str(), 0777);
     return (rc >= 0) || dirExists(dirNoSlash);
 }
 static bool ensureDirRecursive(const std::string& fullDir) {
@@ -327,44 +462,60 @@ static bool __attribute__((unused)) isDirEmpty(const std::string& dir) {
 }
 
 // --- remove recursively (you already have a version; keep one) ---
-static bool removeDirRecursive(const std::string& dir) {
+// The walk uses raw sceIo calls; the wrapper invalidates the cached tree once.
+static bool removeDirRecursive(PathBuf& dir) {
     SceUID d = pspIoOpenDir(dir.c_str());
     if (d < 0) return sceIoRmdir(dir.c_str()) >= 0;
     SceIoDirent ent; memset(&ent, 0, sizeof(ent));
     while (pspIoReadDir(d, &ent) > 0) {
         if (!strcmp(ent.d_name, ".") || !strcmp(ent.d_name, "..")) { memset(&ent,0,sizeof(ent)); continue; }
-        std::string child = joinDirFile(dir, ent.d_name);
-        if (FIO_S_ISDIR(ent.d_stat.st_mode)) removeDirRecursive(child);
-        else sceIoRemove(child.c_str());
+        if (dir.push(ent.d_name)) {
+            if (FIO_S_ISDIR(ent.d_stat.st_mode)) removeDirRecursive(dir);
+            else sceIoRemove(dir.c_str());
+            dir.pop();
+        }
         memset(&ent, 0, sizeof(ent));
         sceKernelDelayThread(0);
     }
     pspIoCloseDir(d);
     return sceIoRmdir(dir.c_str()) >= 0;
 }
+static bool removeDirRecursive(const std::string& dir) {
+    PathBuf p(dir);
+    if (!p.fits) return false;
+    bool ok = removeDirRecursive(p);
+    gDirCache.invalidateTree(dir);
+    return ok;
+}
 
-// --- fast per-file rename based folder move (same device, no data copy) ---
-static bool fastMoveDirByRenames(const std::string& srcDir, const std::string& dstDir) {
-    logf("fastMoveDirByRenames: %s -> %s", srcDir.c_str(), dstDir.c_str());
-    if (!ensureDirRecursive(dstDir)) { logf("  ensureDirRecursive(dst) FAILED"); return false; }
+// mkdir on a walker path (no cache); true if it exists afterwards.
+static bool mkdirRaw(const char* p) {
+    if (sceIoMkdir(p, 0777) >= 0) return true;
+    SceIoStat st{};
+    return sceIoGetstat(p, &st) >= 0 && FIO_S_ISDIR(st.st_mode);
+}
 
-    SceUID d = pspIoOpenDir(srcDir.c_str());
-    if (d < 0) { logf("  open src failed %d", d); return false; }
+// --- fast per-file rename based folder move (same device, no data copy) ---
+// Walks src and dst PathBufs in step with raw sceIo calls; the wrapper
+// invalidates both cached trees once at the end.
+static bool fastMoveDirByRenames(PathBuf& s, PathBuf& t) {
+    SceUID d = pspIoOpenDir(s.c_str());
+    if (d < 0) { logf("  open src %s failed %d", s.c_str(), d); return false; }
 
     bool ok = true;
     SceIoDirent ent; memset(&ent, 0, sizeof(ent));
     while (ok && pspIoReadDir(d, &ent) > 0) {
         if (!strcmp(ent.d_name, ".") || !strcmp(ent.d_name, "..")) { memset(&ent,0,sizeof(ent)); continue; }
-        std::string s = joinDirFile(srcDir, ent.d_name);
-        std::string t = joinDirFile(dstDir, ent.d_name);
+        if (!s.push(ent.d_name)) { ok = false; break; }
+        if (!t.push(ent.d_name)) { s.pop(); ok = false; break; }
 
         if (FIO_S_ISDIR(ent.d_stat.st_mode)) {
             // move subtree first
-            ok = fastMoveDirByRenames(s, t);
+            ok = mkdirRaw(t.c_str()) && fastMoveDirByRenames(s, t);
             if (ok) sceIoRmdir(s.c_str());
         } else {
-            // if target file exists, remove it (replace semantics)
-            if (pathExists(t)) sceIoRemove(t.c_str());
+            // replace semantics: drop any existing target (harmless if absent)
+            sceIoRemove(t.c_str());
             int rr = sceIoRename(s.c_str(), t.c_str());
             if (rr < 0) {
                 // rename refused (some drivers); fall back to real copy for this file
@@ -373,15 +524,15 @@ static bool fastMoveDirByRenames(const std::string& srcDir, const std::string& d
                 SceUID out = sceIoOpen(t.c_str(), PSP_O_WRONLY | PSP_O_CREAT | PSP_O_TRUNC, 0666);
                 if (in < 0 || out < 0) { if (in >= 0) sceIoClose(in); if (out >= 0) sceIoClose(out); ok = false; }
                 else {
-                    const int BUF = 128 * 1024; std::vector<uint8_t> buf(BUF);
-                    ok = true;
+                    HeapBuffer buf(HB_IoBuffers, 128 * 1024, 16 * 1024);
+                    ok = (buf.data != nullptr);
                     while (ok) {
-                        int r = sceIoRead(in, buf.data(), BUF);
+                        int r = sceIoRead(in, buf.data, (int)buf.size);
                         if (r < 0) { ok = false; break; }
                         if (r == 0) break;
                         int off = 0;
                         while (off < r) {
-                            int w = sceIoWrite(out, buf.data() + off, r - off);
+                            int w = sceIoWrite(out, buf.data + off, r - off);
                             if (w <= 0) { ok = false; break; }
                             off += w;
                         }
@@ -392,30 +543,46 @@ static bool fastMoveDirByRenames(const std::string& srcDir, const std::string& d
                 }
             }
         }
+        t.pop(); s.pop();
         memset(&ent, 0, sizeof(ent));
         sceKernelDelayThread(0);
     }
     pspIoCloseDir(d);
+    return ok;
+}
+static bool fastMoveDirByRenames(const std::string& srcDir, const std::string& dstDir) {
+    logf("fastMoveDirByRenames: %s -> %s", srcDir.c_str(), dstDir.c_str());
+    if (!ensureDirRecursive(dstDir)) { logf("  ensureDirRecursive(dst) FAILED"); return false; }
+    PathBuf s(srcDir), t(dstDir);
+    bool ok = s.fits && t.fits && fastMoveDirByRenames(s, t);
+    gDirCache.invalidateTree(srcDir);
+    gDirCache.invalidateTree(dstDir);
     logf("fastMoveDirByRenames: %s", ok ? "OK" : "FAIL");
     return ok;
 }
 
 // --- size calculators (for preflight) ---
-static bool sumDirBytes(const std::string& dir, uint64_t& out) {
-    logf("sumDirBytes: enter %s (start=%llu)", dir.c_str(), (unsigned long long)out);
-    SceUID d = pspIoOpenDir(dir.c_str()); if (d < 0) return false;
+static bool sumDirBytes(PathBuf& dir, uint64_t& out) {
+    SceUID d = scanOpenDir(dir.c_str()); if (d < 0) return false;
     SceIoDirent ent; memset(&ent, 0, sizeof(ent));
-    while (pspIoReadDir(d, &ent) > 0) {
+    while (scanReadDir(d, &ent) > 0) {
         if (!strcmp(ent.d_name,".") || !strcmp(ent.d_name,"..")) { memset(&ent,0,sizeof(ent)); continue; }
-        std::string p = joinDirFile(dir, ent.d_name);
-        if (FIO_S_ISDIR(ent.d_stat.st_mode)) { if (!sumDirBytes(p, out)) { pspIoCloseDir(d); return false; } }
+        if (FIO_S_ISDIR(ent.d_stat.st_mode)) {
+            if (!dir.push(ent.d_name)) { pspIoCloseDir(d); return false; }
+            const bool ok = sumDirBytes(dir, out);
+            dir.pop();
+            if (!ok) { pspIoCloseDir(d); return false; }
+        }
         else out += (uint64_t)ent.d_stat.st_size;
         memset(&ent, 0, sizeof(ent));
     }
     pspIoCloseDir(d);
-    logf("sumDirBytes: leave %s (now=%llu)", dir.c_str(), (unsigned long long)out);
     return true;
 }
+static bool sumDirBytes(const std::string& dir, uint64_t& out) {
+    PathBuf p(dir);
+    return p.fits && sumDirBytes(p, out);
+}
 
 // add near the other helpers
 static void __attribute__((unused)) hexdump(const void* p, size_t n) {
@@ -715,37 +882,7 @@ static bool isJunkHidden(const char* n) {
     return false;
 }
 
-// case-insensitive EBOOT finder (for presence checks only)
-static std::string findEbootCaseInsensitive(const std::string& dirMaybeSlash){
-    std::string dpath = dirMaybeSlash;
-    if (!dpath.empty() && dpath[dpath.size()-1]=='/') dpath.erase(dpath.size()-1);
-    SceUID d = pspIoOpenDir(dpath.c_str());
-    if (d < 0) return {};
-    SceIoDirent ent; memset(&ent, 0, sizeof(ent));
-    while (pspIoReadDir(d, &ent) > 0) {
-        if (!FIO_S_ISDIR(ent.d_stat.st_mode) && strcasecmp(ent.d_name, "EBOOT.PBP") == 0) {
-            std::string full = joinDirFile(dpath, ent.d_name); pspIoCloseDir(d); return full;
-        }
-        memset(&ent, 0, sizeof(ent));
-    }
-    pspIoCloseDir(d);
-    return {};
-}
-
 // Legacy-style date string
-static std::string buildLegacySortKey(const ScePspDateTime& dt){
-    unsigned y  = (dt.year  < 0) ? 0u : (dt.year  > 9999 ? 9999u : (unsigned)dt.year);
-    unsigned mo = (dt.month < 0) ? 0u : ((unsigned)dt.month % 100u);
-    unsigned d  = (dt.day   < 0) ? 0u : ((unsigned)dt.day   % 100u);
-    unsigned h  = (dt.hour  < 0) ? 0u : ((unsigned)dt.hour  % 100u);
-    unsigned mi = (dt.minute< 0) ? 0u : ((unsigned)dt.minute% 100u);
-    unsigned s  = (dt.second< 0) ? 0u : ((unsigned)dt.second% 100u);
-    unsigned us = (dt.microsecond < 0) ? 0u :
-                  (dt.microsecond > 999999 ? 999999u : (unsigned)dt.microsecond);
-    char buf[32];
-    snprintf(buf, sizeof(buf), "%04u%02u%02u%02u%02u%02u%06u", y,mo,d,h,mi,s,us);
-    return std::string(buf);
-}
 static void fmtDT(const ScePspDateTime& dt, char* out, size_t n){
     unsigned y  = (dt.year  < 0) ? 0u : (dt.year  > 9999 ? 9999u : (unsigned)dt.year);
     unsigned mo = (dt.month < 0) ? 0u : ((unsigned)dt.month % 100u);
@@ -759,12 +896,12 @@ static void fmtDT(const ScePspDateTime& dt, char* out, size_t n){
 // dir iterator
 template<typename F>
 static void forEachEntry(const std::string& dir, F f){
-    std::string dpath = dir;
-    if (!dpath.empty() && dpath[dpath.size()-1]=='/') dpath.erase(dpath.size()-1);
-    SceUID d = pspIoOpenDir(dpath.c_str());
+    PathBuf dpath(dir);    // trailing '/' dropped without a heap copy
+    if (!dpath.fits) return;
+    SceUID d = scanOpenDir(dpath.c_str());
     if (d < 0) return;
     SceIoDirent ent; memset(&ent, 0, sizeof(ent));
-    while (pspIoReadDir(d, &ent) > 0) {
+    while (scanReadDir(d, &ent) > 0) {
         if (!strcmp(ent.d_name, ".") || !strcmp(ent.d_name, "..")) { memset(&ent,0,sizeof(ent)); continue; }
         if (isJunkHidden(ent.d_name))                                 { memset(&ent,0,sizeof(ent)); continue; }
         f(ent);
@@ -892,131 +1029,222 @@ bool sfoExtractTitle(const uint8_t* data, size_t size, std::string& outTitle) {
     return false;
 }
 
-static std::string findFileCaseInsensitive(const std::string& dirNoSlash, const char* wantName) {
-    std::string dpath = dirNoSlash;
+// One readdir pass over an EBOOT folder: the files the scan needs, the
+// byte total of its top level and the subfolders still to be sized.
+struct FolderScan {
+    std::string eboot, sfo, icon;          // full paths, "" if absent
+    SceIoStat   ebootSt{}, sfoSt{};
+    uint64_t    topBytes = 0;              // regular files directly in the folder
+    std::vector<std::string> subdirs;
+};
+static bool scanFolderOnce(const std::string& folderNoSlash, FolderScan& out) {
+    std::string dpath = folderNoSlash;
     if (!dpath.empty() && dpath.back() == '/') dpath.pop_back();
-    SceUID d = pspIoOpenDir(dpath.c_str());
-    if (d < 0) return {};
+    SceUID d = scanOpenDir(dpath.c_str());
+    if (d < 0) return false;
     SceIoDirent ent; memset(&ent, 0, sizeof(ent));
-    std::string out;
-    while (pspIoReadDir(d, &ent) > 0) {
-        if (!FIO_S_ISDIR(ent.d_stat.st_mode) && strcasecmp(ent.d_name, wantName) == 0) {
-            out = joinDirFile(dpath, ent.d_name);
-            break;
+    while (scanReadDir(d, &ent) > 0) {
+        if (!strcmp(ent.d_name, ".") || !strcmp(ent.d_name, "..")) { memset(&ent,0,sizeof(ent)); continue; }
+        if (FIO_S_ISDIR(ent.d_stat.st_mode)) {
+            out.subdirs.push_back(joinDirFile(dpath, ent.d_name));
+        } else {
+            out.topBytes += (uint64_t)ent.d_stat.st_size;
+            if (out.eboot.empty() && !strcasecmp(ent.d_name, "EBOOT.PBP")) {
+                out.eboot = joinDirFile(dpath, ent.d_name); out.ebootSt = ent.d_stat;
+            } else if (out.sfo.empty() && !strcasecmp(ent.d_name, "PARAM.SFO")) {
+                out.sfo = joinDirFile(dpath, ent.d_name);   out.sfoSt = ent.d_stat;
+            } else if (out.icon.empty() && !strcasecmp(ent.d_name, "ICON0.PNG")) {
+                out.icon = joinDirFile(dpath, ent.d_name);
+            }
         }
         memset(&ent, 0, sizeof(ent));
     }
     pspIoCloseDir(d);
-    return out;
+    return true;
 }
 
-// Read title from folder
-static bool getFolderTitle(const std::string& folderNoSlash, std::string& outTitle) {
-    std::string sfoPath = findFileCaseInsensitive(folderNoSlash, "PARAM.SFO");
-    if (!sfoPath.empty()) {
-        SceUID fd = sceIoOpen(sfoPath.c_str(), PSP_O_RDONLY, 0);
-        if (fd >= 0) {
-            SceIoStat st{}; if (sceIoGetstat(sfoPath.c_str(), &st) >= 0 && st.st_size > 0 && st.st_size < 1*1024*1024) {
-                std::vector<uint8_t> buf((size_t)st.st_size);
-                if (readAll(fd, buf.data(), buf.size())) {
-                    sceIoClose(fd);
-                    if (sfoExtractTitle(buf.data(), buf.size(), outTitle)) return true;
-                } else sceIoClose(fd);
-            } else sceIoClose(fd);
-        }
-    }
-    std::string eboot = findEbootCaseInsensitive(folderNoSlash);
-    if (!eboot.empty()) {
-        SceUID fd = sceIoOpen(eboot.c_str(), PSP_O_RDONLY, 0);
+// Whole-folder size from a FolderScan (only the subfolders are walked again).
+static bool folderScanBytes(const FolderScan& fs, uint64_t& out) {
+    out += fs.topBytes;
+    for (auto& sub : fs.subdirs) if (!sumDirBytes(sub, out)) return false;
+    return true;
+}
+
+// Read title (and optionally DISC_ID) from a scanned folder: loose PARAM.SFO first, then the EBOOT's.
+static bool readFolderTitle(const FolderScan& fs, std::string& outTitle, std::string* outDiscId = nullptr) {
+    if (!fs.sfo.empty() && fs.sfoSt.st_size > 0 && fs.sfoSt.st_size < 1*1024*1024) {
+        ++gIoCalls.open;
+        SceUID fd = sceIoOpen(fs.sfo.c_str(), PSP_O_RDONLY, 0);
         if (fd >= 0) {
-            uint8_t hdr[4 + 4 + 8*4];
-            if (readAll(fd, hdr, sizeof(hdr))) {
-                bool isPBP = (memcmp(hdr, "\0PBP", 4) == 0) || (memcmp(hdr, "PBP\0", 4) == 0);
-                if (isPBP) {
-                    auto r32 = [](const uint8_t* p)->uint32_t {
-                        return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
-                    };
-                    uint32_t offs[8];
-                    for (int i = 0; i < 8; ++i) offs[i] = r32(hdr + 8 + i*4);
-
-                    SceIoStat st{}; sceIoGetstat(eboot.c_str(), &st);
-                    uint32_t fileSize = (uint32_t)st.st_size;
-
-                    uint32_t start = offs[0]; // PARAM.SFO
-                    if (start < sizeof(hdr) || start >= fileSize) start = sizeof(hdr);
-
-                    uint32_t end = fileSize;
-                    for (int i = 1; i < 8; ++i) if (offs[i] && offs[i] > start && offs[i] < end) end = offs[i];
-
-                    const uint32_t MAX_SCAN = 1024*1024;
-                    if (end - start > MAX_SCAN) end = start + MAX_SCAN;
-                    if (end > fileSize) end = fileSize;
-                    if (end <= start) { sceIoClose(fd); return false; }
-
-                    std::vector<uint8_t> buf(end - start);
-                    if (!readAt(fd, start, buf.data(), buf.size())) { sceIoClose(fd); return false; }
-                    sceIoClose(fd);
-
-                    if (sfoExtractTitle(buf.data(), buf.size(), outTitle)) return true;
-
-                    static const uint8_t PSF_MAGIC[4] = { 'P','S','F','\0' };
-                    for (size_t i = 0; i + 4 <= buf.size(); i += 4) {
-                        if (memcmp(&buf[i], PSF_MAGIC, 4) == 0) {
-                            if (sfoExtractTitle(buf.data() + i, buf.size() - i, outTitle)) return true;
-                        }
-                    }
-                }
-                sceIoClose(fd);
-            }
+            std::vector<uint8_t> buf((size_t)fs.sfoSt.st_size);
+            bool ok = readAll(fd, buf.data(), buf.size());
             sceIoClose(fd);
+            if (ok) {
+                if (outDiscId) sfoExtractString(buf.data(), buf.size(), "DISC_ID", *outDiscId);
+                if (sfoExtractTitle(buf.data(), buf.size(), outTitle)) return true;
+            }
+        }
+    }
+    if (fs.eboot.empty()) return false;
+    ++gIoCalls.open;
+    SceUID fd = sceIoOpen(fs.eboot.c_str(), PSP_O_RDONLY, 0);
+    if (fd < 0) return false;
+    uint8_t hdr[4 + 4 + 8*4];
+    if (!readAll(fd, hdr, sizeof(hdr))) { sceIoClose(fd); return false; }
+    bool isPBP = (memcmp(hdr, "\0PBP", 4) == 0) || (memcmp(hdr, "PBP\0", 4) == 0);
+    if (!isPBP) { sceIoClose(fd); return false; }
+
+    auto r32 = [](const uint8_t* p)->uint32_t {
+        return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+    };
+    uint32_t offs[8];
+    for (int i = 0; i < 8; ++i) offs[i] = r32(hdr + 8 + i*4);
+
+    uint32_t fileSize = (uint32_t)fs.ebootSt.st_size;
+
+    uint32_t start = offs[0]; // PARAM.SFO
+    if (start < sizeof(hdr) || start >= fileSize) start = sizeof(hdr);
+
+    uint32_t end = fileSize;
+    for (int i = 1; i < 8; ++i) if (offs[i] && offs[i] > start && offs[i] < end) end = offs[i];
+
+    const uint32_t MAX_SCAN = 1024*1024;
+    if (end - start > MAX_SCAN) end = start + MAX_SCAN;
+    if (end > fileSize) end = fileSize;
+    if (end <= start) { sceIoClose(fd); return false; }
+
+    std::vector<uint8_t> buf(end - start);
+    if (!readAt(fd, start, buf.data(), buf.size())) { sceIoClose(fd); return false; }
+    sceIoClose(fd);
+
+    if (outDiscId) sfoExtractString(buf.data(), buf.size(), "DISC_ID", *outDiscId);
+    if (sfoExtractTitle(buf.data(), buf.size(), outTitle)) return true;
+
+    static const uint8_t PSF_MAGIC[4] = { 'P','S','F','\0' };
+    for (size_t i = 0; i + 4 <= buf.size(); i += 4) {
+        if (memcmp(&buf[i], PSF_MAGIC, 4) == 0) {
+            if (outDiscId) sfoExtractString(buf.data() + i, buf.size() - i, "DISC_ID", *outDiscId);
+            if (sfoExtractTitle(buf.data() + i, buf.size() - i, outTitle)) return true;
         }
     }
     return false;
 }
 
-// Minimal ISO9660 reader for ICON (unchanged)
-struct IsoDirRec { uint32_t lba; uint32_t size; uint8_t flags; };
-static bool isoReadDirRec(const uint8_t* p, size_t n, size_t off, IsoDirRec& out, std::string& name, bool& isDir) {
-    if (off + 1 > n) return false;
-    uint8_t len = p[off + 0];
-    if (len == 0) return false;
-    if (off + len > n) return false;
-    const uint8_t* r = p + off;
-    auto le32 = [](const uint8_t* q)->uint32_t{ return (uint32_t)q[0] | ((uint32_t)q[1]<<8) | ((uint32_t)q[2]<<16) | ((uint32_t)q[3]<<24); };
-    uint32_t lba = le32(r + 2);
-    uint32_t size = le32(r + 10);
-    uint8_t flags = r[25];
-    uint8_t nameLen = r[32];
-    const char* nm = (const char*)(r + 33);
-    name.assign(nm, nm + nameLen);
-    if (nameLen == 1 && (nm[0] == 0 || nm[0] == 1)) name = "";
-    size_t sc = name.find(';'); if (sc != std::string::npos) name.resize(sc);
-    isDir = (flags & 0x02) != 0;
-    out.lba = lba; out.size = size; out.flags = flags;
-    return true;
+// ===== Folder sizes (size column + free-space preflight) =====
+// Computed on request by a low-priority worker and cached by folder path +
+// folder mtime. Requests go to the front of the queue, so the rows on screen
+// are served before ones the user has scrolled past.
+struct FolderSizeCache {
+    struct Req { std::string path; uint64_t mtimeKey; };
+    std::deque<Req> queue;
+    std::unordered_set<std::string> queued;
+    PooledMap<std::pair<uint64_t, uint64_t>, HB_Caches> sizes; // path → (mtimeKey, bytes)
+
+    SceUID threadId = -1;
+    SceUID lock     = -1;   // guards the containers above
+    SceUID wake     = -1;   // counts queued requests
+};
+static FolderSizeCache gFSZ;
+static const size_t FOLDER_SIZE_QUEUE_MAX = 64;   // stale requests beyond this are dropped
+
+static void FolderSizeStore(const std::string& path, uint64_t mtimeKey, uint64_t bytes) {
+    if (gFSZ.lock < 0) return;
+    sceKernelWaitSema(gFSZ.lock, 1, nullptr);
+    gFSZ.sizes[path] = std::make_pair(mtimeKey, bytes);
+    sceKernelSignalSema(gFSZ.lock, 1);
 }
-static bool isoFindEntry(SceUID fd, const IsoDirRec& dir, const char* target, IsoDirRec& out) {
-    uint32_t bytes = ((dir.size + ISO_SECTOR - 1)/ISO_SECTOR)*ISO_SECTOR;
-    std::vector<uint8_t> buf(bytes);
-    if (!readAt(fd, dir.lba * ISO_SECTOR, buf.data(), bytes)) return false;
 
-    size_t pos = 0;
-    while (pos < bytes) {
-        if (buf[pos] == 0) {
-            pos = ((pos / ISO_SECTOR) + 1) * ISO_SECTOR;
-            continue;
+// Cache only; false if unknown or the folder changed since it was measured.
+static bool FolderSizeLookup(const std::string& path, uint64_t mtimeKey, uint64_t& outBytes) {
+    if (gFSZ.lock < 0) return false;
+    bool hit = false;
+    sceKernelWaitSema(gFSZ.lock, 1, nullptr);
+    auto it = gFSZ.sizes.find(path);
+    if (it != gFSZ.sizes.end() && it->second.first == mtimeKey) { outBytes = it->second.second; hit = true; }
+    sceKernelSignalSema(gFSZ.lock, 1);
+    return hit;
+}
+
+static int FolderSizeThread(SceSize, void*) {
+    while (sceKernelWaitSema(gFSZ.wake, 1, nullptr) >= 0) {
+        FolderSizeCache::Req r;
+        sceKernelWaitSema(gFSZ.lock, 1, nullptr);
+        bool have = !gFSZ.queue.empty();
+        if (have) {
+            r = gFSZ.queue.front();
+            gFSZ.queue.pop_front();
+            gFSZ.queued.erase(r.path);
         }
-        IsoDirRec r{}; std::string nm; bool isDir=false;
-        if (!isoReadDirRec(buf.data(), bytes, pos, r, nm, isDir)) break;
-        if (!nm.empty() && strcasecmp(nm.c_str(), target) == 0) { out = r; return true; }
-        pos += buf[pos];
+        sceKernelSignalSema(gFSZ.lock, 1);
+        if (!have) continue;
+
+        uint64_t cached = 0;
+        if (FolderSizeLookup(r.path, r.mtimeKey, cached)) continue;
+        PhaseTimer pt(SP_SizeWalk);
+        FolderScan fs;
+        uint64_t bytes = 0;
+        if (scanFolderOnce(r.path, fs) && folderScanBytes(fs, bytes))
+            FolderSizeStore(r.path, r.mtimeKey, bytes);
     }
-    return false;
+    return 0;
+}
+
+static void FolderSizeInit() {
+    if (gFSZ.threadId >= 0) return;
+    gFSZ.lock = sceKernelCreateSema("FSZ_Lock", 0, 1, 1, nullptr);
+    gFSZ.wake = sceKernelCreateSema("FSZ_Wake", 0, 0, 0x7FFFFFFF, nullptr);
+    gFSZ.threadId = sceKernelCreateThread("FSZ_Worker", FolderSizeThread, 0x32 /* below the scanner */, 0x4000, 0, nullptr);
+    if (gFSZ.threadId >= 0) sceKernelStartThread(gFSZ.threadId, 0, nullptr);
+}
+
+// Queue a folder for measuring (no-op if already cached or queued).
+static void FolderSizeRequest(const std::string& path, uint64_t mtimeKey) {
+    FolderSizeInit();
+    if (gFSZ.threadId < 0) return;
+    uint64_t cached = 0;
+    if (FolderSizeLookup(path, mtimeKey, cached)) return;
+    sceKernelWaitSema(gFSZ.lock, 1, nullptr);
+    bool added = gFSZ.queued.insert(path).second;
+    if (added) {
+        gFSZ.queue.push_front(FolderSizeCache::Req{path, mtimeKey});
+        if (gFSZ.queue.size() > FOLDER_SIZE_QUEUE_MAX) {
+            gFSZ.queued.erase(gFSZ.queue.back().path);
+            gFSZ.queue.pop_back();
+        }
+    }
+    sceKernelSignalSema(gFSZ.lock, 1);
+    if (added) sceKernelSignalSema(gFSZ.wake, 1);
+}
+
+// Blocking variant for the preflight: cached size, or measure now and cache it.
+static bool FolderSizeGet(const std::string& path, uint64_t& outBytes) {
+    SceIoStat st{};
+    ++gIoCalls.getstat;
+    if (sceIoGetstat(path.c_str(), &st) < 0) return false;
+    const uint64_t tkey = packDateTime(st.sce_st_mtime);
+    if (FolderSizeLookup(path, tkey, outBytes)) return true;
+    uint64_t bytes = 0;
+    {
+        PhaseTimer pt(SP_SizeWalk);
+        if (!sumDirBytes(path, bytes)) return false;
+    }
+    FolderSizeStore(path, tkey, bytes);
+    outBytes = bytes;
+    return true;
 }
 
+// Heap shrinker: forget measured sizes (listed items keep theirs in the catalog).
+static void FolderSizeTrim(void*) {
+    if (gFSZ.lock < 0) return;
+    PooledMap<std::pair<uint64_t, uint64_t>, HB_Caches> dropped;
+    sceKernelWaitSema(gFSZ.lock, 1, nullptr);
+    gFSZ.sizes.swap(dropped);
+    sceKernelSignalSema(gFSZ.lock, 1);
+}
 
-// CSO / ZSO (v1 and v2)
-static Texture* loadCompressedIsoIconPNG(const std::string& path) {
+// ISO / CSO / ZSO / JSO / DAX: one PSP_GAME walk through the shared
+// disc reader (see readDiscMeta in iso_titles_extras).
+static Texture* loadDiscIconPNG(const std::string& path) {
     std::vector<uint8_t> png;
     if (ExtractIcon0PNG(path, png) && !png.empty())
         return texLoadPNGFromMemory(png.data(), (int)png.size());
@@ -1049,36 +1277,56 @@ static Texture* loadIconFromPBP(const std::string& ebootPath) {
     return texLoadPNGFromMemory(buf.data(), (int)buf.size());
 }
 
-// Uncompressed ISO
-static Texture* loadIsoIconPNG(const std::string& isoPath) {
-    SceUID fd = sceIoOpen(isoPath.c_str(), PSP_O_RDONLY, 0);
-    if (fd < 0) return nullptr;
-    uint8_t pvd[ISO_SECTOR];
-    if (!readAt(fd, 16 * ISO_SECTOR, pvd, sizeof(pvd))) { sceIoClose(fd); return nullptr; }
-    if (!(pvd[0]==1 && memcmp(pvd+1,"CD001",5)==0 && pvd[6]==1)) { sceIoClose(fd); return nullptr; }
-    IsoDirRec root{}; { std::string nm; bool isDir=false;
-        if (!isoReadDirRec(pvd, sizeof(pvd), 156, root, nm, isDir)) { sceIoClose(fd); return nullptr; } }
-    IsoDirRec pspGame{}; if (!isoFindEntry(fd, root, "PSP_GAME", pspGame)) { sceIoClose(fd); return nullptr; }
-    IsoDirRec icon{};    if (!isoFindEntry(fd, pspGame, "ICON0.PNG", icon)) { sceIoClose(fd); return nullptr; }
-    if (!icon.size || icon.size > 1024*1024) { sceIoClose(fd); return nullptr; }
-    std::vector<uint8_t> png(icon.size);
-    if (!readAt(fd, icon.lba * ISO_SECTOR, png.data(), (uint32_t)png.size())) { sceIoClose(fd); return nullptr; }
-    sceIoClose(fd);
-    return texLoadPNGFromMemory(png.data(), (int)png.size());
-}
-
-
 // ---------------------------------------------------------------
 // Model types + label mode
 // ---------------------------------------------------------------
+// Compact record (32 bytes, no heap of its own): text lives in gStrings.
 struct GameItem {
-    enum Kind { ISO_FILE, EBOOT_FOLDER } kind;
-    std::string    label;      // filename/folder name (default)
-    std::string    title;      // app title (if found)
-    std::string    path;       // ISO file OR ***EBOOT PARENT FOLDER PATH*** (no trailing slash)
-    ScePspDateTime time{};     // the time we sort by (folder for EBOOT, file for ISO)
-    std::string    sortKey;    // legacy sort string (desc)
-    uint64_t       sizeBytes = 0;  // <--- NEW: bytes for size column
+    enum Kind : uint8_t { ISO_FILE, EBOOT_FOLDER };
+    Kind     kind      = ISO_FILE;
+    bool     titlePending = false;   // catalog miss, title not read yet (see pumpTitles())
+    bool     sizeKnown = false;      // sizeBytes was measured (a folder can really be 0 bytes)
+    uint32_t dirId     = 0;    // parent dir incl. trailing '/' (device + root + category)
+    uint32_t nameId    = 0;    // filename/folder name; also the default label
+    uint32_t titleId   = 0;    // app title (if found), 0 = none
+    uint64_t timeKey   = 0;    // packDateTime() of the time we sort by (folder for EBOOT, file for ISO); desc
+    uint64_t sizeBytes = 0;    // bytes for size column
+
+    // ISO file OR ***EBOOT PARENT FOLDER PATH*** (no trailing slash)
+    std::string path() const { return std::string(gStrings.str(dirId)) + gStrings.str(nameId); }
+    void setPath(const std::string& p) {
+        const size_t cut = dirLength(p);
+        dirId  = gStrings.intern(p.data(), cut);
+        nameId = gStrings.intern(p.data() + cut, p.size() - cut);
+    }
+    // (dirId, nameId) as one key: equal keys mean equal paths.
+    uint64_t pathKey() const { return ((uint64_t)dirId << 32) | nameId; }
+    // pathKey() an item at p would have; 0 if none can exist (text never interned).
+    static uint64_t pathKeyOf(const std::string& p) {
+        const size_t cut = dirLength(p);
+        const uint32_t d = gStrings.find(p.data(), cut);
+        const uint32_t n = d ? gStrings.find(p.data() + cut, p.size() - cut) : 0;
+        return n ? (((uint64_t)d << 32) | n) : 0;
+    }
+    static size_t dirLength(const std::string& p) {
+        size_t s = p.find_last_of('/');
+        return (s == std::string::npos) ? 0 : s + 1;
+    }
+    // path() == p without building the string.
+    bool isAt(const std::string& p) const {
+        const char* d = gStrings.str(dirId);
+        size_t dn = strlen(d);
+        return p.size() > dn && memcmp(p.data(), d, dn) == 0 && strcmp(p.c_str() + dn, gStrings.str(nameId)) == 0;
+    }
+    bool samePath(const GameItem& o) const { return dirId == o.dirId && nameId == o.nameId; }
+
+    const char* label() const { return gStrings.str(nameId); }
+    const char* title() const { return gStrings.str(titleId); }
+    bool hasTitle() const { return titleId != 0; }
+    void setTitle(const std::string& t) { titleId = gStrings.intern(t); }
+    // Row text: the title in title mode when there is one, else the name.
+    const char* displayName(bool titles) const { return (titles && titleId) ? title() : label(); }
+    ScePspDateTime time() const { return unpackDateTime(timeKey); }
 };
 
 
@@ -1111,13 +1359,14 @@ static uint64_t bytesNeededForOp(const std::vector<std::string>& srcPaths,
                 logf("need: ISO %s stat FAIL", srcPaths[i].c_str());
             }
         } else {
-            uint64_t before = need;
-            if (!sumDirBytes(srcPaths[i], need)) {
+            uint64_t dirBytes = 0;
+            if (!FolderSizeGet(srcPaths[i], dirBytes)) {
                 logf("need: DIR %s sum FAIL", srcPaths[i].c_str());
             } else {
+                need += dirBytes;
                 logf("need: DIR %s added=%llu total=%llu",
                      srcPaths[i].c_str(),
-                     (unsigned long long)(need - before),
+                     (unsigned long long)dirBytes,
                      (unsigned long long)need);
             }
         }
@@ -1170,38 +1419,42 @@ struct PowerLockGuard {
 };
 #endif
 
-static void sortLikeLegacy(std::vector<GameItem>& v){
+// A view of a device's items: indices into its arena (see KernelFileExplorer::arena).
+typedef std::vector<uint32_t> ItemIndex;
+
+static void sortLikeLegacy(ItemIndex& v, const std::vector<GameItem>& arena){
     std::sort(v.begin(), v.end(),
-              [](const GameItem& a, const GameItem& b){ return a.sortKey > b.sortKey; }); // descending
+              [&arena](uint32_t a, uint32_t b){ return arena[a].timeKey > arena[b].timeKey; }); // descending
 }
 
 // Case-insensitive A→Z sort of the working list.
 void sortWorkingListAlpha(bool byTitle,
-                          std::vector<GameItem>& workingList,
+                          const std::vector<GameItem>& arena,
+                          ItemIndex& workingList,
                           int& selectedIndex,
                           int& scrollOffset) {
     if (workingList.empty()) return;
 
-    std::string keepPath;
-    if (selectedIndex >= 0 && selectedIndex < (int)workingList.size())
-        keepPath = workingList[selectedIndex].path;
+    const bool haveKeep = (selectedIndex >= 0 && selectedIndex < (int)workingList.size());
+    const uint32_t keep = haveKeep ? workingList[selectedIndex] : 0;
 
     std::stable_sort(workingList.begin(), workingList.end(),
-        [byTitle](const GameItem& a, const GameItem& b) {
-            const std::string& sa = (byTitle && !a.title.empty()) ? a.title : a.label;
-            const std::string& sb = (byTitle && !b.title.empty()) ? b.title : b.label;
-
-            int c = strcasecmp(sa.c_str(), sb.c_str());
+        [byTitle, &arena](uint32_t ia, uint32_t ib) {
+            const GameItem& a = arena[ia];
+            const GameItem& b = arena[ib];
+            int c = strcasecmp(a.displayName(byTitle), b.displayName(byTitle));
             if (c != 0) return c < 0;
 
-            int c2 = strcasecmp(a.label.c_str(), b.label.c_str());
+            int c2 = strcasecmp(a.label(), b.label());
             if (c2 != 0) return c2 < 0;
-            return a.path < b.path;
+            int c3 = strcmp(gStrings.str(a.dirId), gStrings.str(b.dirId));
+            if (c3 != 0) return c3 < 0;
+            return strcmp(a.label(), b.label()) < 0;
         });
 
-    if (!keepPath.empty()) {
+    if (haveKeep) {
         for (int i = 0; i < (int)workingList.size(); ++i) {
-            if (workingList[i].path == keepPath) { selectedIndex = i; break; }
+            if (workingList[i] == keep) { selectedIndex = i; break; }
         }
         if (selectedIndex < scrollOffset) scrollOffset = selectedIndex;
         if (selectedIndex >= scrollOffset + MAX_DISPLAY)
@@ -1322,22 +1575,52 @@ private:
 
     // Data for current device
     std::string currentDevice;
-    std::map<std::string, std::vector<GameItem>> categories; // key = CAT_* or "Uncategorized"
-    std::vector<GameItem> uncategorized;
-    std::vector<GameItem> flatAll;
+    std::vector<GameItem> arena;     // every item of the device; the views below index into it.
+                                     // An arena index is the item's ID: stable until the next full scan.
+    std::unordered_map<uint64_t, uint32_t> pathIndex;   // GameItem::pathKey() → ID of the listed item
+    std::map<std::string, ItemIndex> categories; // key = CAT_* or "Uncategorized"
+    ItemIndex uncategorized;
+    ItemIndex flatAll;
     std::vector<std::string> categoryNames;
     bool hasCategories = false;
+    std::string scannedDevice;   // device the lists above belong to
+
+    // Category index of the lists above: per category (key as in `categories`,
+    // "Uncategorized" for loose items) how many items it holds and how many
+    // bytes. Rebuilt by syncDerivedLists() after every scan and operation,
+    // kept current in between by applyScanItem() and setItemBytes(); the
+    // category view shows both without walking the lists.
+    struct CategoryStats { uint32_t items = 0; uint64_t bytes = 0; };
+    std::map<std::string, CategoryStats> catIndex;
 
     enum View { View_Categories, View_CategoryContents, View_AllFlat } view = View_AllFlat;
     std::string currentCategory;
 
     // Active list for content view (this is what we reorder & save)
-    std::vector<GameItem> workingList;
+    ItemIndex workingList;
+    GameItem&       row(int i)       { return arena[workingList[i]]; }
+    const GameItem& row(int i) const { return arena[workingList[i]]; }
+    uint32_t addItem(const GameItem& gi) { arena.push_back(gi); return (uint32_t)(arena.size() - 1); }
+    static const uint32_t NO_ITEM = UINT32_MAX;
+    uint32_t itemIdOf(const std::string& path) const {
+        const uint64_t key = GameItem::pathKeyOf(path);
+        if (!key) return NO_ITEM;
+        auto it = pathIndex.find(key);
+        return (it == pathIndex.end()) ? NO_ITEM : it->second;
+    }
+    void indexItem(uint32_t id)   { pathIndex[arena[id].pathKey()] = id; }
+    void unindexItem(uint32_t id) {
+        auto it = pathIndex.find(arena[id].pathKey());
+        if (it != pathIndex.end() && it->second == id) pathIndex.erase(it);
+    }
 
-    // UI cache
-    std::vector<SceIoDirent> entries;
-    std::vector<std::string> entryPaths;
-    std::vector<GameItem::Kind> entryKinds;
+    // Rows of the root and category views (a handful, all folders). Item views
+    // have no row copies: rowName()/rowIsDir() read workingList on demand.
+    std::vector<std::string> dirRows;
+    bool itemView() const { return !showRoots && (view == View_AllFlat || view == View_CategoryContents); }
+    int  rowCount() const { return itemView() ? (int)workingList.size() : (int)dirRows.size(); }
+    bool rowIsDir(int) const { return !itemView(); }
+    const char* rowName(int i) const { return itemView() ? row(i).displayName(showTitles) : dirRows[i].c_str(); }
 
     // Selected item icon cache
     Texture* selectionIconTex = nullptr;
@@ -1356,8 +1639,30 @@ private:
     int selectedIndex = 0;
     int scrollOffset  = 0;
 
-    // Paths currently checked
-    std::unordered_set<std::string> checked;
+    // Checkmarks: one bit per item ID of the active lists (parked with them).
+    std::vector<uint32_t> checkedBits;
+    unsigned checkedCount = 0;
+    bool isChecked(uint32_t id) const {
+        return (id >> 5) < checkedBits.size() && (checkedBits[id >> 5] & (1u << (id & 31)));
+    }
+    void setChecked(uint32_t id, bool on) {
+        if ((id >> 5) >= checkedBits.size()) {
+            if (!on) return;
+            checkedBits.resize(std::max<size_t>((id >> 5) + 1, (arena.size() + 31) >> 5), 0);
+        }
+        uint32_t& w = checkedBits[id >> 5];
+        const uint32_t bit = 1u << (id & 31);
+        if (!!(w & bit) == on) return;
+        w ^= bit;
+        if (on) ++checkedCount; else --checkedCount;
+    }
+    void clearChecked() { checkedBits.clear(); checkedCount = 0; }
+    template<typename Fn>
+    void forEachChecked(Fn fn) const {
+        for (size_t w = 0; w < checkedBits.size(); ++w)
+            for (uint32_t bits = checkedBits[w]; bits; bits &= bits - 1)
+                fn((uint32_t)(w * 32 + __builtin_ctz(bits)));
+    }
 
     // Pick/drop state
     bool moving = false;
@@ -1385,6 +1690,16 @@ private:
     // Cache of entries that have no embedded icon; use placeholder and don't retry.
     std::unordered_set<std::string> noIconPaths;
 
+    // Persistent per-device title/size catalogs (see ScanCatalog.h), one per
+    // root and both kept loaded, so either device scans without a reload.
+    ScanCatalog catalogs[2];
+    ScanCatalog& catalogFor(const std::string& path) {
+        const bool ef = (strncasecmp(path.c_str(), "ef0:", 4) == 0);
+        ScanCatalog& c = catalogs[ef ? 1 : 0];
+        c.open(ef ? "ef0:/" : "ms0:/");   // no-op once loaded
+        return c;
+    }
+
     // -----------------------------
     // New: Operation (Move/Copy) state
     // -----------------------------
@@ -1411,31 +1726,62 @@ private:
     int         preOpSel = 0;
     int         preOpScroll = 0;
 
-    // --- scan snapshot so we can instantly reuse current device contents ---
-    struct ScanSnapshot {
-        std::map<std::string, std::vector<GameItem>> categories;
-        std::vector<GameItem> uncategorized;
-        std::vector<GameItem> flatAll;
+    // --- resident device lists: the active device's lists are the members
+    // above; every other scanned device's are parked here. Switching device
+    // (browsing or picking a Move/Copy destination) swaps them in and out,
+    // nothing is copied or rescanned. ---
+    struct DeviceLists {
+        std::vector<GameItem> arena;
+        std::unordered_map<uint64_t, uint32_t> pathIndex;
+        std::vector<uint32_t> checkedBits;
+        unsigned checkedCount = 0;
+        std::map<std::string, ItemIndex> categories;
+        ItemIndex uncategorized;
+        ItemIndex flatAll;
         std::vector<std::string> categoryNames;
+        std::map<std::string, CategoryStats> catIndex;
         bool hasCategories = false;
+        bool complete = false;       // a full scan finished (partial while scanning)
     };
-    ScanSnapshot preOpScan{};
-    bool hasPreOpScan = false;
-
+    std::map<std::string, DeviceLists> resident;   // by device root
+    bool listsComplete = false;                    // `complete` of the active lists
+
+    void swapLists(DeviceLists& d) {
+        arena.swap(d.arena);
+        pathIndex.swap(d.pathIndex);
+        checkedBits.swap(d.checkedBits);
+        std::swap(checkedCount, d.checkedCount);
+        categories.swap(d.categories);
+        uncategorized.swap(d.uncategorized);
+        flatAll.swap(d.flatAll);
+        categoryNames.swap(d.categoryNames);
+        catIndex.swap(d.catIndex);
+        std::swap(hasCategories, d.hasCategories);
+        std::swap(listsComplete, d.complete);
+    }
 
-    void snapshotCurrentScan(ScanSnapshot& out) const {
-        out.categories     = categories;
-        out.uncategorized  = uncategorized;
-        out.flatAll        = flatAll;
-        out.categoryNames  = categoryNames;
-        out.hasCategories  = hasCategories;
+    // Make dev's lists the active ones, parking the current device's. A device
+    // that was never scanned comes back empty (listsComplete == false).
+    void activateLists(const std::string& dev) {
+        if (!scannedDevice.empty() && sameDevice(dev, scannedDevice)) return;
+        if (!scannedDevice.empty()) swapLists(resident[scannedDevice]);
+        auto it = resident.find(dev);
+        if (it != resident.end()) { swapLists(it->second); resident.erase(it); }
+        else { resetLists(); listsComplete = false; }
+        scannedDevice = dev;
+        titleFillCursor = 0;
     }
-    void restoreScan(const ScanSnapshot& in) {
-        categories     = in.categories;
-        uncategorized  = in.uncategorized;
-        flatAll        = in.flatAll;
-        categoryNames  = in.categoryNames;
-        hasCategories  = in.hasCategories;
+
+    // Run fn with dev's parked lists temporarily active (dev must not be the active device).
+    template<typename Fn>
+    void withParkedLists(const std::string& dev, Fn fn) {
+        DeviceLists& d = resident[dev];
+        std::string active; active.swap(scannedDevice);
+        swapLists(d);
+        scannedDevice = dev;
+        fn();
+        swapLists(d);
+        scannedDevice.swap(active);
     }
 
     // -----------------------------
@@ -1490,7 +1836,29 @@ private:
                 snprintf(buf, sizeof(buf), "%s — All content  | Label: %s", rootDisplayName(currentDevice.c_str()), lbl);
             }
             drawText(10,25,buf,COLOR_WHITE);
+            if (scanInForeground()) {
+                char sb[48];
+                snprintf(sb, sizeof(sb), "Scanning... %u", scanItemsSeen);
+                drawText(SCREEN_WIDTH - 110, 25, sb, COLOR_YELLOW);
+            }
         }
+        if (showDebugTimes) drawHeapStats(10, 37);
+    }
+
+    // Debug overlay: heap in use / peak, then used/budget per class (KB).
+    void drawHeapStats(int x, int y) {
+        HeapStats hs; hbGetStats(hs);
+        char line[160];
+        int n = snprintf(line, sizeof(line), "Heap %u/%uK pk %uK |",
+                         (unsigned)(hs.heapUsed >> 10), (unsigned)(hs.heapTotal >> 10), (unsigned)(hs.heapPeak >> 10));
+        for (int c = 0; c < HB_CLASSES && n < (int)sizeof(line); ++c)
+            n += snprintf(line + n, sizeof(line) - n, " %s %u/%u pk %u", hbClassName((HeapClass)c),
+                          (unsigned)(hs.used[c] >> 10), (unsigned)(hs.budget[c] >> 10), (unsigned)(hs.peak[c] >> 10));
+        if (n < (int)sizeof(line))
+            snprintf(line + n, sizeof(line) - n, " | slabs %uK trim %u fail %u",
+                     (unsigned)(hs.smallSlabs >> 10), hs.trims, hs.failures);
+        intraFontSetStyle(font, 0.4f, COLOR_GRAY, 0, 0.0f, INTRAFONT_ALIGN_LEFT);
+        intraFontPrint(font, (float)x, (float)y, line);
     }
 
     void freeSelectionIcon() {
@@ -1503,44 +1871,28 @@ private:
 
     Texture* loadIconForGameItem(const GameItem& gi) {
         if (gi.kind == GameItem::EBOOT_FOLDER) {
-            std::string iconPath = findFileCaseInsensitive(gi.path, "ICON0.PNG");
-            if (!iconPath.empty()) {
-                if (Texture* t = texLoadPNG(iconPath.c_str())) return t;
+            FolderScan fs;
+            if (!scanFolderOnce(gi.path(), fs)) return nullptr;
+            if (!fs.icon.empty()) {
+                if (Texture* t = texLoadPNG(fs.icon.c_str())) return t;
             }
-            std::string eboot = findEbootCaseInsensitive(gi.path);
-            if (!eboot.empty()) {
-                if (Texture* t = loadIconFromPBP(eboot)) return t;
+            if (!fs.eboot.empty()) {
+                if (Texture* t = loadIconFromPBP(fs.eboot)) return t;
             }
             return nullptr;
         }
-        const std::string& p = gi.path;
-        if (endsWithNoCase(p, ".iso")) {
-            return loadIsoIconPNG(p);
-        } else if (endsWithNoCase(p, ".cso") || endsWithNoCase(p, ".zso")) {
-            return loadCompressedIsoIconPNG(p);
-        } else if (endsWithNoCase(p, ".jso")) {
-            std::vector<uint8_t> png;
-            if (readJsoIconPNG(p, png) && !png.empty()) return texLoadPNGFromMemory(png.data(), (int)png.size());
-            return nullptr;
-        } else if (endsWithNoCase(p, ".dax")) {
-            std::vector<uint8_t> png;
-            if (readDaxIconPNG(p, png) && !png.empty()) return texLoadPNGFromMemory(png.data(), (int)png.size());
-            return nullptr;
-        }
-        return nullptr;
+        return loadDiscIconPNG(gi.path());
     }
 
     void ensureSelectionIcon() {
         if (msgBox || showRoots || !(view==View_AllFlat || view==View_CategoryContents)
-            || selectedIndex < 0 || selectedIndex >= (int)entries.size()
-            || FIO_S_ISDIR(entries[selectedIndex].d_stat.st_mode)) {
+            || selectedIndex < 0 || selectedIndex >= (int)workingList.size()) {
             freeSelectionIcon();
             return;
         }
-        if (selectedIndex >= (int)workingList.size()) { freeSelectionIcon(); return; }
 
-        const GameItem& gi = workingList[selectedIndex];
-        const std::string key = gi.path;
+        const GameItem& gi = row(selectedIndex);
+        const std::string key = gi.path();
         if (key == selectionIconKey && selectionIconTex) return;
 
         freeSelectionIcon();
@@ -1602,13 +1954,13 @@ private:
 
     void drawFileList() {
         int y = LIST_START_Y;
-        int end = std::min((int)entries.size(), scrollOffset+MAX_DISPLAY);
+        int end = std::min(rowCount(), scrollOffset+MAX_DISPLAY);
         intraFontActivate(font);
         sceGuEnable(GU_BLEND);
         sceGuBlendFunc(GU_ADD,GU_SRC_ALPHA,GU_ONE_MINUS_SRC_ALPHA,0,0);
         for(int i=scrollOffset; i<end; i++){
             bool sel  = (i==selectedIndex);
-            bool isDir= FIO_S_ISDIR(entries[i].d_stat.st_mode);
+            bool isDir= rowIsDir(i);
 
             bool disabled = (showRoots && i < (int)rowFlags.size() && (rowFlags[i] & ROW_DISABLED));
 
@@ -1625,7 +1977,7 @@ private:
 
             // NEW: when picking a destination category, gray out categories marked as disabled
             if (!showRoots && view==View_Categories && actionMode!=AM_None && opPhase==OP_SelectCategory) {
-                bool disabledCat = (opDisabledCategories.find(entries[i].d_name) != opDisabledCategories.end());
+                bool disabledCat = (opDisabledCategories.find(dirRows[i]) != opDisabledCategories.end());
                 if (disabledCat) labelCol = COLOR_GRAY;
             }
 
@@ -1635,19 +1987,31 @@ private:
             // --- filesize column (content views only, to the LEFT of the checkbox) ---
             if (!showRoots && (view == View_AllFlat || view == View_CategoryContents)) {
                 if (!isDir && i >= 0 && i < (int)workingList.size()) {
-                    const GameItem& gi = workingList[i];
-                    const std::string sz = (gi.sizeBytes > 0) ? humanSize3(gi.sizeBytes) : std::string("");
+                    const GameItem& gi = row(i);
+                    const std::string sz = (gi.sizeBytes > 0) ? humanSize3(gi.sizeBytes)
+                                         : gi.sizeKnown ? std::string("0B")
+                                         : (gi.kind == GameItem::EBOOT_FOLDER) ? std::string("...")   // size worker pending
+                                         : std::string("");
                     intraFontSetStyle(font, 0.5f, COLOR_GRAY, 0, 0.0f, INTRAFONT_ALIGN_RIGHT);
                     intraFontPrint(font, (float)SIZE_FIELD_RIGHT_X, (float)(y + 2.5f), sz.c_str());
                 }
+            } else if (!showRoots && view == View_Categories) {
+                // category rows: total of the sizes known so far, item count on the right
+                auto cs = catIndex.find(dirRows[i]);
+                if (cs != catIndex.end()) {
+                    intraFontSetStyle(font, 0.5f, COLOR_GRAY, 0, 0.0f, INTRAFONT_ALIGN_RIGHT);
+                    if (cs->second.bytes)
+                        intraFontPrint(font, (float)SIZE_FIELD_RIGHT_X, (float)(y + 2.5f), humanSize3(cs->second.bytes).c_str());
+                    char count[24];
+                    snprintf(count, sizeof(count), "%u item%s", (unsigned)cs->second.items, cs->second.items == 1 ? "" : "s");
+                    intraFontPrint(font, SCREEN_WIDTH - 20.0f, (float)(y + 2.5f), count);
+                }
             }
 
             // checkbox left of filename (content views only)
             if (!showRoots && (view == View_AllFlat || view == View_CategoryContents)) {
                 if (!isDir && i >= 0 && i < (int)workingList.size()) {
-                    const std::string& p = workingList[i].path;
-                    bool isChecked = (checked.find(p) != checked.end());
-                    drawCheckboxAt(CHECKBOX_X, y, isChecked);
+                    drawCheckboxAt(CHECKBOX_X, y, isChecked(workingList[i]));
                 }
             }
 
@@ -1655,8 +2019,8 @@ private:
             if(sel) intraFontSetStyle(font, 0.5f, COLOR_BLACK, COLOR_WHITE, 0.0f, INTRAFONT_ALIGN_LEFT);
             else    intraFontSetStyle(font, 0.5f, labelCol, 0x40000000, 0.0f, INTRAFONT_ALIGN_LEFT);
 
-            if (showRoots) intraFontPrint(font, (float)NAME_TEXT_X, y + 2.5f, rootDisplayName(entries[i].d_name));
-            else           intraFontPrint(font, (float)NAME_TEXT_X, y + 2.5f, entries[i].d_name);
+            if (showRoots) intraFontPrint(font, (float)NAME_TEXT_X, y + 2.5f, rootDisplayName(dirRows[i].c_str()));
+            else           intraFontPrint(font, (float)NAME_TEXT_X, y + 2.5f, rowName(i));
 
 
             if (showRoots && opPhase == OP_SelectDevice) {
@@ -1702,9 +2066,9 @@ private:
 
             if (!showRoots && (view==View_AllFlat || view==View_CategoryContents) && showDebugTimes && !isDir) {
                 if (i >= 0 && i < (int)workingList.size()) {
-                    const GameItem& gi = workingList[i];
+                    const GameItem& gi = row(i);
                     char right[64], buf[32];
-                    fmtDT(gi.time, buf, sizeof(buf));
+                    fmtDT(gi.time(), buf, sizeof(buf));
                     snprintf(right, sizeof(right), "%s [F]", buf);
                     intraFontSetStyle(font,0.5f,COLOR_GRAY,0,0.0f,INTRAFONT_ALIGN_RIGHT);
                     intraFontPrint(font, SCREEN_WIDTH-20.0f, y+2, right);
@@ -1713,9 +2077,10 @@ private:
             y += ITEM_HEIGHT;
         }
 
-        if ((int)entries.size()>MAX_DISPLAY) {
-            int h  = MAX_DISPLAY*180/entries.size();
-            int yy = LIST_START_Y + scrollOffset*180/entries.size();
+        const int nRows = rowCount();
+        if (nRows>MAX_DISPLAY) {
+            int h  = MAX_DISPLAY*180/nRows;
+            int yy = LIST_START_Y + scrollOffset*180/nRows;
             drawRect(SCREEN_WIDTH-10, yy, 5, h, COLOR_WHITE);
         }
     }
@@ -1950,10 +2315,11 @@ private:
     // ===================== Rename logic (unchanged) =====================
     void beginRenameSelected() {
         if (showRoots || moving) return;
+        finishScan();
 
         if (view == View_Categories) {
-            if (selectedIndex < 0 || selectedIndex >= (int)entries.size()) return;
-            std::string oldName = entries[selectedIndex].d_name;
+            if (selectedIndex < 0 || selectedIndex >= rowCount()) return;
+            std::string oldName = dirRows[selectedIndex];
             if (!strcasecmp(oldName.c_str(), "Uncategorized")) return;
             if (!startsWithCAT(oldName.c_str())) return;
 
@@ -1974,8 +2340,9 @@ private:
                 std::string from = base + oldName;
                 std::string to   = base + typed;
                 if (dirExists(from)) {
-                    int rc = sceIoRename(from.c_str(), to.c_str());
+                    int rc = ioRename(from.c_str(), to.c_str());
                     (rc >= 0) ? anyOk=true : anyFail=true;
+                    if (rc >= 0) catalogFor(from).renamePrefix(from + "/", to + "/");
                 }
             }
             for (auto r : gameRoots) {
@@ -1983,17 +2350,26 @@ private:
                 std::string from = base + oldName;
                 std::string to   = base + typed;
                 if (dirExists(from)) {
-                    int rc = sceIoRename(from.c_str(), to.c_str());
+                    int rc = ioRename(from.c_str(), to.c_str());
                     (rc >= 0) ? anyOk=true : anyFail=true;
+                    if (rc >= 0) catalogFor(from).renamePrefix(from + "/", to + "/");
                 }
             }
 
-            scanDevice(currentDevice);
+            if (anyOk && !anyFail) {
+                renameCategoryInLists(oldName, typed);
+            } else {
+                // partial rename: items may sit under either name now
+                rescanCategory(oldName);
+                rescanCategory(typed);
+                syncDerivedLists();
+            }
+            if (currentCategory == oldName) currentCategory = typed;
             delete msgBox; msgBox = nullptr;
 
             buildCategoryRows();
-            for (int i=0;i<(int)entries.size();++i)
-                if (!strcmp(entries[i].d_name, typed.c_str())) { selectedIndex=i; break; }
+            for (int i=0;i<rowCount();++i)
+                if (dirRows[i] == typed) { selectedIndex=i; break; }
 
             drawMessage(anyOk && !anyFail ? "Category renamed" : (anyOk ? "Some renamed" : "Rename failed"),
                         anyOk ? COLOR_GREEN : COLOR_RED);
@@ -2003,9 +2379,10 @@ private:
 
         if (view == View_AllFlat || view == View_CategoryContents) {
             if (selectedIndex < 0 || selectedIndex >= (int)workingList.size()) return;
-            GameItem gi = workingList[selectedIndex];
-            std::string dir  = dirnameOf(gi.path);
-            std::string base = basenameOf(gi.path);
+            GameItem gi = row(selectedIndex);
+            const std::string oldPath = gi.path();
+            std::string dir  = dirnameOf(oldPath);
+            std::string base = basenameOf(oldPath);
 
             std::string typed;
             if (!promptTextOSK("Rename", base.c_str(), 64, typed)) return;
@@ -2025,12 +2402,13 @@ private:
                 return;
             }
 
-            bool wasChecked = (checked.find(gi.path) != checked.end());
+            const uint32_t id = workingList[selectedIndex];
+            const bool wasChecked = isChecked(id);
 
             msgBox = new MessageBox("Renaming...", nullptr, SCREEN_WIDTH, SCREEN_HEIGHT, 1.0f, 0, "", 16, 18, 8, 14);
             renderOneFrame();
 
-            int rc = sceIoRename(gi.path.c_str(), newPath.c_str());
+            int rc = ioRename(oldPath.c_str(), newPath.c_str());
             if (rc < 0) {
                 delete msgBox; msgBox = nullptr;
                 drawMessage("Rename failed", COLOR_RED);
@@ -2038,24 +2416,15 @@ private:
                 return;
             }
 
-            if (wasChecked) {
-                checked.erase(gi.path);
-                checked.insert(newPath);
-            }
-
-            std::string keepPath = newPath;
-            scanDevice(currentDevice);
+            catalogFor(oldPath).rename(oldPath, newPath);
 
-            if (hasCategories) {
-                if (view == View_CategoryContents) openCategory(currentCategory);
-                else buildCategoryRows();
-            } else {
-                openDevice(currentDevice);
-            }
+            std::vector<OpDelta> deltas;
+            deltas.push_back({ OpDelta::D_Move, oldPath, newPath, gi.kind });
+            applyDeltas(deltas);
+            if (wasChecked) setChecked(id, true);   // a move keeps the ID but drops the mark
+            refreshViewFromLists(newPath);
 
             delete msgBox; msgBox = nullptr;
-
-            selectByPath(keepPath);
             drawMessage("Renamed", COLOR_GREEN);
             sceKernelDelayThread(600*1000);
         }
@@ -2109,8 +2478,10 @@ private:
 
     void selectByPath(const std::string& path){
         if (path.empty()) return;
+        const uint32_t id = itemIdOf(path);
+        if (id == NO_ITEM) return;
         for (int i = 0; i < (int)workingList.size(); ++i) {
-            if (workingList[i].path == path) {
+            if (workingList[i] == id) {
                 selectedIndex = i;
                 if (selectedIndex < scrollOffset) scrollOffset = selectedIndex;
                 if (selectedIndex >= scrollOffset + MAX_DISPLAY)
@@ -2127,16 +2498,14 @@ private:
         if (selectedIndex < 0 || selectedIndex >= (int)workingList.size()) return;
 
         // Always mark the current row first
-        const std::string& cur = workingList[selectedIndex].path;
-        checked.insert(cur);
+        setChecked(workingList[selectedIndex], true);
 
         // dir = -1 for up, +1 for down
         int j = selectedIndex + dir;
         while (j >= 0 && j < (int)workingList.size()) {
-            const std::string& p = workingList[j].path;
             // Stop at the first row that's already checked (barrier)
-            if (checked.find(p) != checked.end()) break;
-            checked.insert(p);
+            if (isChecked(workingList[j])) break;
+            setChecked(workingList[j], true);
             j += dir;
         }
     }
@@ -2163,223 +2532,1256 @@ private:
 
 
     void resetLists(){
+        arena.clear(); pathIndex.clear(); clearChecked();
         categories.clear(); uncategorized.clear(); flatAll.clear();
-        categoryNames.clear(); hasCategories = false; workingList.clear();
+        categoryNames.clear(); catIndex.clear(); hasCategories = false; workingList.clear();
         moving = false;
+        titleFillCursor = 0;
     }
 
     static bool getStat(const std::string& path, SceIoStat& out){
+        PhaseTimer pt(SP_Stat);
+        ++gIoCalls.getstat;
         memset(&out,0,sizeof(out));
         return sceIoGetstat(path.c_str(), &out) >= 0;
     }
     static bool getStatDirNoSlash(const std::string& dir, SceIoStat& out){
         std::string p = dir;
         if (!p.empty() && p[p.size()-1]=='/') p.erase(p.size()-1);
+        PhaseTimer pt(SP_Stat);
+        ++gIoCalls.getstat;
         memset(&out,0,sizeof(out));
         return sceIoGetstat(p.c_str(), &out) >= 0;
     }
 
-    void scanIsoRootDir(const std::string& base){
-        if (!dirExists(base)) return;
-        forEachEntry(base, [&](const SceIoDirent &e){
-            std::string name = e.d_name;
-            if (FIO_S_ISDIR(e.d_stat.st_mode)) {
-                if (startsWithCAT(name.c_str())){
-                    hasCategories = true;
-                    std::string catDir = base + name;
-                    forEachEntry(catDir, [&](const SceIoDirent &ee){
-                        if (!FIO_S_ISDIR(ee.d_stat.st_mode)){
-                            std::string fn = ee.d_name;
-                            if (isIsoLike(fn)){
-                                GameItem gi; gi.kind = GameItem::ISO_FILE;
-                                gi.label = fn;
-                                gi.path  = joinDirFile(catDir, fn.c_str());
-                                SceIoStat st;
-                                if (getStat(gi.path, st)){
-                                    gi.time     = st.sce_st_mtime;
-                                    gi.sortKey  = buildLegacySortKey(gi.time);
-                                    gi.sizeBytes= (uint64_t)st.st_size;   // <--- NEW
-                                }
-
-
-                                if (endsWithNoCase(fn, ".iso")) {
-                                    std::string t; if (readIsoTitle(gi.path, t)) gi.title = t;
-                                } else if (endsWithNoCase(fn, ".cso") || endsWithNoCase(fn, ".zso")) {
-                                    std::string t; if (readCompressedIsoTitle(gi.path, t)) gi.title = t;
-                                } else if (endsWithNoCase(fn, ".dax")) {
-                                    std::string t; if (readDaxTitle(gi.path, t)) gi.title = t;
-                                } else if (endsWithNoCase(fn, ".jso")) {
-                                    std::string t; if (readJsoTitle(gi.path, t)) gi.title = t;
-                                }
-
-                                categories[name].push_back(gi);
-                            }
-                        }
-                    });
-                }
+    // Catalog lookup for a discovered item; false when its title/size must be resolved.
+    bool lookupCatalog(GameItem& gi, uint64_t keySize) {
+        CatalogEntry ce;
+        const std::string path = gi.path();
+        if (!catalogFor(path).lookup(path, keySize, gi.timeKey, ce)) return false;
+        gi.setTitle(ce.title);
+        if (gi.kind == GameItem::ISO_FILE) discRememberParams(path, ce.params);
+        if (gi.kind == GameItem::EBOOT_FOLDER && ce.bytes) {
+            gi.sizeBytes = ce.bytes;
+            FolderSizeStore(path, ce.mtimeKey, ce.bytes);
+        }
+        return true;
+    }
+
+    // Title (and folder size, if cheap, for EBOOTs) the slow way; the result is stored in the
+    // catalog, misses included. keySize: ISO file size / EBOOT.PBP size.
+    // fs: the folder pass from discovery, if the caller still has it.
+    void resolveDetails(GameItem& gi, uint64_t keySize, const FolderScan* fs = nullptr) {
+        CatalogEntry ce;
+        const std::string path = gi.path();
+        ce.keySize = keySize; ce.mtimeKey = gi.timeKey;
+        ce.kind = (uint8_t)gi.kind;
+        if (gi.kind == GameItem::ISO_FILE) {
+            ce.bytes = gi.sizeBytes;
+            PhaseTimer pt(SP_Title);
+            ++gIoCalls.open;
+            readDiscInfo(path, ce.title, ce.discId, ce.params);
+        } else {
+            FolderScan local;
+            if (!fs) { scanFolderOnce(path, local); fs = &local; }
+            // Folder size: free when the folder is flat or already measured,
+            // otherwise left to the size worker (see pumpSizes()).
+            bool known = true;
+            if (fs->subdirs.empty()) {
+                ce.bytes = fs->topBytes;
+                FolderSizeStore(path, ce.mtimeKey, ce.bytes);
             } else {
-                if (isIsoLike(name)){
-                    GameItem gi; gi.kind = GameItem::ISO_FILE;
-                    gi.label = name;
-                    gi.path  = joinDirFile(base, name.c_str());
-                    SceIoStat st;
-                    if (getStat(gi.path, st)){
-                        gi.time     = st.sce_st_mtime;
-                        gi.sortKey  = buildLegacySortKey(gi.time);
-                        gi.sizeBytes= (uint64_t)st.st_size;   // <--- NEW
-                    }
+                known = FolderSizeLookup(path, ce.mtimeKey, ce.bytes);
+            }
+            {
+                PhaseTimer pt(SP_Title);
+                readFolderTitle(*fs, ce.title, &ce.discId);
+            }
+            gi.sizeBytes = ce.bytes;
+            gi.sizeKnown = known;
+        }
+        gi.setTitle(ce.title);
+        catalogFor(path).store(path, ce);
+    }
 
-                    if (endsWithNoCase(name, ".iso")) {
-                        std::string t; if (readIsoTitle(gi.path, t)) gi.title = t;
-                    } else if (endsWithNoCase(name, ".cso") || endsWithNoCase(name, ".zso")) {
-                        std::string t; if (readCompressedIsoTitle(gi.path, t)) gi.title = t;
-                    } else if (endsWithNoCase(name, ".dax")) {
-                        std::string t; if (readDaxTitle(gi.path, t)) gi.title = t;
-                    } else if (endsWithNoCase(name, ".jso")) {
-                        std::string t; if (readJsoTitle(gi.path, t)) gi.title = t;
-                    }
+    // Discovery; title/size come from the catalog or resolveDetails() (the
+    // scan defers the latter to the title filler).
+    // st: the entry's stat from the parent's readdir (saves a getstat), or nullptr.
+    bool discoverIsoItem(const std::string& dir, const std::string& fn, const SceIoStat* st,
+                         GameItem& gi, uint64_t& keySize) {
+        if (!isIsoLike(fn)) return false;
+        gi.kind  = GameItem::ISO_FILE;
+        const std::string path = joinDirFile(dir, fn.c_str());
+        gi.setPath(path);
+        SceIoStat own;
+        if (!st && getStat(path, own)) st = &own;
+        if (st){
+            gi.timeKey  = packDateTime(st->sce_st_mtime);
+            gi.sizeBytes= (uint64_t)st->st_size;
+        }
+        keySize = gi.sizeBytes;
+        return true;
+    }
 
-                    uncategorized.push_back(gi);
-                }
-            }
-        });
+    // One readdir of the folder (FolderScan) replaces dirExists + EBOOT lookup;
+    // fs is kept for resolveDetails().
+    bool discoverEbootItem(const std::string& dir, const std::string& name, const SceIoStat* st,
+                           GameItem& gi, uint64_t& keySize, FolderScan& fs) {
+        std::string folderNoSlash = joinDirFile(dir, name.c_str());
+        if (!scanFolderOnce(folderNoSlash, fs) || fs.eboot.empty()) return false;
+        gi.kind  = GameItem::EBOOT_FOLDER;
+        gi.setPath(folderNoSlash);
+        SceIoStat own{};
+        if (!st && getStatDirNoSlash(folderNoSlash, own)) st = &own;
+        if (st) gi.timeKey = packDateTime(st->sce_st_mtime);
+        keySize = (uint64_t)fs.ebootSt.st_size;
+        return true;
     }
 
-    void scanGameRootDir(const std::string& base){
-        if (!dirExists(base)) return;
-        forEachEntry(base, [&](const SceIoDirent &e){
-            if (!FIO_S_ISDIR(e.d_stat.st_mode)) return;
-            std::string name = e.d_name;
-            if (startsWithCAT(name.c_str())){
-                hasCategories = true;
-                std::string catDir = base + name;
-                forEachEntry(catDir, [&](const SceIoDirent &sub){
-                    if (FIO_S_ISDIR(sub.d_stat.st_mode)){
-                        std::string title = sub.d_name;
-                        std::string folderNoSlash = joinDirFile(catDir, title.c_str());
-                        if (dirExists(folderNoSlash)){
-                            if (!findEbootCaseInsensitive(folderNoSlash).empty()){
-                                GameItem gi; gi.kind = GameItem::EBOOT_FOLDER;
-                                gi.label = title;
-                                gi.path  = folderNoSlash;
-                                SceIoStat stF{};
-                                if (getStatDirNoSlash(gi.path, stF)) {
-                                    gi.time     = stF.sce_st_mtime;
-                                    gi.sortKey  = buildLegacySortKey(gi.time);
-                                }
-                                // Optional: compute folder size for display (can be O(total files))
-                                uint64_t folderBytes = 0;
-                                sumDirBytes(gi.path, folderBytes);
-                                gi.sizeBytes = folderBytes;    // <--- NEW
-
-                                std::string t; if (getFolderTitle(gi.path, t)) gi.title = t;
-                                categories[name].push_back(gi);
-
-                            }
-                        }
-                    }
-                });
-            } else {
-                std::string folderNoSlash = joinDirFile(base, name.c_str());
-                if (dirExists(folderNoSlash)){
-                    if (!findEbootCaseInsensitive(folderNoSlash).empty()){
-                        GameItem gi; gi.kind = GameItem::EBOOT_FOLDER;
-                        gi.label = name;
-                        gi.path  = folderNoSlash;
-                        SceIoStat stF{};
-                        if (getStatDirNoSlash(gi.path, stF)) {
-                            gi.time     = stF.sce_st_mtime;
-                            gi.sortKey  = buildLegacySortKey(gi.time);
-                        }
-                        // Optional: compute folder size
-                        uint64_t folderBytes = 0;
-                        sumDirBytes(gi.path, folderBytes);
-                        gi.sizeBytes = folderBytes;
+    bool makeIsoItem(const std::string& dir, const std::string& fn, GameItem& gi, const SceIoStat* st = nullptr) {
+        uint64_t keySize = 0;
+        if (!discoverIsoItem(dir, fn, st, gi, keySize)) return false;
+        if (!lookupCatalog(gi, keySize)) resolveDetails(gi, keySize);
+        return true;
+    }
 
-                        std::string t; if (getFolderTitle(gi.path, t)) gi.title = t;
-                        uncategorized.push_back(gi);  // <--- FIX: do NOT create a category
-                    }
-                }
-            }
-        });
+    bool makeEbootItem(const std::string& dir, const std::string& name, GameItem& gi, const SceIoStat* st = nullptr) {
+        uint64_t keySize = 0;
+        FolderScan fs;
+        if (!discoverEbootItem(dir, name, st, gi, keySize, fs)) return false;
+        if (!lookupCatalog(gi, keySize)) resolveDetails(gi, keySize, &fs);
+        return true;
     }
 
-    void scanDevice(const std::string& dev){
-        resetLists();
+    // -----------------------------------------------------------
+    // Device scan. runScan() walks the roots in three passes and reports
+    // through a ScanSink: (1) top level of every root, so all categories are
+    // known before any item arrives; (2) items, titled from the catalog where
+    // it has them; catalog misses go out under their names with titlePending
+    // set and are titled later by the TitleFiller. scanDevice() runs it
+    // inline, the background scanner on its own thread.
+    // Category contents are walked in the order the UI asks for them
+    // (wanted()): the category just opened first, then the one it expects
+    // next, the rest afterwards.
+    // -----------------------------------------------------------
+    struct ScanSink {
+        virtual ~ScanSink() {}
+        virtual void category(const std::string& cat) = 0;
+        virtual void layout() = 0;   // all categories reported
+        virtual bool wanted(std::string&) { return false; }   // next category the UI asked for
+        virtual void item(const std::string& cat, const GameItem& gi) = 0;
+    };
 
-        const char* isoRoots[]  = {"ISO/","ISO/PSP/"};
-        const char* gameRoots[] = {"PSP/GAME/","PSP/GAME/PSX/","PSP/GAME/Utility/","PSP/GAME150/"};
+    // -----------------------------------------------------------
+    // Deferred titles. Decoding a title (inflate / LZ4 through the disc
+    // reader, or an EBOOT's PARAM.SFO) is the slow part of a catalog miss,
+    // and titles are only on screen in label mode, so the scan leaves it to
+    // these workers (gTitleWorkers threads, each with its own reader
+    // context). Rows on screen are queued at the front, the background fill
+    // at the back; results go back to the UI thread by path (pumpTitles()).
+    // -----------------------------------------------------------
+    struct TitleFiller {
+        KernelFileExplorer* owner = nullptr;
+        SceUID threads[TITLE_WORKERS_MAX];
+        int    nThreads = 0;
+        SceUID lock   = -1;                  // guards everything below
+        SceUID wake   = -1;                  // counts queued requests
+        std::deque<GameItem> queue;
+        std::unordered_set<uint64_t> pending; // pathKey()s queued or being resolved, until taken
+        std::vector<GameItem> done;
+        int    busy    = 0;                  // items being resolved
+        int    saveReq = 0;
+
+        void resolve(GameItem& gi) {
+            if (gi.kind == GameItem::ISO_FILE) { owner->resolveDetails(gi, gi.sizeBytes); return; }
+            FolderScan fs;
+            if (scanFolderOnce(gi.path(), fs) && !fs.eboot.empty())   // else gone: keeps its name
+                owner->resolveDetails(gi, (uint64_t)fs.ebootSt.st_size, &fs);
+        }
 
-        for (size_t i=0;i<sizeof(isoRoots)/sizeof(isoRoots[0]);++i)  scanIsoRootDir(dev + std::string(isoRoots[i]));
-        for (size_t i=0;i<sizeof(gameRoots)/sizeof(gameRoots[0]);++i) scanGameRootDir(dev + std::string(gameRoots[i]));
+        static int Entry(SceSize, void* argp) {
+            TitleFiller* f = *(TitleFiller**)argp;
+            while (sceKernelWaitSema(f->wake, 1, nullptr) >= 0) {
+                GameItem gi;
+                sceKernelWaitSema(f->lock, 1, nullptr);
+                const bool have = !f->queue.empty();
+                if (have) { gi = f->queue.front(); f->queue.pop_front(); ++f->busy; }
+                bool save = false;      // the fill is complete: keep its titles for the next start
+                if (!have && f->saveReq && f->busy == 0) { f->saveReq = 0; save = true; }
+                sceKernelSignalSema(f->lock, 1);
+                if (!have) {
+                    if (save) for (auto& c : f->owner->catalogs) c.save();
+                    continue;
+                }
+                f->resolve(gi);
+                sceKernelWaitSema(f->lock, 1, nullptr);
+                f->done.push_back(gi);
+                --f->busy;
+                sceKernelSignalSema(f->lock, 1);
+            }
+            return 0;
+        }
 
-        if (!categories.empty()) hasCategories = true;
+        void start(KernelFileExplorer* o) {
+            owner = o;
+            lock = sceKernelCreateSema("KFE_TitleLock", 0, 1, 1, nullptr);
+            wake = sceKernelCreateSema("KFE_TitleWake", 0, 0, 0x7FFFFFFF, nullptr);
+            if (lock < 0 || wake < 0) return;   // inline fallback
+            TitleFiller* self = this;
+            for (int i = 0; i < gTitleWorkers && i < TITLE_WORKERS_MAX; ++i) {
+                SceUID th = sceKernelCreateThread("KFE_TitleWorker", Entry, 0x31 /* between scanner and size worker */,
+                                                  0x8000, 0, nullptr);
+                if (th < 0) break;
+                sceKernelStartThread(th, sizeof(self), &self);
+                threads[nThreads++] = th;
+            }
+        }
 
-        if (!hasCategories){
-            flatAll = uncategorized;
-        } else {
-            for (auto &kv : categories) categoryNames.push_back(kv.first);
-            std::sort(categoryNames.begin(), categoryNames.end(),
-                      [](const std::string& a, const std::string& b){ return strcasecmp(a.c_str(), b.c_str()) < 0; });
-            if (!uncategorized.empty()) categories["Uncategorized"]; // flag presence
+        // No-op while gi is already queued or its result not yet taken.
+        // Resolves inline if no worker could be started.
+        void request(const GameItem& gi, bool front) {
+            if (nThreads == 0) {
+                if (!pending.insert(gi.pathKey()).second) return;
+                GameItem r = gi; resolve(r); done.push_back(r);
+                return;
+            }
+            sceKernelWaitSema(lock, 1, nullptr);
+            const bool added = pending.insert(gi.pathKey()).second;
+            if (added) { if (front) queue.push_front(gi); else queue.push_back(gi); }
+            sceKernelSignalSema(lock, 1);
+            if (added) sceKernelSignalSema(wake, 1);
         }
-    }
 
-    void clearUI(){
-        rowFreeBytes.clear();
-        rowReason.clear();      // <--- add
-        rowNeedBytes.clear();   // <--- add
-        entries.clear(); entryPaths.clear(); entryKinds.clear();
-        rowFlags.clear(); rowFreeBytes.clear();
-        selectedIndex=0; scrollOffset=0;
-        freeSelectionIcon();
-    }
+        void takeDone(std::vector<GameItem>& out) {
+            out.clear();
+            if (lock >= 0) sceKernelWaitSema(lock, 1, nullptr);
+            out.swap(done);
+            for (auto& r : out) pending.erase(r.pathKey());
+            if (lock >= 0) sceKernelSignalSema(lock, 1);
+        }
 
+        bool idle() {
+            if (lock >= 0) sceKernelWaitSema(lock, 1, nullptr);
+            const bool none = pending.empty();
+            if (lock >= 0) sceKernelSignalSema(lock, 1);
+            return none;
+        }
 
-    void refillRowsFromWorkingPreserveSel(){
-        int oldSel = selectedIndex, oldScroll = scrollOffset;
-        entries.clear(); entryPaths.clear(); entryKinds.clear();
-        for (const auto& gi : workingList){
-            SceIoDirent e; memset(&e,0,sizeof(e));
-            const char* name = (showTitles && !gi.title.empty()) ? gi.title.c_str() : gi.label.c_str();
-            strncpy(e.d_name, name, sizeof(e.d_name)-1);
-            entries.push_back(e);
-            entryPaths.push_back(gi.path);
-            entryKinds.push_back(gi.kind);
-        }
-        if (entries.empty()) { selectedIndex = 0; scrollOffset = 0; }
-        else {
-            if (oldSel >= (int)entries.size()) oldSel = (int)entries.size()-1;
-            if (oldSel < 0) oldSel = 0;
-            selectedIndex = oldSel;
-            int maxScroll = (int)entries.size() - MAX_DISPLAY;
-            if (maxScroll < 0) maxScroll = 0;
-            if (oldScroll > maxScroll) oldScroll = maxScroll;
-            if (oldScroll < 0) oldScroll = 0;
-            scrollOffset = oldScroll;
+        void saveWhenIdle() {
+            if (nThreads == 0) { for (auto& c : owner->catalogs) c.save(); return; }
+            sceKernelWaitSema(lock, 1, nullptr);
+            saveReq = 1;
+            sceKernelSignalSema(lock, 1);
+            sceKernelSignalSema(wake, 1);
         }
-        showRoots = false;
-        freeSelectionIcon();
-    }
+    };
 
-    void buildRootRows(){
-        clearUI();
-        int preselect = -1;
-        const uint64_t HEADROOM = (4ull << 20); // keep ~4 MiB headroom
+    void runScan(const std::string& dev, ScanSink& sink, volatile int* cancel) {
+        const unsigned long long t0 = nowUS();
+        gIoCalls = IoCallStats{0, 0, 0, 0};
+        memset(&gScanPhases, 0, sizeof(gScanPhases));
+        ScanCatalog& catalog = catalogFor(dev);
+        catalog.beginScan();
 
-        for (auto &r : roots){
-            SceIoDirent e{}; strncpy(e.d_name, r.c_str(), sizeof(e.d_name)-1);
-            e.d_stat.st_mode = FIO_S_IFDIR;
-            entries.push_back(e);
-            entryPaths.emplace_back("");
-            entryKinds.push_back(GameItem::ISO_FILE);
+        struct Cand    { std::string cat, dir, name; bool iso; SceIoStat st; };
+        std::vector<Cand> cands, catDirs;
+        auto stopped = [&]{ return cancel && *cancel; };
 
-            uint8_t flags = 0;
-            RowDisableReason reason = RD_NONE;
-            uint64_t needB = 0, freeB = 0;
+        const char* isoRoots[]  = {"ISO/","ISO/PSP/"};
+        const char* gameRoots[] = {"PSP/GAME/","PSP/GAME/PSX/","PSP/GAME/Utility/","PSP/GAME150/"};
 
-            needB = 0;
-            // Existing rule: running from ef0 → ms0 disabled
+        for (auto r : isoRoots) {
+            std::string base = dev + r;
+            forEachEntry(base, [&](const SceIoDirent &e){
+                std::string name = e.d_name;
+                if (!FIO_S_ISDIR(e.d_stat.st_mode)) { cands.push_back({"", base, name, true, e.d_stat}); return; }
+                if (!startsWithCAT(name.c_str())) return;
+                sink.category(name);
+                catDirs.push_back({name, base + name, "", true, e.d_stat});
+            });
+        }
+        for (auto r : gameRoots) {
+            std::string base = dev + r;
+            forEachEntry(base, [&](const SceIoDirent &e){
+                if (!FIO_S_ISDIR(e.d_stat.st_mode)) return;
+                std::string name = e.d_name;
+                if (!startsWithCAT(name.c_str())) { cands.push_back({"", base, name, false, e.d_stat}); return; }  // do NOT create a category
+                sink.category(name);
+                catDirs.push_back({name, base + name, "", false, e.d_stat});
+            });
+        }
+        sink.layout();
+
+        uint32_t seq = 0;
+        unsigned deferred = 0;
+        auto emit = [&](const Cand& c, const std::string& dir, const std::string& name, const SceIoStat& st){
+            GameItem gi; uint64_t keySize = 0; FolderScan fs;
+            bool ok = c.iso ? discoverIsoItem(dir, name, &st, gi, keySize)
+                            : discoverEbootItem(dir, name, &st, gi, keySize, fs);
+            if (!ok) return;
+            if (!lookupCatalog(gi, keySize)) {
+                gi.titlePending = true;
+                ++deferred;
+                // A flat folder's size is free from the readdir just done.
+                if (gi.kind == GameItem::EBOOT_FOLDER && fs.subdirs.empty()) { gi.sizeBytes = fs.topBytes; gi.sizeKnown = true; }
+            }
+            sink.item(c.cat, gi);
+            ++seq;
+        };
+        std::vector<uint8_t> walked(catDirs.size(), 0);
+        auto walkCatDir = [&](size_t i){
+            const Cand& c = catDirs[i];
+            walked[i] = 1;
+            forEachEntry(c.dir, [&](const SceIoDirent &e){
+                if (stopped()) return;
+                if (c.iso == !!FIO_S_ISDIR(e.d_stat.st_mode)) return;  // ISO: files, GAME: folders
+                emit(c, c.dir, e.d_name, e.d_stat);
+            });
+        };
+        // A category can span several roots (ISO/CAT_x and PSP/GAME/CAT_x).
+        auto serveWanted = [&]{
+            std::string want;
+            while (!stopped() && sink.wanted(want))
+                for (size_t i = 0; i < catDirs.size(); ++i)
+                    if (!walked[i] && catDirs[i].cat == want) walkCatDir(i);
+        };
+        for (auto& c : cands) {
+            if (stopped()) break;
+            serveWanted();
+            emit(c, c.dir, c.name, c.st);
+        }
+        for (size_t i = 0; i < catDirs.size(); ++i) {
+            if (stopped()) break;
+            serveWanted();
+            if (!walked[i]) walkCatDir(i);
+        }
+
+        if (!stopped()) catalog.pruneUnseen();
+        catalog.save();
+        const unsigned long long t1 = nowUS();
+        logfOnce("scanDevice: %s %llu ms, %u item(s), %u title(s) deferred (catalog hit=%u miss=%u)%s", dev.c_str(),
+                 (t1 - t0) / 1000ULL, (unsigned)seq, deferred,
+                 catalog.hits(), catalog.misses(), stopped() ? " [cancelled]" : "");
+        logfOnce("scanDevice: %llu items/s", (t1 > t0) ? (unsigned long long)seq * 1000000ULL / (t1 - t0) : 0ULL);
+        logfOnce("scanDevice: io dopen=%u dread=%u getstat=%u open=%u", gIoCalls.dopen,
+                 gIoCalls.dread, gIoCalls.getstat, gIoCalls.open);
+        {
+            // Heap per item: everything in use (lists, pool, catalogs, fonts...) over this
+            // scan's items, so an upper bound; compare runs, not absolute numbers.
+            const struct mallinfo mi = mallinfo();
+            const unsigned items = seq ? seq : 1;
+            logfOnce("scanDevice: heap %u KB in use, %u B/item; item record %u B, strings %u (%u KB)",
+                     (unsigned)mi.uordblks / 1024u, (unsigned)mi.uordblks / items, (unsigned)sizeof(GameItem),
+                     gStrings.count(), (unsigned)(gStrings.bytes() / 1024u));
+        }
+#if SCAN_PROFILE
+        const ScanPhaseStats& ps = gScanPhases;
+        logfOnce("scanDevice: phases readdir %llu ms/%u, stat %llu ms/%u, title %llu ms/%u, size walk %llu ms/%u",
+                 ps.us[SP_Readdir] / 1000ULL, ps.n[SP_Readdir], ps.us[SP_Stat] / 1000ULL, ps.n[SP_Stat],
+                 ps.us[SP_Title] / 1000ULL, ps.n[SP_Title], ps.us[SP_SizeWalk] / 1000ULL, ps.n[SP_SizeWalk]);
+#endif
+    }
+
+    // Scan results → lists.
+    void applyScanCategory(const std::string& cat) {
+        hasCategories = true;
+        categories[cat];
+    }
+    uint32_t applyScanItem(const std::string& cat, const GameItem& gi) {
+        const uint32_t idx = addItem(gi);
+        indexItem(idx);
+        listForCategory(cat).push_back(idx);
+        countInIndex(cat.empty() ? std::string("Uncategorized") : cat, gi);
+        return idx;
+    }
+
+    struct DirectScanSink : ScanSink {
+        KernelFileExplorer* self;
+        explicit DirectScanSink(KernelFileExplorer* s) : self(s) {}
+        void category(const std::string& cat) override { self->applyScanCategory(cat); }
+        void layout() override {}
+        void item(const std::string& cat, const GameItem& gi) override { self->applyScanItem(cat, gi); }
+    };
+
+    void scanDevice(const std::string& dev){
+        cancelScan();
+        activateLists(dev);
+        resetLists();
+        listsComplete = false;
+        DirectScanSink sink(this);
+        runScan(dev, sink, nullptr);
+        syncDerivedLists();
+        listsComplete = true;
+    }
+
+    // -----------------------------------------------------------
+    // Background scanner: openDevice() starts it and shows the lists as they
+    // fill; pumpScan() drains its queue once per frame on the UI thread.
+    // The worker runs below the main thread's priority, so it only gets the
+    // CPU while the UI waits for vblank or I/O. One scan at a time: when the
+    // device on screen is done, the other device (PSP Go) is scanned into its
+    // parked lists (a "prefetch"); opening that device adopts the scan as is.
+    // -----------------------------------------------------------
+    struct ScanMsg {
+        enum Type { M_Category, M_Layout, M_Item, M_Done } type;
+        std::string cat;    // M_Category / M_Item
+        GameItem    item;   // M_Item
+    };
+    SceUID scanThread = -1;
+    SceUID scanLock   = -1;          // guards scanQueue
+    std::vector<ScanMsg> scanQueue;
+    std::string scanDev;
+    volatile int scanCancel = 0;
+    std::vector<std::string> scanWant;   // categories to walk next (guarded by scanLock), oldest first
+    std::string scanWantLast;
+    // Warm start: the scan revalidates lists rebuilt from the catalog; its
+    // results are collected here and patched in when it is done.
+    bool scanRevalidate = false;
+    std::vector<std::string> revalCats;
+    std::vector<std::pair<std::string, GameItem>> revalItems;   // (category, item)
+    bool scanLayoutKnown = false;
+    unsigned scanItemsSeen = 0;
+
+    struct QueueScanSink : ScanSink {
+        KernelFileExplorer* self;
+        explicit QueueScanSink(KernelFileExplorer* s) : self(s) {}
+        void post(ScanMsg& m) {
+            sceKernelWaitSema(self->scanLock, 1, nullptr);
+            self->scanQueue.push_back(std::move(m));
+            sceKernelSignalSema(self->scanLock, 1);
+        }
+        void category(const std::string& cat) override { ScanMsg m{ScanMsg::M_Category, cat, GameItem()}; post(m); }
+        void layout() override { ScanMsg m{ScanMsg::M_Layout, "", GameItem()}; post(m); }
+        bool wanted(std::string& cat) override {
+            sceKernelWaitSema(self->scanLock, 1, nullptr);
+            const bool any = !self->scanWant.empty();
+            if (any) { cat.swap(self->scanWant.front()); self->scanWant.erase(self->scanWant.begin()); }
+            sceKernelSignalSema(self->scanLock, 1);
+            return any;
+        }
+        void item(const std::string& cat, const GameItem& gi) override {
+            ScanMsg m{ScanMsg::M_Item, cat, gi}; post(m);
+        }
+    };
+
+    static int ScanThreadEntry(SceSize, void* argp) {
+        KernelFileExplorer* self = *(KernelFileExplorer**)argp;
+        QueueScanSink sink(self);
+        self->runScan(self->scanDev, sink, &self->scanCancel);
+        ScanMsg m{ScanMsg::M_Done, "", GameItem()};
+        sink.post(m);
+        return 0;
+    }
+
+    bool scanActive() const { return scanThread >= 0; }
+    bool scanInForeground() const { return scanActive() && scanDev == scannedDevice; }
+    bool prefetchDisabled = false;   // the scanner thread could not be created, or the heap is tight
+
+    // Heap shrinker (UI thread): drop other devices' parked lists, except one a
+    // background scan is filling; they are rescanned on the next visit.
+    static void dropParkedLists(void* ctx) {
+        KernelFileExplorer* self = (KernelFileExplorer*)ctx;
+        for (auto it = self->resident.begin(); it != self->resident.end(); ) {
+            if (self->scanActive() && it->first == self->scanDev) ++it;
+            else it = self->resident.erase(it);
+        }
+        self->prefetchDisabled = true;   // don't refill them right away
+        logf("heap: dropped parked device lists");
+    }
+
+    bool beginScanThread(const std::string& dev) {
+        scanLayoutKnown = false;
+        scanItemsSeen = 0;
+        scanWant.clear();
+        scanWantLast.clear();
+        scanRevalidate = false;
+        revalCats.clear(); revalItems.clear();
+
+        if (scanLock < 0) scanLock = sceKernelCreateSema("KFE_ScanLock", 0, 1, 1, nullptr);
+        scanDev = dev;
+        scanCancel = 0;
+        scanThread = (scanLock >= 0)
+            ? sceKernelCreateThread("KFE_Scanner", ScanThreadEntry, 0x30 /* below main */, 0x10000, 0, nullptr)
+            : -1;
+        if (scanThread < 0) return false;
+        KernelFileExplorer* self = this;
+        sceKernelStartThread(scanThread, sizeof(self), &self);
+        return true;
+    }
+
+    void startScan(const std::string& dev) {
+        cancelScan();
+        activateLists(dev);
+        resetLists();
+        listsComplete = false;
+        if (!beginScanThread(dev)) {    // no thread → old blocking behaviour
+            scanDevice(dev);
+            scanLayoutKnown = true;
+        }
+    }
+
+    // Scan dev into its parked lists while another device is on screen.
+    void startPrefetch(const std::string& dev) {
+        resident[dev] = DeviceLists();
+        if (!beginScanThread(dev)) { resident.erase(dev); prefetchDisabled = true; }
+    }
+
+    // Once the device on screen is fully scanned, scan the other one, but
+    // never while a Move/Copy or a dialog is in progress.
+    void maybePrefetchOtherDevice() {
+        if (scanActive() || prefetchDisabled || !listsComplete || scannedDevice.empty()) return;
+        if (actionMode != AM_None || msgBox || fileMenu || !dualDeviceAvailableFromMs0()) return;
+        for (auto& r : roots) {
+            if (r == scannedDevice) continue;
+            auto it = resident.find(r);
+            if (it != resident.end() && it->second.complete) continue;
+            startPrefetch(r);
+            return;
+        }
+    }
+
+    void joinScanThread() {
+        sceKernelWaitThreadEnd(scanThread, nullptr);
+        sceKernelDeleteThread(scanThread);
+        scanThread = -1;
+        sceKernelWaitSema(scanLock, 1, nullptr);
+        scanQueue.clear();
+        sceKernelSignalSema(scanLock, 1);
+    }
+
+    // Abandon a running scan. The lists stay partial: opening the device
+    // again starts over; a dropped prefetch is retried when idle.
+    void cancelScan() {
+        if (!scanActive()) return;
+        const bool fg = scanInForeground();
+        scanCancel = 1;
+        joinScanThread();
+        scanRevalidate = false;
+        revalCats.clear(); revalItems.clear();
+        if (fg) scannedDevice.clear();
+        else    resident.erase(scanDev);
+    }
+
+    // Block (while still drawing) until the running scan is complete; used
+    // before anything that mutates files or needs the full lists. A prefetch
+    // of the other device is left running unless withPrefetch is set (only
+    // Move/Copy touch the other device).
+    void finishScan(bool withPrefetch = false) {
+        if (!scanActive() || (!withPrefetch && !scanInForeground())) return;
+        MessageBox* prev = msgBox;
+        msgBox = new MessageBox("Finishing scan...", nullptr, SCREEN_WIDTH, SCREEN_HEIGHT, 1.0f, 0, "", 16, 18, 8, 14);
+        while (scanActive()) {
+            pumpScan();
+            if (scanActive()) renderOneFrame();
+        }
+        delete msgBox; msgBox = prev;
+    }
+
+    // Ask the foreground scan to walk cat's folders next (no-op once walked,
+    // or when the scan is not for the device on screen).
+    void wantCategory(const std::string& cat) {
+        if (!scanInForeground() || cat.empty() || cat == "Uncategorized" || cat == scanWantLast) return;
+        scanWantLast = cat;
+        sceKernelWaitSema(scanLock, 1, nullptr);
+        scanWant.push_back(cat);
+        sceKernelSignalSema(scanLock, 1);
+    }
+
+    bool scanItemInView(const std::string& cat) const {
+        if (showRoots) return false;
+        if (view == View_AllFlat) return cat.empty();
+        if (view == View_CategoryContents)
+            return currentCategory == (cat.empty() ? std::string("Uncategorized") : cat);
+        return false;
+    }
+
+    // Streamed rows keep the newest-first order only while workingList is
+    // still in it; after SELECT A-Z or a manual reorder they go to the end.
+    bool workingInTimeOrder() const {
+        return std::is_sorted(workingList.begin(), workingList.end(),
+            [this](uint32_t a, uint32_t b){ return arena[a].timeKey > arena[b].timeKey; });
+    }
+    void insertWorkingRow(uint32_t id, bool byTime) {
+        if (!byTime) { workingList.push_back(id); return; }
+        auto pos = std::upper_bound(workingList.begin(), workingList.end(), arena[id].timeKey,
+            [this](uint64_t k, uint32_t b){ return k > arena[b].timeKey; });
+        workingList.insert(pos, id);
+    }
+
+    void pumpScan() {
+        if (!scanActive()) { maybePrefetchOtherDevice(); return; }
+        if (!showRoots && view == View_Categories && selectedIndex >= 0 && selectedIndex < rowCount())
+            wantCategory(dirRows[selectedIndex]);   // the highlighted one is the likely next open
+        std::vector<ScanMsg> batch;
+        sceKernelWaitSema(scanLock, 1, nullptr);
+        batch.swap(scanQueue);
+        sceKernelSignalSema(scanLock, 1);
+        if (batch.empty()) return;
+        if (scanRevalidate) { pumpRevalidate(batch); return; }
+        if (!scanInForeground()) { pumpPrefetch(batch); return; }
+
+        bool layout = false, done = false, catsChanged = false, rowsChanged = false;
+        int byTime = -1;   // workingList order, checked on the first streamed row
+        std::string keepPath;
+        if (selectedIndex >= 0 && selectedIndex < (int)workingList.size())
+            keepPath = row(selectedIndex).path();
+
+        for (auto& m : batch) {
+            switch (m.type) {
+            case ScanMsg::M_Category: applyScanCategory(m.cat); break;
+            case ScanMsg::M_Layout:   layout = true; break;
+            case ScanMsg::M_Item: {
+                if (m.cat.empty() && uncategorized.empty()) catsChanged = true;   // "Uncategorized" row appears
+                const uint32_t idx = applyScanItem(m.cat, m.item);
+                ++scanItemsSeen;
+                if (scanLayoutKnown && scanItemInView(m.cat)) {
+                    if (byTime < 0) byTime = workingInTimeOrder() ? 1 : 0;
+                    insertWorkingRow(idx, byTime != 0);
+                    rowsChanged = true;
+                }
+                break;
+            }
+            case ScanMsg::M_Done: done = true; break;
+            }
+        }
+
+        if (done) {
+            joinScanThread();
+            syncDerivedLists();           // drops categories that stayed empty
+            listsComplete = true;
+            catsChanged = true;
+        } else if (layout || catsChanged) {
+            // Keep every discovered category visible while the scan is running.
+            categoryNames.clear();
+            for (auto &kv : categories) if (kv.first != "Uncategorized") categoryNames.push_back(kv.first);
+            std::sort(categoryNames.begin(), categoryNames.end(),
+                      [](const std::string& a, const std::string& b){ return strcasecmp(a.c_str(), b.c_str()) < 0; });
+            if (!uncategorized.empty()) categories["Uncategorized"]; // flag presence
+        }
+
+        if (layout) {
+            scanLayoutKnown = true;
+            if (!showRoots) showDeviceLists();
+            return;
+        }
+        if (!scanLayoutKnown || showRoots) return;
+        if (view == View_Categories && catsChanged) {
+            std::string keepName;
+            if (selectedIndex >= 0 && selectedIndex < rowCount()) keepName = dirRows[selectedIndex];
+            int oldScroll = scrollOffset;
+            buildCategoryRows();
+            for (int i = 0; i < rowCount(); ++i) {
+                if (keepName != dirRows[i]) continue;
+                clampSelection(i, oldScroll);
+                break;
+            }
+        } else if (rowsChanged && (view == View_AllFlat || view == View_CategoryContents)) {
+            refillRowsFromWorkingPreserveSel();
+            selectByPath(keepPath);
+        }
+    }
+
+    // Prefetch results go straight into the parked lists; nothing on screen changes.
+    void pumpPrefetch(std::vector<ScanMsg>& batch) {
+        bool done = false;
+        withParkedLists(scanDev, [&]{
+            for (auto& m : batch) {
+                switch (m.type) {
+                case ScanMsg::M_Category: applyScanCategory(m.cat); break;
+                case ScanMsg::M_Layout:   scanLayoutKnown = true; break;
+                case ScanMsg::M_Item:     applyScanItem(m.cat, m.item); ++scanItemsSeen; break;
+                case ScanMsg::M_Done:     done = true; break;
+                }
+            }
+            if (done) { syncDerivedLists(); listsComplete = true; }
+        });
+        if (done) joinScanThread();
+    }
+
+    // -----------------------------------------------------------
+    // Warm start. restoreSession() rebuilds the last session's device lists
+    // from its catalog and puts back the view, category, row order,
+    // selection and scroll, so a list is usable before any directory is
+    // read. A background scan then revalidates: when it is done,
+    // reconcileScan() patches the lists in place (items that are still
+    // there keep their ID, checkmark and position).
+    // -----------------------------------------------------------
+    bool warmStart = false;
+    unsigned long long revalStartUS = 0;
+
+    void saveSession() {
+        if (showRoots || currentDevice.empty() || actionMode != AM_None) { sessionClear(); return; }
+        SessionSnapshot ss;
+        ss.device     = currentDevice;
+        ss.view       = (uint8_t)view;
+        ss.showTitles = showTitles;
+        ss.category   = (view == View_AllFlat) ? std::string() : currentCategory;
+        ss.selected   = selectedIndex;
+        ss.scroll     = scrollOffset;
+        if (itemView()) {
+            ss.rows.reserve(workingList.size());
+            for (uint32_t id : workingList) ss.rows.push_back(arena[id].path());
+        }
+        sessionSave(ss);
+    }
+
+    bool restoreSession() {
+        SessionSnapshot ss;
+        if (!sessionLoad(ss)) return false;
+        if (std::find(roots.begin(), roots.end(), ss.device) == roots.end()) return false;
+        const unsigned long long t0 = nowUS();
+
+        currentDevice = ss.device;
+        activateLists(ss.device);
+        resetLists();
+        catalogFor(ss.device).forEach([this](const std::string& path, const CatalogEntry& ce){
+            GameItem gi;
+            gi.kind      = (GameItem::Kind)ce.kind;
+            gi.setPath(path);
+            gi.timeKey   = ce.mtimeKey;
+            gi.sizeBytes = ce.bytes;
+            gi.setTitle(ce.title);
+            if (gi.kind == GameItem::ISO_FILE) discRememberParams(path, ce.params);
+            applyScanItem(categoryKeyFor(path, gi.kind), gi);
+        });
+        if (arena.empty()) { resetLists(); scannedDevice.clear(); return false; }
+        syncDerivedLists();
+        listsComplete = false;
+
+        showTitles = ss.showTitles;
+        currentCategory = ss.category;
+        showDeviceLists();
+        if (ss.view == View_CategoryContents && hasCategories &&
+            (ss.category == "Uncategorized" || categories.count(ss.category)))
+            openCategory(ss.category);
+        if (itemView() && !ss.rows.empty()) {
+            // Saved row order first (it may be an unsaved A-Z or a reorder), the rest by time.
+            std::unordered_map<uint64_t, uint32_t> pos;
+            for (uint32_t i = 0; i < ss.rows.size(); ++i) {
+                const uint64_t key = GameItem::pathKeyOf(ss.rows[i]);
+                if (key) pos.emplace(key, i);
+            }
+            auto rank = [&](uint32_t id){
+                auto it = pos.find(arena[id].pathKey());
+                return (it == pos.end()) ? UINT32_MAX : it->second;
+            };
+            std::stable_sort(workingList.begin(), workingList.end(),
+                             [&](uint32_t a, uint32_t b){ return rank(a) < rank(b); });
+        }
+        clampSelection(ss.selected, ss.scroll);
+
+        logfOnce("session: %s restored from the catalog, %u item(s) in %llu ms", ss.device.c_str(),
+                 (unsigned)arena.size(), (nowUS() - t0) / 1000ULL);
+        warmStart = true;
+        startRevalidation(ss.device);
+        return true;
+    }
+
+    void startRevalidation(const std::string& dev) {
+        revalStartUS = nowUS();
+        if (!beginScanThread(dev)) {   // no thread: the usual blocking scan
+            scanDevice(dev);
+            scanLayoutKnown = true;
+            showDeviceLists();
+            return;
+        }
+        scanRevalidate  = true;
+        scanLayoutKnown = true;        // the lists are laid out already
+    }
+
+    void pumpRevalidate(std::vector<ScanMsg>& batch) {
+        bool done = false;
+        for (auto& m : batch) {
+            switch (m.type) {
+            case ScanMsg::M_Category: revalCats.push_back(m.cat); break;
+            case ScanMsg::M_Item:     revalItems.emplace_back(m.cat, m.item); ++scanItemsSeen; break;
+            case ScanMsg::M_Done:     done = true; break;
+            default: break;
+            }
+        }
+        if (!done) return;
+        const bool fg = scanInForeground();
+        joinScanThread();
+        scanRevalidate = false;
+        if (fg) reconcileOnScreen();
+        else    withParkedLists(scanDev, [this]{ reconcileScan(nullptr); });   // device switched meanwhile
+        revalCats.clear(); revalItems.clear();
+        revalItems.shrink_to_fit();
+    }
+
+    // Patch the active lists to match revalItems. removed (optional) gets the
+    // IDs that were dropped; new items are appended to their category lists.
+    void reconcileScan(std::vector<uint32_t>* removed) {
+        const uint32_t oldCount = (uint32_t)arena.size();
+        std::vector<uint8_t> seen(oldCount, 0);
+        unsigned added = 0, changed = 0, dropped = 0;
+
+        for (auto& cat : revalCats) applyScanCategory(cat);
+        for (auto& f : revalItems) {
+            const GameItem& gi = f.second;
+            auto it = pathIndex.find(gi.pathKey());
+            if (it != pathIndex.end() && arena[it->second].kind == gi.kind) {
+                GameItem& cur = arena[it->second];
+                seen[it->second] = 1;
+                if (cur.timeKey == gi.timeKey && !gi.titlePending && cur.titleId == gi.titleId &&
+                    (!gi.sizeBytes || cur.sizeBytes == gi.sizeBytes)) continue;
+                cur.timeKey = gi.timeKey;
+                if (gi.sizeBytes) cur.sizeBytes = gi.sizeBytes;
+                if (gi.sizeKnown) cur.sizeKnown = true;
+                if (gi.titlePending) cur.titlePending = true;   // keep showing the old title meanwhile
+                else { cur.titleId = gi.titleId; cur.titlePending = false; }
+                ++changed;
+                continue;
+            }
+            applyScanItem(f.first, gi);
+            ++added;
+        }
+        for (uint32_t id = 0; id < oldCount; ++id) {
+            if (seen[id]) continue;
+            auto it = pathIndex.find(arena[id].pathKey());
+            if (it == pathIndex.end() || it->second != id) continue;   // not listed (already gone)
+            if (!takeItem(arena[id].path(), arena[id].kind, nullptr)) continue;
+            if (removed) removed->push_back(id);
+            ++dropped;
+        }
+        syncDerivedLists();
+        listsComplete = true;
+        titleFillCursor = 0;
+        logfOnce("session: revalidated in %llu ms: %u added, %u changed, %u removed",
+                 (nowUS() - revalStartUS) / 1000ULL, added, changed, dropped);
+    }
+
+    // reconcileScan() for the device on screen, then the same patch on the view.
+    void reconcileOnScreen() {
+        const uint32_t oldCount = (uint32_t)arena.size();
+        std::string keepPath;
+        if (itemView() && selectedIndex >= 0 && selectedIndex < (int)workingList.size())
+            keepPath = row(selectedIndex).path();
+
+        std::vector<uint32_t> removed;
+        reconcileScan(&removed);
+        if (showRoots) return;
+
+        if (view == View_Categories) {
+            std::string keepName;
+            if (selectedIndex >= 0 && selectedIndex < rowCount()) keepName = dirRows[selectedIndex];
+            const int oldScroll = scrollOffset;
+            buildCategoryRows();
+            for (int i = 0; i < rowCount(); ++i)
+                if (keepName == dirRows[i]) { clampSelection(i, oldScroll); break; }
+            return;
+        }
+        if (!removed.empty()) {
+            std::sort(removed.begin(), removed.end());
+            workingList.erase(std::remove_if(workingList.begin(), workingList.end(),
+                [&](uint32_t id){ return std::binary_search(removed.begin(), removed.end(), id); }),
+                workingList.end());
+        }
+        const bool byTime = workingInTimeOrder();
+        for (uint32_t id = oldCount; id < arena.size(); ++id) {
+            const GameItem& gi = arena[id];
+            if (!scanItemInView(categoryKeyFor(gi.path(), gi.kind))) continue;
+            insertWorkingRow(id, byTime);
+        }
+        refillRowsFromWorkingPreserveSel();
+        selectByPath(keepPath);
+    }
+
+    // Size column for the rows on screen: take finished sizes from the folder
+    // size cache, queue the rest (newest request first). Results also go back
+    // into the category lists and the catalog so they survive view changes.
+    void pumpSizes() {
+        if (showRoots || !(view == View_AllFlat || view == View_CategoryContents)) return;
+        const int first = (scrollOffset < 0) ? 0 : scrollOffset;
+        const int last  = std::min((int)workingList.size(), first + MAX_DISPLAY);
+        for (int i = last - 1; i >= first; --i) {       // top row ends up at the queue front
+            GameItem& gi = row(i);
+            if (gi.kind != GameItem::EBOOT_FOLDER || gi.sizeBytes || gi.sizeKnown) continue;
+            const uint64_t tkey = gi.timeKey;
+            const std::string path = gi.path();
+            uint64_t bytes = 0;
+            if (!FolderSizeLookup(path, tkey, bytes)) { FolderSizeRequest(path, tkey); continue; }
+            setItemBytes(gi, bytes);   // arena item: every view sees it; 0 is a real size here
+            if (bytes) catalogFor(path).setBytes(path, tkey, bytes);   // the catalog reads 0 as unknown
+        }
+    }
+
+    // Deferred titles: take the filler's results, queue pending rows on
+    // screen (title mode only), then feed the rest of the device's items a
+    // batch at a time whenever the worker is idle and no scan is walking.
+    TitleFiller titles;
+    uint32_t titleFillCursor = 0;        // arena position of the background fill
+    bool     titleFillUnsaved = false;   // titles resolved since the catalogs were saved
+
+    void applyTitle(const GameItem& r) {
+        auto apply = [this, &r]{
+            auto it = pathIndex.find(r.pathKey());
+            if (it == pathIndex.end()) return false;
+            GameItem& gi = arena[it->second];
+            gi.titleId = r.titleId;
+            gi.titlePending = false;
+            if (r.sizeKnown && !gi.sizeKnown) setItemBytes(gi, r.sizeBytes);
+            return true;
+        };
+        if (apply()) return;
+        for (auto& kv : resident) {   // resolved for a device that is parked by now
+            if (!kv.second.pathIndex.count(r.pathKey())) continue;
+            withParkedLists(kv.first, apply);
+            return;
+        }
+    }
+
+    void pumpTitles() {
+        std::vector<GameItem> batch;
+        titles.takeDone(batch);
+        for (auto& r : batch) applyTitle(r);
+        if (!batch.empty()) titleFillUnsaved = true;
+
+        if (showTitles && itemView()) {
+            const int first = (scrollOffset < 0) ? 0 : scrollOffset;
+            const int last  = std::min((int)workingList.size(), first + MAX_DISPLAY);
+            for (int i = last - 1; i >= first; --i)      // top row ends up at the queue front
+                if (row(i).titlePending) titles.request(row(i), true);
+        }
+
+        if (scanInForeground() || !titles.idle()) return;
+        unsigned n = 0;
+        while (titleFillCursor < arena.size() && n < TITLE_FILL_BATCH) {
+            const GameItem& gi = arena[titleFillCursor++];
+            if (gi.titlePending) { titles.request(gi, false); ++n; }
+        }
+        if (n == 0 && titleFillUnsaved) {
+            titleFillUnsaved = false;
+            titles.saveWhenIdle();
+        }
+    }
+
+    // Sorting by title needs every title of the list: resolve its pending ones
+    // now, with a progress bar. A running scan keeps going meanwhile. Returns
+    // false if the user cancelled with O. Items the filler could not resolve
+    // (e.g. removed meanwhile) keep their names.
+    bool fillTitlesFor(const ItemIndex& list) {
+        std::vector<uint32_t> ids;
+        for (uint32_t id : list) if (arena[id].titlePending) ids.push_back(id);
+        if (ids.empty()) return true;
+        const unsigned long long t0 = nowUS();
+        for (auto it = ids.rbegin(); it != ids.rend(); ++it) titles.request(arena[*it], true);
+
+        MessageBox* prev = msgBox;
+        msgBox = new MessageBox("Reading titles...", nullptr, SCREEN_WIDTH, SCREEN_HEIGHT, 1.0f, 0, "", 16, 18, 8, 14);
+        msgBox->showProgress("", 0, ids.size());
+        SceCtrlData pad{}; sceCtrlReadBufferPositive(&pad, 1);
+        unsigned held = pad.Buttons;
+        bool cancelled = false;
+        size_t left = ids.size();
+        for (;;) {
+            const bool drained = titles.idle();   // every result for ids is taken by the pump below
+            pumpTitles();
+            left = 0;
+            for (uint32_t id : ids) if (arena[id].titlePending) ++left;
+            if (!left || drained) break;
+
+            sceCtrlReadBufferPositive(&pad, 1);
+            const unsigned pressed = pad.Buttons & ~held;
+            held = pad.Buttons;
+            if (pressed & PSP_CTRL_CIRCLE) { cancelled = true; break; }
+
+            char line[48];
+            snprintf(line, sizeof(line), "%u / %u   O: Cancel", (unsigned)(ids.size() - left), (unsigned)ids.size());
+            msgBox->updateProgress(ids.size() - left, ids.size(), line);
+            renderOneFrame();
+        }
+        delete msgBox; msgBox = prev;
+        inputWaitRelease = true;
+        logf("titles: %u of %u read for sorting in %llu ms%s", (unsigned)(ids.size() - left), (unsigned)ids.size(),
+             (nowUS() - t0) / 1000ULL, cancelled ? " (cancelled)" : "");
+        return !cancelled;
+    }
+
+    // Per-frame heap upkeep: let caches shrink under pressure and log when an
+    // allocation failed anyway.
+    unsigned heapFailuresLogged = 0;
+    void pumpHeap() {
+        hbTick();
+        if (hbFailures() == heapFailuresLogged) return;
+        HeapStats hs; hbGetStats(hs);
+        heapFailuresLogged = hs.failures;
+        logf("heap: %u allocation failure(s); %u/%u KB in use, peak %u KB", hs.failures,
+             (unsigned)(hs.heapUsed >> 10), (unsigned)(hs.heapTotal >> 10), (unsigned)(hs.heapPeak >> 10));
+    }
+
+    // -----------------------------------------------------------
+    // Incremental updates: replay completed operations onto the lists
+    // instead of re-running scanDevice.
+    // -----------------------------------------------------------
+    struct OpDelta {
+        enum Type { D_Add, D_Remove, D_Move, D_Retime, D_Rescan } type;
+        std::string    src;    // D_Add: copy source; D_Remove/D_Retime/D_Rescan: the path
+        std::string    dst;    // D_Add/D_Move: new path
+        GameItem::Kind kind;
+    };
+
+    // Category of an item folder, parsed once per (dir, kind): every item in
+    // a dir shares it. Dir IDs intern the full path, device prefix included,
+    // so one cache serves every device.
+    std::unordered_map<uint64_t, std::string> dirCategory;
+    const std::string& dirCategoryOf(uint32_t dirId, GameItem::Kind kind) {
+        const uint64_t key = ((uint64_t)dirId << 1) | kind;
+        auto it = dirCategory.find(key);
+        if (it != dirCategory.end()) return it->second;
+        const std::string cat = parseCategoryFromFullPath(std::string(gStrings.str(dirId)) + "_", kind);
+        return dirCategory.emplace(key, cat).first->second;
+    }
+    std::string categoryKeyFor(const std::string& path, GameItem::Kind kind) {
+        const uint32_t d = gStrings.find(path.data(), GameItem::dirLength(path));
+        if (d) return dirCategoryOf(d, kind);
+        return parseCategoryFromFullPath(path, kind);   // "" = Uncategorized
+    }
+
+    void countInIndex(const std::string& name, const GameItem& gi) {
+        CategoryStats& cs = catIndex[name];
+        ++cs.items;
+        cs.bytes += gi.sizeBytes;
+    }
+    void rebuildCatIndex() {
+        catIndex.clear();
+        for (auto& kv : categories)
+            for (uint32_t id : kv.second) countInIndex(kv.first, arena[id]);
+        for (uint32_t id : uncategorized) countInIndex("Uncategorized", arena[id]);
+    }
+    // Size of a listed item arrived (size worker, title filler): keep the index total.
+    void setItemBytes(GameItem& gi, uint64_t bytes) {
+        gi.sizeKnown = true;
+        if (gi.sizeBytes == bytes) return;
+        const std::string& cat = dirCategoryOf(gi.dirId, gi.kind);
+        auto it = catIndex.find(cat.empty() ? std::string("Uncategorized") : cat);
+        if (it != catIndex.end()) it->second.bytes += bytes - gi.sizeBytes;
+        gi.sizeBytes = bytes;
+    }
+    ItemIndex& listForCategory(const std::string& cat) {
+        return cat.empty() ? uncategorized : categories[cat];
+    }
+    // Listed item with this path, or nullptr.
+    GameItem* findItem(const std::string& path) {
+        const uint32_t id = itemIdOf(path);
+        return (id == NO_ITEM) ? nullptr : &arena[id];
+    }
+
+    // Detach the item with this path from its category list and drop its
+    // checkmark; false if not present. The arena slot stays allocated
+    // (unreferenced) until the next full scan.
+    bool takeItem(const std::string& path, GameItem::Kind kind, uint32_t* out) {
+        const uint32_t id = itemIdOf(path);
+        if (id == NO_ITEM) return false;
+        ItemIndex& v = listForCategory(categoryKeyFor(path, kind));
+        auto it = std::find(v.begin(), v.end(), id);
+        if (it == v.end()) return false;
+        v.erase(it);
+        unindexItem(id);
+        setChecked(id, false);
+        if (out) *out = id;
+        return true;
+    }
+    void placeItem(uint32_t idx) {
+        const std::string path = arena[idx].path();
+        takeItem(path, arena[idx].kind, nullptr);   // REPLACE_ON_MOVE: destination entry is overwritten
+        std::string cat = categoryKeyFor(path, arena[idx].kind);
+        if (!cat.empty()) hasCategories = true;
+        listForCategory(cat).push_back(idx);
+        indexItem(idx);
+    }
+    void restatItem(GameItem& gi) {
+        SceIoStat st;
+        if (!getStat(gi.path(), st)) return;
+        gi.timeKey = packDateTime(st.sce_st_mtime);
+        if (gi.kind == GameItem::ISO_FILE) gi.sizeBytes = (uint64_t)st.st_size;
+    }
+
+    // Scoped rescan of one category ("" = Uncategorized) across the six roots.
+    void rescanCategory(const std::string& cat) {
+        ScanCatalog& catalog = catalogFor(scannedDevice);
+        ItemIndex& out = listForCategory(cat);
+        std::unordered_set<uint64_t> wasChecked;   // rescanned items get new IDs; keep their marks
+        for (uint32_t id : out) {
+            if (isChecked(id)) { wasChecked.insert(arena[id].pathKey()); setChecked(id, false); }
+            unindexItem(id);
+        }
+        out.clear();
+        auto add = [&](const GameItem& gi){
+            const uint32_t id = addItem(gi);
+            indexItem(id);
+            if (wasChecked.count(gi.pathKey())) setChecked(id, true);
+            out.push_back(id);
+        };
+
+        const char* isoRoots[]  = {"ISO/","ISO/PSP/"};
+        const char* gameRoots[] = {"PSP/GAME/","PSP/GAME/PSX/","PSP/GAME/Utility/","PSP/GAME150/"};
+        for (auto r : isoRoots) {
+            std::string dir = scannedDevice + r + cat;
+            forEachEntry(dir, [&](const SceIoDirent &e){
+                if (FIO_S_ISDIR(e.d_stat.st_mode)) return;
+                GameItem gi;
+                if (makeIsoItem(dir, e.d_name, gi, &e.d_stat)) add(gi);
+            });
+        }
+        for (auto r : gameRoots) {
+            std::string dir = scannedDevice + r + cat;
+            forEachEntry(dir, [&](const SceIoDirent &e){
+                if (!FIO_S_ISDIR(e.d_stat.st_mode)) return;
+                if (cat.empty() && startsWithCAT(e.d_name)) return;
+                GameItem gi;
+                if (makeEbootItem(dir, e.d_name, gi, &e.d_stat)) add(gi);
+            });
+        }
+        catalog.save();
+    }
+
+    // Bring categoryNames / flatAll / the "Uncategorized" marker back in line with the lists.
+    void syncDerivedLists() {
+        for (auto it = categories.begin(); it != categories.end(); ) {
+            if (it->first != "Uncategorized" && it->second.empty()) it = categories.erase(it);
+            else ++it;
+        }
+        categories.erase("Uncategorized");
+        categoryNames.clear();
+        flatAll.clear();
+        if (!categories.empty()) hasCategories = true;
+        if (!hasCategories) {
+            flatAll = uncategorized;
+        } else {
+            for (auto &kv : categories) categoryNames.push_back(kv.first);
+            std::sort(categoryNames.begin(), categoryNames.end(),
+                      [](const std::string& a, const std::string& b){ return strcasecmp(a.c_str(), b.c_str()) < 0; });
+            if (!uncategorized.empty()) categories["Uncategorized"]; // flag presence
+        }
+        rebuildCatIndex();
+    }
+
+    void applyDeltas(const std::vector<OpDelta>& deltas) {
+        const unsigned long long t0 = nowUS();
+        std::vector<std::string> rescans;
+        auto needRescan = [&](const std::string& cat){
+            if (std::find(rescans.begin(), rescans.end(), cat) == rescans.end()) rescans.push_back(cat);
+        };
+        auto onScanned = [&](const std::string& p){ return sameDevice(p, scannedDevice); };
+
+        for (const OpDelta& d : deltas) {
+            switch (d.type) {
+            case OpDelta::D_Remove:
+                if (onScanned(d.src) && !takeItem(d.src, d.kind, nullptr)) needRescan(categoryKeyFor(d.src, d.kind));
+                break;
+            case OpDelta::D_Move: {
+                uint32_t idx = 0;
+                bool have = onScanned(d.src) && takeItem(d.src, d.kind, &idx);
+                if (!onScanned(d.dst)) break;
+                if (!have) { needRescan(categoryKeyFor(d.dst, d.kind)); break; }
+                arena[idx].setPath(d.dst);   // same record, new place
+                placeItem(idx);
+                break;
+            }
+            case OpDelta::D_Add: {
+                if (!onScanned(d.dst)) break;
+                const GameItem* src = onScanned(d.src) ? findItem(d.src) : nullptr;
+                if (!src) { needRescan(categoryKeyFor(d.dst, d.kind)); break; }
+                GameItem gi = *src;
+                gi.setPath(d.dst);
+                restatItem(gi);   // copies get a fresh mtime
+                placeItem(addItem(gi));
+                break;
+            }
+            case OpDelta::D_Retime: {
+                if (!onScanned(d.src)) break;
+                GameItem* gi = findItem(d.src);
+                if (gi) restatItem(*gi);
+                else needRescan(categoryKeyFor(d.src, d.kind));
+                break;
+            }
+            case OpDelta::D_Rescan:
+                if (onScanned(d.src)) needRescan(categoryKeyFor(d.src, d.kind));
+                break;
+            }
+        }
+        for (auto& cat : rescans) rescanCategory(cat);
+        syncDerivedLists();
+        logfOnce("applyDeltas: %d op(s), %d scoped rescan(s), %llu ms",
+                 (int)deltas.size(), (int)rescans.size(), (nowUS() - t0) / 1000ULL);
+    }
+
+    void renameCategoryInLists(const std::string& from, const std::string& to) {
+        auto it = categories.find(from);
+        if (it != categories.end()) {
+            ItemIndex moved; moved.swap(it->second);
+            categories.erase(it);
+            ItemIndex& dst = categories[to];
+            for (uint32_t i : moved) {
+                GameItem& gi = arena[i];
+                unindexItem(i);
+                gi.setPath(buildDestPath(gi.path(), gi.kind, scannedDevice, to));
+                indexItem(i);
+                dst.push_back(i);
+            }
+        }
+        syncDerivedLists();
+    }
+
+    // Re-show the lists for the current view without scanning.
+    void refreshViewFromLists(const std::string& keepPath) {
+        if (hasCategories) {
+            if (view == View_CategoryContents) {
+                openCategory(currentCategory.empty() ? "Uncategorized" : currentCategory);
+                selectByPath(keepPath);
+            } else {
+                buildCategoryRows();
+            }
+        } else {
+            showDeviceLists();
+            selectByPath(keepPath);
+        }
+    }
+
+    void clearUI(){
+        rowFreeBytes.clear();
+        rowReason.clear();      // <--- add
+        rowNeedBytes.clear();   // <--- add
+        dirRows.clear();
+        rowFlags.clear(); rowFreeBytes.clear();
+        selectedIndex=0; scrollOffset=0;
+        freeSelectionIcon();
+    }
+
+
+    // Rows are drawn straight from workingList, so this only re-clamps selection and scroll.
+    void refillRowsFromWorkingPreserveSel(){
+        int oldSel = selectedIndex, oldScroll = scrollOffset;
+        if (workingList.empty()) { selectedIndex = 0; scrollOffset = 0; }
+        else {
+            if (oldSel >= (int)workingList.size()) oldSel = (int)workingList.size()-1;
+            if (oldSel < 0) oldSel = 0;
+            selectedIndex = oldSel;
+            int maxScroll = (int)workingList.size() - MAX_DISPLAY;
+            if (maxScroll < 0) maxScroll = 0;
+            if (oldScroll > maxScroll) oldScroll = maxScroll;
+            if (oldScroll < 0) oldScroll = 0;
+            scrollOffset = oldScroll;
+        }
+        showRoots = false;
+        freeSelectionIcon();
+    }
+
+    void buildRootRows(){
+        clearUI();
+        int preselect = -1;
+        const uint64_t HEADROOM = (4ull << 20); // keep ~4 MiB headroom
+
+        for (auto &r : roots){
+            dirRows.push_back(r);
+
+            uint8_t flags = 0;
+            RowDisableReason reason = RD_NONE;
+            uint64_t needB = 0, freeB = 0;
+
+            needB = 0;
+            // Existing rule: running from ef0 → ms0 disabled
             if (runningFromEf0 && r == "ms0:/") {
                 flags |= ROW_DISABLED;
                 reason = RD_RUNNING_FROM_EF0;
@@ -2412,7 +3814,7 @@ private:
             rowReason.push_back(reason);
             rowNeedBytes.push_back(needB);
 
-            if (r == currentDevice) preselect = (int)entries.size() - 1;
+            if (r == currentDevice) preselect = (int)dirRows.size() - 1;
         }
 
         showRoots = true; moving = false;
@@ -2421,7 +3823,7 @@ private:
         if (preselect >= 0 && (rowFlags[preselect] & ROW_DISABLED) == 0) {
             selectedIndex = preselect;
         } else {
-            for (int i = 0; i < (int)entries.size(); ++i)
+            for (int i = 0; i < rowCount(); ++i)
                 if ((rowFlags[i] & ROW_DISABLED) == 0) { selectedIndex = i; break; }
         }
     }
@@ -2441,13 +3843,9 @@ private:
 
         int preselect = -1;
         for (auto &name : catsSorted){
-            SceIoDirent e{}; strncpy(e.d_name, name.c_str(), sizeof(e.d_name)-1);
-            e.d_stat.st_mode = FIO_S_IFDIR;
-            entries.push_back(e);
-            entryPaths.emplace_back("");
-            entryKinds.push_back(GameItem::ISO_FILE);
+            dirRows.push_back(name);
             if (!currentCategory.empty() && name == currentCategory)
-                preselect = (int)entries.size() - 1;
+                preselect = (int)dirRows.size() - 1;
         }
         showRoots = false; view = View_Categories;
 
@@ -2475,7 +3873,7 @@ private:
 
         if (sameDevice) {
             for (size_t i = 0; i < opSrcPaths.size(); ++i) {
-                std::string cat = parseCategoryFromFullPath(opSrcPaths[i], opSrcKinds[i]);
+                std::string cat = categoryKeyFor(opSrcPaths[i], opSrcKinds[i]);
                 if (!cat.empty()) {
                     opDisabledCategories.insert(cat);
                 } else {
@@ -2488,45 +3886,29 @@ private:
             }
         }
 
-        std::vector<std::string> catsSorted = categoryNames;
-        std::sort(catsSorted.begin(), catsSorted.end(),
-                [](const std::string& a, const std::string& b){
-                    return strcasecmp(a.c_str(), b.c_str()) < 0;
-                });
-
-        bool alreadyHasUnc = false;
-        for (auto& n : catsSorted) if (!strcasecmp(n.c_str(),"Uncategorized")) { alreadyHasUnc = true; break; }
-        if (!alreadyHasUnc) catsSorted.push_back("Uncategorized");
-
-        for (auto &name : catsSorted){
-            SceIoDirent e{}; strncpy(e.d_name, name.c_str(), sizeof(e.d_name)-1);
-            e.d_stat.st_mode = FIO_S_IFDIR;
-            entries.push_back(e);
-            entryPaths.emplace_back("");
-            entryKinds.push_back(GameItem::ISO_FILE);
-        }
+        // categoryNames is kept sorted and never holds "Uncategorized".
+        dirRows = categoryNames;
+        dirRows.push_back("Uncategorized");
         showRoots = false;
         view = View_Categories;
 
         // Select the first NON-disabled category
         int sel = 0;
-        while (sel < (int)entries.size() &&
-            opDisabledCategories.find(entries[sel].d_name) != opDisabledCategories.end()) {
+        while (sel < rowCount() &&
+            opDisabledCategories.find(dirRows[sel]) != opDisabledCategories.end()) {
             ++sel;
         }
-        if (sel >= (int)entries.size()) sel = 0;
+        if (sel >= rowCount()) sel = 0;
         selectedIndex = sel;
         scrollOffset = 0;
     }
 
     void openDevice(const std::string& dev){
         currentDevice = dev;
-
-        msgBox = new MessageBox("Populating...", nullptr, SCREEN_WIDTH, SCREEN_HEIGHT, 1.0f, 0, "", 16, 18, 8, 14);
-        renderOneFrame();
-        scanDevice(currentDevice);
+        activateLists(dev);           // resident lists show at once
+        if (!listsComplete && !scanInForeground())
+            startScan(currentDevice); // lists fill in from pumpScan()
         moving = false;
-        delete msgBox; msgBox = nullptr;
 
         // Background-probe only the *opposite* device so UI stays snappy
         const bool canCrossDevices = dualDeviceAvailableFromMs0(); // PSP Go, running from ms0, both devices
@@ -2543,23 +3925,19 @@ private:
             FreeSpaceRequestRefresh();
         }
 
-        // -----------------------------------------------------------------------
+        if (listsComplete || scanLayoutKnown) showDeviceLists();
+        else { view = View_AllFlat; workingList.clear(); clearUI(); showRoots = false; }   // empty until the roots are read
+    }
 
+    // Top-level view for the scanned device: category list or the flat list.
+    void showDeviceLists() {
         if (hasCategories) {
             buildCategoryRows();
         } else {
             workingList = flatAll;
-            sortLikeLegacy(workingList);
+            sortLikeLegacy(workingList, arena);
             view = View_AllFlat;
             clearUI();
-            for (const auto& gi : workingList){
-                SceIoDirent e; memset(&e,0,sizeof(e));
-                const char* name = (showTitles && !gi.title.empty()) ? gi.title.c_str() : gi.label.c_str();
-                strncpy(e.d_name, name, sizeof(e.d_name)-1);
-                entries.push_back(e);
-                entryPaths.push_back(gi.path);
-                entryKinds.push_back(gi.kind);
-            }
             showRoots = false;
         }
     }
@@ -2568,23 +3946,21 @@ private:
     void openCategory(const std::string& catName){
         currentCategory = catName;
         moving = false;
+        if (scanInForeground()) {
+            // Contents still being scanned: this category first, then the next row.
+            wantCategory(catName);
+            auto nx = std::find(categoryNames.begin(), categoryNames.end(), catName);
+            if (nx != categoryNames.end() && ++nx != categoryNames.end()) wantCategory(*nx);
+        }
         if (catName == "Uncategorized") workingList = uncategorized;
         else {
             workingList.clear();
             auto it = categories.find(catName);
             if (it != categories.end()) workingList = it->second;
         }
-        sortLikeLegacy(workingList);
+        sortLikeLegacy(workingList, arena);
         view = View_CategoryContents;
         clearUI();
-        for (const auto& gi : workingList){
-            SceIoDirent e; memset(&e,0,sizeof(e));
-            const char* name = (showTitles && !gi.title.empty()) ? gi.title.c_str() : gi.label.c_str();
-            strncpy(e.d_name, name, sizeof(e.d_name)-1);
-            entries.push_back(e);
-            entryPaths.push_back(gi.path);
-            entryKinds.push_back(gi.kind);
-        }
         showRoots = false;
     }
 
@@ -2599,15 +3975,16 @@ private:
     }
     static void applyTimesLikeLegacy(const std::string& target, const ScePspDateTime &dt){
         SceIoStat st; fillStatTimes(st, dt);
-        sceIoChstat(target.c_str(), &st, 0x08 | 0x10 | 0x20);
+        ioChstat(target.c_str(), &st, 0x08 | 0x10 | 0x20);
     }
     void commitOrderTimestamps(){
+        finishScan();
         if (workingList.empty()) return;
         moving = false;
 
         std::string keepPath;
         if (selectedIndex >= 0 && selectedIndex < (int)workingList.size())
-            keepPath = workingList[selectedIndex].path;
+            keepPath = row(selectedIndex).path();
 
         msgBox = new MessageBox("Saving...", nullptr, SCREEN_WIDTH, SCREEN_HEIGHT, 1.0f, 0, "", 16, 18, 8, 14);
         renderOneFrame();
@@ -2619,28 +3996,25 @@ private:
         sceRtcGetTick(&startDT, &startTick);
         const unsigned long long STEP = 10ULL * 1000000ULL;
 
+        std::vector<OpDelta> deltas;
         int n = (int)workingList.size();
         for (int i = n - 1; i >= 0; --i){
             unsigned long long tick = startTick + (unsigned long long)((n-1) - i) * STEP;
             ScePspDateTime dt{}; sceRtcSetTick(&dt, &tick);
-            const GameItem &gi = workingList[i];
-            applyTimesLikeLegacy(gi.path, dt);
+            const GameItem &gi = row(i);
+            const std::string path = gi.path();
+            applyTimesLikeLegacy(path, dt);
+
+            // FAT rounds mtimes, so re-read what was stored to keep the catalog entry valid
+            SceIoStat after;
+            if (getStat(path, after)) catalogFor(path).touch(path, packDateTime(after.sce_st_mtime));
+            deltas.push_back({ OpDelta::D_Retime, path, std::string(), gi.kind });
         }
 
         delete msgBox; msgBox = nullptr;
 
-        scanDevice(currentDevice);
-        if (hasCategories) {
-            if (view == View_CategoryContents) {
-                openCategory(currentCategory);
-                selectByPath(keepPath);
-            } else {
-                buildCategoryRows();
-            }
-        } else {
-            openDevice(currentDevice);
-            selectByPath(keepPath);
-        }
+        applyDeltas(deltas);
+        refreshViewFromLists(keepPath);
 
         drawMessage("Order saved", COLOR_GREEN);
         sceKernelDelayThread(700 * 1000);
@@ -2683,7 +4057,7 @@ private:
     static bool ensureDir(const std::string& path) {
         // create single level
         if (dirExists(path)) return true;
-        return sceIoMkdir(path.c_str(), 0777) >= 0;
+        return ioMkdir(path.c_str(), 0777) >= 0;
     }
     static bool ensureDirRecursive(const std::string& full) {
         // make every segment after "ms0:/" or "ef0:/"
@@ -2694,7 +4068,7 @@ private:
             if (j == std::string::npos) j = full.size();
             std::string sub = full.substr(0, j);
             if (!dirExists(sub)) {
-                if (sceIoMkdir(sub.c_str(), 0777) < 0) return false;
+                if (ioMkdir(sub.c_str(), 0777) < 0) return false;
             }
             i = j + 1;
         }
@@ -2704,40 +4078,40 @@ private:
         SceIoStat st{}; if (sceIoGetstat(path.c_str(), &st) < 0) return false;
         return FIO_S_ISDIR(st.st_mode);
     }
-    // Replace your copyFile with this hardened version.
-    // NOTE: signature unchanged from your current integration that passes `this`.
-    static bool copyFile(const std::string& src, const std::string& dst, KernelFileExplorer* self) {
-        logf("copyFile: %s -> %s", src.c_str(), dst.c_str());
-
-        SceUID in = sceIoOpen(src.c_str(), PSP_O_RDONLY, 0);
-        if (in < 0) { logf("  open src failed %d", in); return false; }
+    // The copy itself, on raw paths: dst's parent must exist and the caller
+    // invalidates dst in gDirCache, so a tree copy allocates nothing per file.
+    static bool copyFile(const char* src, const char* dst, KernelFileExplorer* self) {
+        SceUID in = sceIoOpen(src, PSP_O_RDONLY, 0);
+        if (in < 0) { logf("  open src %s failed %d", src, in); return false; }
 
-        // Ensure parent
-        std::string parent = parentOf(dst);
-        if (!ensureDirRecursive(parent)) {
-            logf("  ensureDirRecursive(%s) failed", parent.c_str());
-            sceIoClose(in);
-            return false;
-        }
-
-        SceUID out = sceIoOpen(dst.c_str(), PSP_O_WRONLY | PSP_O_CREAT | PSP_O_TRUNC, 0666);
-        if (out < 0) { logf("  open dst failed %d", out); sceIoClose(in); return false; }
+        SceUID out = sceIoOpen(dst, PSP_O_WRONLY | PSP_O_CREAT | PSP_O_TRUNC, 0666);
+        if (out < 0) { logf("  open dst %s failed %d", dst, out); sceIoClose(in); return false; }
 
         uint64_t fileSize = 0;
-        { SceIoStat st{}; if (sceIoGetstat(src.c_str(), &st) >= 0) fileSize = (uint64_t)st.st_size; if (!fileSize) fileSize = 1; }
+        { SceIoStat st{}; if (sceIoGetstat(src, &st) >= 0) fileSize = (uint64_t)st.st_size; if (!fileSize) fileSize = 1; }
 
-        if (self && self->msgBox) { self->msgBox->showProgress(basenameOf(src).c_str(), 0, fileSize); self->renderOneFrame(); }
+        if (self && self->msgBox) {
+            const char* name = strrchr(src, '/');
+            self->msgBox->showProgress(name ? name + 1 : src, 0, fileSize);
+            self->renderOneFrame();
+        }
 
-        const int READ_BUF = 512 * 1024;
+        const int READ_BUF = 512 * 1024;   // preferred; settles for less when the heap is tight
         int maxWriteChunk  = 64  * 1024;   // start at 64 KiB, we may shrink on trouble
         const int MIN_WRITE_CHUNK = 4 * 1024;
 
-        std::vector<uint8_t> buf(READ_BUF);
+        HeapBuffer buf(HB_IoBuffers, READ_BUF, 32 * 1024);
+        if (!buf.data) {
+            logf("  no memory for a copy buffer");
+            sceIoClose(in); sceIoClose(out); sceIoRemove(dst);
+            return false;
+        }
         bool ok = true; uint64_t total = 0; int lastErr = 0;
 
-        auto destDev = std::string(dst.substr(0, 4)); // "ms0:" / "ef0:" (dst is "ef0:/...")
+        char destDev[5] = {0};               // "ms0:" / "ef0:" (dst is "ef0:/...")
+        strncpy(destDev, dst, 4);
         for (;;) {
-            int r = sceIoRead(in, buf.data(), READ_BUF);
+            int r = sceIoRead(in, buf.data, (int)buf.size);
             if (r < 0) { lastErr = r; logf("  read err %d", r); ok = false; break; }
             if (r == 0) break;
 
@@ -2746,14 +4120,14 @@ private:
                 int chunk = r - off;
                 if (chunk > maxWriteChunk) chunk = maxWriteChunk;
 
-                int w = sceIoWrite(out, buf.data() + off, chunk);
+                int w = sceIoWrite(out, buf.data + off, chunk);
                 if (w <= 0) {
                     // If 0 or negative, try shrinking the chunk a few times before giving up
                     int attemptChunk = chunk;
                     for (int tries = 0; tries < 4 && w <= 0 && attemptChunk > MIN_WRITE_CHUNK; ++tries) {
                         attemptChunk >>= 1; // half it
                         sceKernelDelayThread(500);
-                        w = sceIoWrite(out, buf.data() + off, attemptChunk);
+                        w = sceIoWrite(out, buf.data + off, attemptChunk);
                         if (w > 0) {
                             maxWriteChunk = attemptChunk;
                             break;
@@ -2762,9 +4136,9 @@ private:
 
                     if (w <= 0) {
                         uint64_t freeBytes = 0;
-                        if (getFreeBytesCMF(destDev.c_str(), freeBytes)) {
+                        if (getFreeBytesCMF(destDev, freeBytes)) {
                             logf("  write err %d (chunk=%d) with free=%llu bytes on %s",
-                                w, attemptChunk, (unsigned long long)freeBytes, canonicalDev(destDev.c_str()));
+                                w, attemptChunk, (unsigned long long)freeBytes, canonicalDev(destDev));
                         } else {
                             logf("  write err %d (chunk=%d); CMF free space query failed", w, attemptChunk);
                         }
@@ -2788,31 +4162,41 @@ private:
         sceIoClose(out);
 
         if (!ok) {
-            logf("copyFile: FAIL after %llu/%llu bytes (err=%d)",
-                (unsigned long long)total, (unsigned long long)fileSize, lastErr);
-            sceIoRemove(dst.c_str()); // remove partial
+            logf("copyFile: %s FAIL after %llu/%llu bytes (err=%d)",
+                dst, (unsigned long long)total, (unsigned long long)fileSize, lastErr);
+            sceIoRemove(dst); // remove partial
             if (self && self->msgBox) { self->msgBox->updateProgress(total, fileSize); self->renderOneFrame(); }
             return false;
         }
 
         if (self && self->msgBox) { self->msgBox->updateProgress(fileSize, fileSize); self->renderOneFrame(); }
+#if LOG_VERBOSE
         logf("copyFile: OK %llu bytes", (unsigned long long)total);
+#endif
         return true;
     }
+    static bool copyFile(const std::string& src, const std::string& dst, KernelFileExplorer* self) {
+        logf("copyFile: %s -> %s", src.c_str(), dst.c_str());
+        std::string parent = parentOf(dst);
+        if (!ensureDirRecursive(parent)) { logf("  ensureDirRecursive(%s) failed", parent.c_str()); return false; }
+        const bool ok = copyFile(src.c_str(), dst.c_str(), self);
+        invalidateWritten(dst);
+        if (ok) logf("copyFile: OK");
+        return ok;
+    }
 
 
-    static bool removeDirRecursive(const std::string& dir) {
+    // Raw sceIo walk on one PathBuf; the wrapper invalidates the cached tree once.
+    static bool removeDirRecursive(PathBuf& dir) {
         SceUID d = pspIoOpenDir(dir.c_str());
         if (d < 0) { logf("removeDirRecursive: open %s failed %d", dir.c_str(), d); return false; }
         SceIoDirent ent; memset(&ent, 0, sizeof(ent));
         while (pspIoReadDir(d, &ent) > 0) {
             if (!strcmp(ent.d_name, ".") || !strcmp(ent.d_name, "..")) { memset(&ent,0,sizeof(ent)); continue; }
-            std::string child = joinDirFile(dir, ent.d_name);
-            if (FIO_S_ISDIR(ent.d_stat.st_mode)) {
-                removeDirRecursive(child);
-                sceIoRmdir(child.c_str());
-            } else {
-                sceIoRemove(child.c_str());
+            if (dir.push(ent.d_name)) {
+                if (FIO_S_ISDIR(ent.d_stat.st_mode)) removeDirRecursive(dir);   // removes the subdir too
+                else sceIoRemove(dir.c_str());
+                dir.pop();
             }
             memset(&ent, 0, sizeof(ent));
             sceKernelDelayThread(0); // yield
@@ -2820,29 +4204,50 @@ private:
         pspIoCloseDir(d);
         return sceIoRmdir(dir.c_str()) >= 0;
     }
-    static bool copyDirRecursive(const std::string& src, const std::string& dst, KernelFileExplorer* self) {
-        logf("copyDirRecursive: %s -> %s", src.c_str(), dst.c_str());
-        if (!ensureDirRecursive(dst)) { logf("  ensureDirRecursive failed"); return false; }
-        SceUID d = pspIoOpenDir(src.c_str());
-        if (d < 0) { logf("  open src failed %d", d); return false; }
+    static bool removeDirRecursive(const std::string& dir) {
+        PathBuf p(dir);
+        if (!p.fits) return false;
+        bool ok = removeDirRecursive(p);
+        gDirCache.invalidateTree(dir);
+        return ok;
+    }
+    // Raw sceIo walk on two PathBufs, like removeDirRecursive(); the wrapper
+    // invalidates the copied tree once.
+    static bool copyDirRecursive(PathBuf& s, PathBuf& t, KernelFileExplorer* self) {
+        SceUID d = pspIoOpenDir(s.c_str());
+        if (d < 0) { logf("  open src %s failed %d", s.c_str(), d); return false; }
 
         SceIoDirent ent; memset(&ent, 0, sizeof(ent));
         bool ok = true;
         while (ok && pspIoReadDir(d, &ent) > 0) {
             if (!strcmp(ent.d_name, ".") || !strcmp(ent.d_name, "..")) { memset(&ent,0,sizeof(ent)); continue; }
-            std::string s = joinDirFile(src, ent.d_name);
-            std::string t = joinDirFile(dst, ent.d_name);
+            if (!s.push(ent.d_name)) { ok = false; break; }
+            if (!t.push(ent.d_name)) { s.pop(); ok = false; break; }
 
             if (FIO_S_ISDIR(ent.d_stat.st_mode)) {
-                ok = ensureDir(t) && copyDirRecursive(s, t, self);
+                SceIoStat st{};
+                ok = sceIoMkdir(t.c_str(), 0777) >= 0
+                     || (sceIoGetstat(t.c_str(), &st) >= 0 && FIO_S_ISDIR(st.st_mode));
+                if (ok) ok = copyDirRecursive(s, t, self);
             } else {
+#if LOG_VERBOSE
                 logf("  file: %s -> %s (%ld bytes)", s.c_str(), t.c_str(), (long)ent.d_stat.st_size);
-                ok = copyFile(s, t, self);
+#endif
+                ok = copyFile(s.c_str(), t.c_str(), self);
             }
+            t.pop(); s.pop();
             memset(&ent, 0, sizeof(ent));
             sceKernelDelayThread(0); // yield
         }
         pspIoCloseDir(d);
+        return ok;
+    }
+    static bool copyDirRecursive(const std::string& src, const std::string& dst, KernelFileExplorer* self) {
+        logf("copyDirRecursive: %s -> %s", src.c_str(), dst.c_str());
+        if (!ensureDirRecursive(dst)) { logf("  ensureDirRecursive failed"); return false; }
+        PathBuf s(src), t(dst);
+        bool ok = s.fits && t.fits && copyDirRecursive(s, t, self);
+        gDirCache.invalidateTree(dst);
         logf("copyDirRecursive: %s", ok ? "OK" : "FAIL");
         return ok;
     }
@@ -2938,8 +4343,8 @@ private:
 
         // Devctl expects two pointers to the path parts AFTER the colon
         uint32_t data[2];
-        data[0] = (uint32_t)(c1 + 1);
-        data[1] = (uint32_t)(c2 + 1);
+        data[0] = (uint32_t)(uintptr_t)(c1 + 1);
+        data[1] = (uint32_t)(uintptr_t)(c2 + 1);
 
         // 0x02415830 = FAT intra-volume move/rename (instant)
         return pspIoDevctl(dev, 0x02415830, data, sizeof(data), nullptr, 0);
@@ -2964,7 +4369,7 @@ private:
         SceIoStat dstSt{};
         if (pathExists(dst, &dstSt) && REPLACE_ON_MOVE) {
             if (isDirMode(dstSt)) { logf("  dst exists (dir) -> removing"); removeDirRecursive(dst); }
-            else                  { logf("  dst exists (file)-> removing"); sceIoRemove(dst.c_str()); }
+            else                  { logf("  dst exists (file)-> removing"); ioRemove(dst.c_str()); }
         }
 
         // Same device? Prefer instant operations.
@@ -2973,17 +4378,17 @@ private:
             if (rc >= 0) return true;
 
             if (kind == GameItem::ISO_FILE) {
-                int rr = sceIoRename(src.c_str(), dst.c_str());
+                int rr = ioRename(src.c_str(), dst.c_str());
                 if (rr >= 0) return true;
                 // Fallback: same-device copy+delete -> show progress
                 bool ok = copyFile(src, dst, self);
-                if (ok) sceIoRemove(src.c_str());
+                if (ok) ioRemove(src.c_str());
                 return ok;
             } else {
-                int rr = sceIoRename(src.c_str(), dst.c_str());
+                int rr = ioRename(src.c_str(), dst.c_str());
                 if (rr >= 0) return true;
 
-                if (fastMoveDirByRenames(src, dst)) { sceIoRmdir(src.c_str()); return true; }
+                if (fastMoveDirByRenames(src, dst)) { ioRmdir(src.c_str()); return true; }
 
                 // Last resort: show progress per file while copying the tree
                 bool ok = copyDirRecursive(src, dst, self) && removeDirRecursive(src);
@@ -2994,7 +4399,7 @@ private:
         // Cross-device: always copy+delete, with progress
         if (kind == GameItem::ISO_FILE) {
             bool ok = copyFile(src, dst, self);
-            if (ok) sceIoRemove(src.c_str());
+            if (ok) ioRemove(src.c_str());
             return ok;
         } else {
             bool ok = copyDirRecursive(src, dst, self) && removeDirRecursive(src);
@@ -3010,7 +4415,7 @@ private:
             self->msgBox->showProgress(basenameOf(path).c_str(), 0, 1);
             self->renderOneFrame();
         }
-        int rc = sceIoRemove(path.c_str());
+        int rc = ioRemove(path.c_str());
         if (self && self->msgBox) {
             self->msgBox->updateProgress(1, 1);
             self->renderOneFrame();
@@ -3018,13 +4423,14 @@ private:
         return rc >= 0;
     }
 
-    // Recursive folder delete that shows the current child name as we go
-    static bool removeDirRecursiveProgress(const std::string& dir, KernelFileExplorer* self) {
+    // Recursive folder delete that shows the current child name as we go.
+    // Raw sceIo walk on one PathBuf; the wrapper invalidates the cached tree once.
+    static bool removeDirRecursiveProgress(PathBuf& dir, KernelFileExplorer* self) {
         SceUID d = pspIoOpenDir(dir.c_str());
         if (d < 0) {
             // If open fails, try removing the directory itself (may already be empty/inaccessible)
             if (self && self->msgBox) {
-                self->msgBox->showProgress(basenameOf(dir).c_str(), 0, 1);
+                self->msgBox->showProgress(dir.leaf(), 0, 1);
                 self->renderOneFrame();
             }
             bool ok = (sceIoRmdir(dir.c_str()) >= 0);
@@ -3042,7 +4448,7 @@ private:
                 memset(&ent, 0, sizeof(ent));
                 continue;
             }
-            std::string child = joinDirFile(dir, ent.d_name);
+            if (!dir.push(ent.d_name)) { ok = false; break; }
 
             // Update label to current child before removing
             if (self && self->msgBox) {
@@ -3051,12 +4457,12 @@ private:
             }
 
             if (FIO_S_ISDIR(ent.d_stat.st_mode)) {
-                // Recurse into subdir first
-                ok = removeDirRecursiveProgress(child, self);
-                if (ok) ok = (sceIoRmdir(child.c_str()) >= 0);
+                // Recurse into subdir first; it removes the subdir itself
+                ok = removeDirRecursiveProgress(dir, self);
             } else {
-                ok = (sceIoRemove(child.c_str()) >= 0);
+                ok = (sceIoRemove(dir.c_str()) >= 0);
             }
+            dir.pop();
 
             // Mark this item finished
             if (self && self->msgBox) {
@@ -3072,7 +4478,7 @@ private:
         // Finally remove the now-empty parent directory itself (show its name as a cue)
         if (ok) {
             if (self && self->msgBox) {
-                self->msgBox->showProgress(basenameOf(dir).c_str(), 0, 1);
+                self->msgBox->showProgress(dir.leaf(), 0, 1);
                 self->renderOneFrame();
             }
             ok = (sceIoRmdir(dir.c_str()) >= 0);
@@ -3084,6 +4490,13 @@ private:
 
         return ok;
     }
+    static bool removeDirRecursiveProgress(const std::string& dir, KernelFileExplorer* self) {
+        PathBuf p(dir);
+        if (!p.fits) return false;
+        bool ok = removeDirRecursiveProgress(p, self);
+        gDirCache.invalidateTree(dir);
+        return ok;
+    }
 
     // Delete one path (file or folder) with UI updates
     static bool deleteOne(const std::string& path, GameItem::Kind kind, KernelFileExplorer* self) {
@@ -3104,6 +4517,7 @@ private:
         renderOneFrame();
 
         int ok = 0, fail = 0;
+        std::vector<OpDelta> deltas;
         for (size_t i = 0; i < opSrcPaths.size(); ++i) {
             const std::string& p = opSrcPaths[i];
             const GameItem::Kind k = opSrcKinds[i];
@@ -3111,24 +4525,21 @@ private:
             bool okOne = deleteOne(p, k, this);
             if (okOne) {
                 ok++;
-                checked.erase(p);
+                deltas.push_back({ OpDelta::D_Remove, p, std::string(), k });
             } else {
                 fail++;
+                deltas.push_back({ OpDelta::D_Rescan, p, std::string(), k });  // may be half-deleted
             }
             sceKernelDelayThread(0);
         }
 
         delete msgBox; msgBox = nullptr;
 
-        // Refresh the original context (same behavior you had previously)
-        std::string keepDevice = currentDevice;
-        scanDevice(keepDevice);
-        if (hasCategories) {
-            if (view == View_CategoryContents) openCategory(currentCategory);
-            else buildCategoryRows();
-        } else {
-            openDevice(keepDevice);
-        }
+        // Refresh the original context from the in-memory lists
+        int keepSel = selectedIndex, keepScroll = scrollOffset;
+        applyDeltas(deltas);
+        refreshViewFromLists(std::string());
+        clampSelection(keepSel, keepScroll);
 
         // Feedback toast, like Move/Copy
         char res[64];
@@ -3159,7 +4570,7 @@ private:
         SceIoStat dstSt{};
         if (pathExists(dst, &dstSt) && REPLACE_ON_MOVE) {
             if (isDirMode(dstSt)) removeDirRecursive(dst);
-            else sceIoRemove(dst.c_str());
+            else ioRemove(dst.c_str());
         }
 
         if (kind == GameItem::ISO_FILE) {
@@ -3199,6 +4610,7 @@ private:
         renderOneFrame();
 
         int okCount = 0, failCount = 0;
+        std::vector<OpDelta> deltas;
         for (size_t i = 0; i < opSrcPaths.size(); ++i) {
             const std::string& src = opSrcPaths[i];
             const GameItem::Kind k = opSrcKinds[i];
@@ -3207,6 +4619,8 @@ private:
             // (no need for didCross here)
             bool ok = copyOne(src, dst, k, this);
             if (ok) okCount++; else failCount++;
+            if (ok) deltas.push_back({ OpDelta::D_Add,    src, dst, k });
+            else    deltas.push_back({ OpDelta::D_Rescan, dst, std::string(), k });
             sceKernelDelayThread(0);
         }
 
@@ -3236,7 +4650,7 @@ private:
         // --------------------------------------------------------------------
 
         // Restore original context
-        cancelActionRestore();
+        cancelActionRestore(&deltas);
 
         char res[64];
         if (failCount == 0) { snprintf(res, sizeof(res), "Copied %d item(s)", okCount); drawMessage(res, COLOR_GREEN); }
@@ -3247,18 +4661,22 @@ private:
 
 
 
-    // --- helper (NEW): quick probe for any CAT_ on a device ---
+    // --- helper (NEW): any CAT_ on a device? From its category index when its
+    // lists are resident; only a device that was never scanned is probed. ---
     bool deviceHasAnyCategory(const std::string& dev) const {
+        if (!scannedDevice.empty() && sameDevice(dev, scannedDevice) && listsComplete) return hasCategories;
+        auto known = resident.find(dev);
+        if (known != resident.end() && known->second.complete) return known->second.hasCategories;
+
         const char* isoRoots[]  = {"ISO/","ISO/PSP/"};
         const char* gameRoots[] = {"PSP/GAME/","PSP/GAME/PSX/","PSP/GAME/Utility/","PSP/GAME150/"};
 
         auto hasCatIn = [](const std::string& base)->bool {
-            if (!dirExists(base)) return false;
-            bool hit = false;
-            forEachEntry(base, [&](const SceIoDirent &e){
-                if (FIO_S_ISDIR(e.d_stat.st_mode) && startsWithCAT(e.d_name)) hit = true;
-            });
-            return hit;
+            std::vector<DirCacheEntry> ents;
+            if (!gDirCache.list(base, ents)) return false;
+            for (auto& e : ents)
+                if (FIO_S_ISDIR(e.st.st_mode) && startsWithCAT(e.name.c_str())) return true;
+            return false;
         };
 
         for (auto r : isoRoots)  if (hasCatIn(dev + r)) return true;
@@ -3283,6 +4701,7 @@ private:
     }
 
     void startAction(ActionMode mode) {
+        finishScan(/*withPrefetch=*/true);   // the destination may be the other device
         actionMode = mode;
         opPhase    = OP_None;
         opSrcPaths.clear();
@@ -3297,21 +4716,19 @@ private:
         }
 
         // Snapshot selection
-        if (!checked.empty()) {
-            for (auto &p : checked) {
-                opSrcPaths.push_back(p);
-                GameItem::Kind k = GameItem::ISO_FILE;
-                for (auto &gi : workingList) if (gi.path == p) { k = gi.kind; break; }
-                opSrcKinds.push_back(k);
-            }
+        if (checkedCount) {
+            forEachChecked([&](uint32_t id){
+                opSrcPaths.push_back(arena[id].path());
+                opSrcKinds.push_back(arena[id].kind);
+            });
         } else {
             if (selectedIndex < 0 || selectedIndex >= (int)workingList.size()) {
                 msgBox = new MessageBox("No item selected.", okIconTexture, SCREEN_WIDTH, SCREEN_HEIGHT, 1.0f, 20, "OK", 16, 18, 8, 14);
                 actionMode = AM_None;
                 return;
             }
-            opSrcPaths.push_back(workingList[selectedIndex].path);
-            opSrcKinds.push_back(workingList[selectedIndex].kind);
+            opSrcPaths.push_back(row(selectedIndex).path());
+            opSrcKinds.push_back(row(selectedIndex).kind);
         }
 
         // Save UI snapshot so we can restore
@@ -3320,8 +4737,6 @@ private:
         preOpCategory = currentCategory;
         preOpSel      = selectedIndex;
         preOpScroll   = scrollOffset;
-        snapshotCurrentScan(preOpScan);
-        hasPreOpScan = true;
 
         const bool goMs0Mode = dualDeviceAvailableFromMs0();
 
@@ -3354,8 +4769,10 @@ private:
 
 
 
-    void cancelActionRestore() {
-        hasPreOpScan = false;
+    // Restore the pre-op view. The lists come back from memory (resident) and
+    // only the completed operations (if any) are replayed on top of them, on
+    // every resident device.
+    void cancelActionRestore(const std::vector<OpDelta>* deltas = nullptr) {
         // Clear op state
         actionMode = AM_None;
         opPhase    = OP_None;
@@ -3365,18 +4782,43 @@ private:
         opDestCategory.clear();
 
         // Restore UI state
-        scanDevice(preOpDevice);
+        currentDevice = preOpDevice;
+        activateLists(preOpDevice);
+        if (!listsComplete) {
+            scanDevice(preOpDevice);
+        } else if (deltas && !deltas->empty()) {
+            applyDeltas(*deltas);
+        }
+        if (deltas && !deltas->empty()) {
+            std::vector<std::string> parked;
+            for (auto& kv : resident) if (kv.second.complete) parked.push_back(kv.first);
+            for (auto& dev : parked) withParkedLists(dev, [&]{ applyDeltas(*deltas); });
+        }
         if (hasCategories) {
             if (preOpView == View_CategoryContents) {
                 openCategory(preOpCategory.empty() ? "Uncategorized" : preOpCategory);
             } else {
+                currentCategory = preOpCategory;
                 buildCategoryRows();
             }
         } else {
-            openDevice(preOpDevice);
+            showDeviceLists();
         }
-        selectedIndex = preOpSel;
-        scrollOffset  = preOpScroll;
+        clampSelection(preOpSel, preOpScroll);
+    }
+
+    void clampSelection(int sel, int scroll) {
+        const int n = rowCount();
+        if (sel >= n) sel = n - 1;
+        if (sel < 0) sel = 0;
+        int maxScroll = n - MAX_DISPLAY;
+        if (maxScroll < 0) maxScroll = 0;
+        if (scroll > maxScroll) scroll = maxScroll;
+        if (scroll > sel) scroll = sel;
+        if (sel >= scroll + MAX_DISPLAY) scroll = sel - MAX_DISPLAY + 1;
+        if (scroll < 0) scroll = 0;
+        selectedIndex = sel;
+        scrollOffset  = scroll;
     }
 
     void showConfirmAndRun() {
@@ -3441,6 +4883,7 @@ private:
         renderOneFrame();
 
         int okCount = 0, failCount = 0;
+        std::vector<OpDelta> deltas;
         for (size_t i = 0; i < opSrcPaths.size(); ++i) {
             const std::string& src = opSrcPaths[i];
             const GameItem::Kind k = opSrcKinds[i];
@@ -3450,8 +4893,18 @@ private:
             if (!sameDevice(src, dst)) didCross = true;
 
             bool ok = moveOne(src, dst, k, this);
-            if (ok) { okCount++; checked.erase(src); }
+            if (ok) {
+                okCount++;
+                if (sameDevice(src, dst)) catalogFor(src).rename(src, dst);
+            }
             else    { failCount++; }
+            if (ok) {
+                deltas.push_back({ OpDelta::D_Move, src, dst, k });
+            } else {
+                // a failed move can leave a partial copy behind on either side
+                deltas.push_back({ OpDelta::D_Rescan, src, std::string(), k });
+                deltas.push_back({ OpDelta::D_Rescan, dst, std::string(), k });
+            }
             sceKernelDelayThread(0);
         }
 
@@ -3462,7 +4915,7 @@ private:
         // didCross already computed inside the loop
 
         // Refresh original context
-        cancelActionRestore(); // also resets actionMode/opPhase and rebuilds UI
+        cancelActionRestore(&deltas); // also resets actionMode/opPhase and rebuilds UI
 
         // Only refresh free-space cache if a cross-device operation occurred,
         // and only when we're in PSP Go ms0 mode with both devices.
@@ -3496,9 +4949,13 @@ private:
     // -----------------------------------------------------------
     // Input handling
     // -----------------------------------------------------------
+    friend struct HostBench;   // app/bench/scan_bench.cpp
+
 public:
     KernelFileExplorer(){ detectRoots(); buildRootRows(); }
     ~KernelFileExplorer(){
+        cancelScan();
+        if (scanLock >= 0) sceKernelDeleteSema(scanLock);
         if (font) intraFontUnload(font);
         freeSelectionIcon();
         if (placeholderIconTexture) { texFree(placeholderIconTexture); placeholderIconTexture = nullptr; }
@@ -3511,6 +4968,18 @@ public:
         // (OSK/Move already boost via ClockGuard; this makes it global.)
         scePowerSetClockFrequency(333, 333, 166);
     #endif
+        hbInit((size_t)APP_HEAP_KB * 1024);
+        hbAddShrinker(HB_Caches, [](void*){ gDirCache.trim(gDirCache.size() / 2); }, nullptr);
+        hbAddShrinker(HB_Caches, FolderSizeTrim, nullptr);
+        hbAddShrinker(HB_CLASSES, dropParkedLists, this);
+        hbSetFatalHandler([](size_t bytes) {
+            HeapStats st; hbGetStats(st);
+            logfOnce("heap: out of memory for a %u B node; heap %u/%u KB, slabs %u KB (%u KB in use), %u failure(s)",
+                     (unsigned)bytes, (unsigned)(st.heapUsed / 1024), (unsigned)(st.heapTotal / 1024),
+                     (unsigned)(st.smallSlabs / 1024), (unsigned)(st.smallUsed / 1024), st.failures);
+        });
+        FolderSizeInit();   // before the first scan seeds the size cache
+        titles.start(this);
 
         sceGuInit(); sceGuStart(GU_DIRECT,list);
         sceGuDrawBuffer(GU_PSM_8888,(void*)0,512);
@@ -3578,13 +5047,13 @@ public:
             // Square + Left  => Select all
             if (pressed & PSP_CTRL_LEFT) {
                 // mark every visible item
-                for (const auto& gi : workingList) checked.insert(gi.path);
+                for (uint32_t id : workingList) setChecked(id, true);
                 return;  // swallow input
             }
 
             // Square + Right => Unselect all
             if (pressed & PSP_CTRL_RIGHT) {
-                checked.clear();
+                clearChecked();
                 return;  // swallow input
             }
 
@@ -3613,7 +5082,7 @@ public:
                     int j = selectedIndex - 1;
                     if (!showRoots && opPhase == OP_SelectCategory) {
                         while (j >= 0 &&
-                               opDisabledCategories.find(entries[j].d_name) != opDisabledCategories.end())
+                               opDisabledCategories.find(dirRows[j]) != opDisabledCategories.end())
                             j--;
                     } else if (showRoots && opPhase == OP_SelectDevice) {
                         while (j >= 0 && (rowFlags[j] & ROW_DISABLED)) j--;
@@ -3622,16 +5091,16 @@ public:
                 }
             }
             if ((pressed & PSP_CTRL_DOWN) || repeatDown) {
-                if (selectedIndex + 1 < (int)entries.size()) {
+                if (selectedIndex + 1 < rowCount()) {
                     int j = selectedIndex + 1;
                     if (!showRoots && opPhase == OP_SelectCategory) {
-                        while (j < (int)entries.size() &&
-                               opDisabledCategories.find(entries[j].d_name) != opDisabledCategories.end())
+                        while (j < rowCount() &&
+                               opDisabledCategories.find(dirRows[j]) != opDisabledCategories.end())
                             j++;
                     } else if (showRoots && opPhase == OP_SelectDevice) {
-                        while (j < (int)entries.size() && (rowFlags[j] & ROW_DISABLED)) j++;
+                        while (j < rowCount() && (rowFlags[j] & ROW_DISABLED)) j++;
                     }
-                    if (j < (int)entries.size()) {
+                    if (j < rowCount()) {
                         selectedIndex = j;
                         if (selectedIndex >= scrollOffset + MAX_DISPLAY) scrollOffset = selectedIndex - MAX_DISPLAY + 1;
                     }
@@ -3684,7 +5153,7 @@ public:
                     }
 
                     // proceed with your existing selection flow:
-                    opDestDevice = entries[selectedIndex].d_name; // "ms0:/" or "ef0:/"
+                    opDestDevice = dirRows[selectedIndex]; // "ms0:/" or "ef0:/"
 
                     // NEW: on PSP Go running from ms0, begin a background probe of the OPPOSITE device now.
                     if (!runningFromEf0) {
@@ -3696,45 +5165,35 @@ public:
                         }
                     }
 
-                    if (hasPreOpScan && strcasecmp(opDestDevice.c_str(), preOpDevice.c_str()) == 0) {
-                        // Same device as the one we were already viewing → reuse instantly
-                        restoreScan(preOpScan);
-
-                        if (hasCategories) {
-                            buildCategoryRowsForOp();
-                            opPhase = OP_SelectCategory;
-                        } else {
-                            opDestCategory.clear();
-                            showConfirmAndRun();
-                        }
-                    } else {
-                        // Different device → do a real scan (keep your existing behavior)
+                    // Destination lists are resident (browsed or prefetched); scan only if not.
+                    activateLists(opDestDevice);
+                    if (!listsComplete) {
                         msgBox = new MessageBox("Scanning destination...", nullptr, SCREEN_WIDTH, SCREEN_HEIGHT, 1.0f, 0, "", 16, 18, 8, 14);
                         renderOneFrame();
                         scanDevice(opDestDevice);
                         delete msgBox; msgBox = nullptr;
+                    }
 
-                        if (hasCategories) {
-                            buildCategoryRowsForOp();
-                            opPhase = OP_SelectCategory;
-                        } else {
-                            opDestCategory.clear();
-                            showConfirmAndRun();
-                        }
+                    if (hasCategories) {
+                        buildCategoryRowsForOp();
+                        opPhase = OP_SelectCategory;
+                    } else {
+                        opDestCategory.clear();
+                        showConfirmAndRun();
                     }
                     return;
                 }
                 else if (opPhase == OP_SelectCategory) {
-                    if (selectedIndex < 0 || selectedIndex >= (int)entries.size()) return;
+                    if (selectedIndex < 0 || selectedIndex >= rowCount()) return;
 
                     // Block X on a disabled category
-                    if (opDisabledCategories.find(entries[selectedIndex].d_name) != opDisabledCategories.end()) {
+                    if (opDisabledCategories.find(dirRows[selectedIndex]) != opDisabledCategories.end()) {
                         msgBox = new MessageBox("Cannot choose the source category.", okIconTexture,
                                                 SCREEN_WIDTH, SCREEN_HEIGHT, 1.0f, 20, "OK", 16, 18, 8, 14);
                         return;
                     }
 
-                    std::string cat = entries[selectedIndex].d_name;
+                    std::string cat = dirRows[selectedIndex];
                     if (!strcasecmp(cat.c_str(), "Uncategorized")) opDestCategory.clear();
                     else opDestCategory = cat;
                     if (opDestDevice.empty()) opDestDevice = preOpDevice; // same-device move/copy
@@ -3759,8 +5218,8 @@ public:
             // Freeze background free-space probes so the UI can react instantly
             FreeSpacePauseNow();
 
-            if (selectedIndex >= 0 && selectedIndex < (int)entries.size()) {
-                openCategory(entries[selectedIndex].d_name);
+            if (selectedIndex >= 0 && selectedIndex < rowCount()) {
+                openCategory(dirRows[selectedIndex]);
             }
 
             // Category view is ready — let the probe continue
@@ -3779,10 +5238,8 @@ public:
         if (pressed & PSP_CTRL_SQUARE) {
             if (!showRoots && (view == View_AllFlat || view == View_CategoryContents) &&
                 selectedIndex >= 0 && selectedIndex < (int)workingList.size()) {
-                const std::string& p = workingList[selectedIndex].path;
-                auto it = checked.find(p);
-                if (it == checked.end()) checked.insert(p);
-                else                     checked.erase(it);
+                const uint32_t id = workingList[selectedIndex];
+                setChecked(id, !isChecked(id));
             }
             return;
         }
@@ -3807,7 +5264,8 @@ public:
         if (pressed & PSP_CTRL_SELECT) {
             if (!showRoots && (view == View_AllFlat || view == View_CategoryContents)) {
                 moving = false;
-                sortWorkingListAlpha(showTitles, workingList, selectedIndex, scrollOffset);
+                if (showTitles && !fillTitlesFor(workingList)) return;
+                sortWorkingListAlpha(showTitles, arena, workingList, selectedIndex, scrollOffset);
                 refillRowsFromWorkingPreserveSel();
             }
             return;
@@ -3875,7 +5333,7 @@ public:
                     if (selectedIndex >= scrollOffset + MAX_DISPLAY) scrollOffset = selectedIndex - MAX_DISPLAY + 1;
                     refillRowsFromWorkingPreserveSel();
                 } else {
-                    if (selectedIndex + 1 < (int)entries.size()){
+                    if (selectedIndex + 1 < rowCount()){
                         selectedIndex++;
                         if (selectedIndex >= scrollOffset + MAX_DISPLAY) scrollOffset = selectedIndex - MAX_DISPLAY + 1;
                     }
@@ -3883,13 +5341,13 @@ public:
             } else {
                 if (showRoots) {
                     int j = selectedIndex + 1;
-                    while (j < (int)entries.size() && (rowFlags[j] & ROW_DISABLED)) j++;
-                    if (j < (int)entries.size()) {
+                    while (j < rowCount() && (rowFlags[j] & ROW_DISABLED)) j++;
+                    if (j < rowCount()) {
                         selectedIndex = j;
                         if (selectedIndex >= scrollOffset + MAX_DISPLAY) scrollOffset = selectedIndex - MAX_DISPLAY + 1;
                     }
                 } else {
-                    if (selectedIndex + 1 < (int)entries.size()){
+                    if (selectedIndex + 1 < rowCount()){
                         selectedIndex++;
                         if (selectedIndex >= scrollOffset + MAX_DISPLAY) scrollOffset = selectedIndex - MAX_DISPLAY + 1;
                     }
@@ -3899,19 +5357,19 @@ public:
 
         // X / O default behaviors
         if (pressed & PSP_CTRL_CROSS) {
-            if (selectedIndex < 0 || selectedIndex >= (int)entries.size()) return;
+            if (selectedIndex < 0 || selectedIndex >= rowCount()) return;
 
             if (showRoots) {
                 if (selectedIndex < (int)rowFlags.size() && (rowFlags[selectedIndex] & ROW_DISABLED)) {
                     return;
                 }
-                std::string dev = entries[selectedIndex].d_name; // ms0:/ or ef0:/
+                std::string dev = dirRows[selectedIndex]; // ms0:/ or ef0:/
                 openDevice(dev);
                 return;
             }
 
             if (view == View_Categories) {
-                if (FIO_S_ISDIR(entries[selectedIndex].d_stat.st_mode)) openCategory(entries[selectedIndex].d_name);
+                if (rowIsDir(selectedIndex)) openCategory(dirRows[selectedIndex]);
             } else {
                 moving = !moving;
             }
@@ -3923,14 +5381,14 @@ public:
                 if (moving) {
                     moving = false;
                 } else {
-                    checked.clear();
+                    clearChecked();
                     buildCategoryRows();
                 }
             } else if (view == View_AllFlat) {
                 if (moving) {
                     moving = false;
                 } else {
-                    if (roots.size() > 1) checked.clear();
+                    if (roots.size() > 1) clearChecked();
                     buildRootRows();
                 }
             } else if (view == View_Categories) {
@@ -3942,8 +5400,20 @@ public:
 
     void run(){
         init();
+        restoreSession();
+        bool firstListLogged = false;
         while (1) {
+            if (gExitRequested && !gSessionSaved) { saveSession(); gSessionSaved = 1; }
+            pumpScan();
+            pumpSizes();
+            pumpTitles();
+            pumpHeap();
             renderOneFrame();
+            if (!firstListLogged && !showRoots && rowCount() > 0) {
+                firstListLogged = true;
+                logfOnce("startup: first usable list after %llu ms (%s start)",
+                         (nowUS() - gLaunchUS) / 1000ULL, warmStart ? "warm" : "cold");
+            }
 
             // Handle active dialogs
             if (msgBox) {
@@ -3982,19 +5452,18 @@ public:
                     } else if (choice == 1) { // Copy
                         startAction(AM_Copy);
                     } else if (choice == 2) { // Delete
+                        finishScan();
                         // Build delete set (checked or current)
                         std::vector<std::string> delPaths;
                         std::vector<GameItem::Kind> delKinds;
-                        if (!checked.empty()) {
-                            for (auto &p : checked) {
-                                delPaths.push_back(p);
-                                GameItem::Kind k = GameItem::ISO_FILE;
-                                for (auto &gi : workingList) if (gi.path == p) { k = gi.kind; break; }
-                                delKinds.push_back(k);
-                            }
+                        if (checkedCount) {
+                            forEachChecked([&](uint32_t id){
+                                delPaths.push_back(arena[id].path());
+                                delKinds.push_back(arena[id].kind);
+                            });
                         } else if (selectedIndex >= 0 && selectedIndex < (int)workingList.size()) {
-                            delPaths.push_back(workingList[selectedIndex].path);
-                            delKinds.push_back(workingList[selectedIndex].kind);
+                            delPaths.push_back(row(selectedIndex).path());
+                            delKinds.push_back(row(selectedIndex).kind);
                         }
 
                         if (delPaths.empty()) {
@@ -4033,6 +5502,7 @@ int LoadStartModule(const char *path) {
 }
 
 int main(int argc, char* argv[]) {
+    gLaunchUS = nowUS();
     LoadStartModule("fs_driver.prx");
     SetupCallbacks();
     gExecPath = argv[0];
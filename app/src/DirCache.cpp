@@ -0,0 +1,185 @@
+// DirCache.cpp
+// Session cache of directory listings (see DirCache.h). Replaces repeated
+// open/read/close passes in the case-insensitive finders and existence
+// checks with hash lookups.
+
+#include <pspiofilemgr.h>
+#include <pspthreadman.h>
+#include <string.h>
+#include <ctype.h>
+
+#include "DirCache.h"
+
+extern "C" {
+    int pspIoOpenDir(const char *dirname);
+    int pspIoReadDir(SceUID dir, SceIoDirent *dirent);
+    int pspIoCloseDir(SceUID dir);
+}
+
+DirCache gDirCache;
+
+static const size_t DIRCACHE_MAX_DIRS = 128;   // oldest listings are dropped beyond this
+
+static std::string lowerOf(const std::string& s) {
+    std::string r(s);
+    for (auto& c : r) c = (char)tolower((unsigned char)c);
+    return r;
+}
+static std::string stripSlash(const std::string& p) {
+    std::string r(p);
+    while (!r.empty() && r[r.size()-1] == '/') r.erase(r.size()-1);   // "ms0:/" → "ms0:"
+    return r;
+}
+static bool splitParent(const std::string& pathNoSlash, std::string& parent, std::string& leaf) {
+    size_t s = pathNoSlash.find_last_of('/');
+    if (s == std::string::npos) return false;        // device root has no parent listing
+    parent = pathNoSlash.substr(0, s);
+    leaf   = pathNoSlash.substr(s + 1);
+    return !leaf.empty();
+}
+
+struct DirCacheGuard {
+    SceUID id;
+    explicit DirCacheGuard(SceUID i) : id(i) { if (id >= 0) sceKernelWaitSema(id, 1, nullptr); }
+    ~DirCacheGuard() { if (id >= 0) sceKernelSignalSema(id, 1); }
+};
+
+DirCache::DirCache() {
+    _lock = sceKernelCreateSema("KFE_DirCacheLock", 0, 1, 1, nullptr);
+}
+
+DirCache::~DirCache() {
+    if (_lock >= 0) sceKernelDeleteSema(_lock);
+}
+
+const DirCache::Listing* DirCache::cached(const std::string& dirNoSlash) {
+    auto it = _dirs.find(lowerOf(dirNoSlash));
+    return (it == _dirs.end()) ? nullptr : &it->second;
+}
+
+const DirCache::Listing& DirCache::load(const std::string& dirNoSlash) {
+    const std::string key = lowerOf(dirNoSlash);
+    auto it = _dirs.find(key);
+    if (it != _dirs.end()) { ++_hits; return it->second; }
+    ++_misses;
+
+    while (_dirs.size() >= DIRCACHE_MAX_DIRS && !_order.empty()) {
+        _dirs.erase(_order.front());
+        _order.pop_front();
+    }
+
+    Listing& l = _dirs[key];
+    _order.push_back(key);
+    std::string openPath = dirNoSlash;
+    if (!openPath.empty() && openPath[openPath.size()-1] == ':') openPath += "/";
+    SceUID d = pspIoOpenDir(openPath.c_str());
+    if (d < 0) return l;
+    l.exists = true;
+    SceIoDirent ent; memset(&ent, 0, sizeof(ent));
+    while (pspIoReadDir(d, &ent) > 0) {
+        if (strcmp(ent.d_name, ".") && strcmp(ent.d_name, "..")) {
+            DirCacheEntry& e = l.byName[lowerOf(ent.d_name)];
+            e.name = ent.d_name;
+            e.st   = ent.d_stat;
+        }
+        memset(&ent, 0, sizeof(ent));
+    }
+    pspIoCloseDir(d);
+    return l;
+}
+
+void DirCache::erase(const std::string& key) {
+    if (!_dirs.erase(key)) return;
+    for (auto it = _order.begin(); it != _order.end(); ++it)
+        if (*it == key) { _order.erase(it); break; }
+}
+
+bool DirCache::dirExists(const std::string& dir) {
+    const std::string p = stripSlash(dir);
+    DirCacheGuard g(_lock);
+    if (const Listing* own = cached(p)) { ++_hits; return own->exists; }
+    std::string parent, leaf;
+    if (splitParent(p, parent, leaf)) {
+        if (const Listing* up = cached(parent)) {
+            ++_hits;
+            auto it = up->byName.find(lowerOf(leaf));
+            return it != up->byName.end() && FIO_S_ISDIR(it->second.st.st_mode);
+        }
+    }
+    return load(p).exists;
+}
+
+bool DirCache::stat(const std::string& path, SceIoStat* out) {
+    const std::string p = stripSlash(path);
+    std::string parent, leaf;
+    if (!splitParent(p, parent, leaf)) {
+        SceIoStat st{}; int rc = sceIoGetstat(path.c_str(), &st);
+        if (rc >= 0 && out) *out = st;
+        return rc >= 0;
+    }
+    DirCacheGuard g(_lock);
+    const Listing& up = load(parent);
+    auto it = up.byName.find(lowerOf(leaf));
+    if (it == up.byName.end()) return false;
+    if (out) *out = it->second.st;
+    return true;
+}
+
+std::string DirCache::find(const std::string& dir, const char* name, bool wantDir, SceIoStat* outSt) {
+    const std::string p = stripSlash(dir);
+    DirCacheGuard g(_lock);
+    const Listing& l = load(p);
+    auto it = l.byName.find(lowerOf(name));
+    if (it == l.byName.end() || (FIO_S_ISDIR(it->second.st.st_mode) != 0) != wantDir) return std::string();
+    if (outSt) *outSt = it->second.st;
+    return p + "/" + it->second.name;
+}
+
+bool DirCache::list(const std::string& dir, std::vector<DirCacheEntry>& out) {
+    out.clear();
+    DirCacheGuard g(_lock);
+    const Listing& l = load(stripSlash(dir));
+    if (!l.exists) return false;
+    out.reserve(l.byName.size());
+    for (auto& kv : l.byName) out.push_back(kv.second);
+    return true;
+}
+
+void DirCache::invalidateEntry(const std::string& path) {
+    const std::string p = stripSlash(path);
+    DirCacheGuard g(_lock);
+    erase(lowerOf(p));                       // a cached "missing" listing for p itself
+    std::string parent, leaf;
+    if (splitParent(p, parent, leaf)) erase(lowerOf(parent));
+}
+
+void DirCache::invalidateTree(const std::string& dir) {
+    const std::string p = stripSlash(dir);
+    const std::string key = lowerOf(p), below = key + "/";
+    DirCacheGuard g(_lock);
+    for (auto it = _order.begin(); it != _order.end(); ) {   // _order holds exactly the cached keys
+        if (*it == key || it->compare(0, below.size(), below) == 0) { _dirs.erase(*it); it = _order.erase(it); }
+        else ++it;
+    }
+    std::string parent, leaf;
+    if (splitParent(p, parent, leaf)) erase(lowerOf(parent));
+}
+
+void DirCache::clear() {
+    DirCacheGuard g(_lock);
+    _dirs.clear();
+    _order.clear();
+}
+
+void DirCache::trim(size_t keepDirs) {
+    DirCacheGuard g(_lock);
+    while (_dirs.size() > keepDirs && !_order.empty()) {
+        _dirs.erase(_order.front());
+        _order.pop_front();
+    }
+}
+
+size_t DirCache::size() {
+    DirCacheGuard g(_lock);
+    return _dirs.size();
+}
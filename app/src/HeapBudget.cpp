@@ -0,0 +1,319 @@
+// HeapBudget.cpp
+// Budgets, small-object slabs and cache trimming for the app heap (see
+// HeapBudget.h).
+
+#include <pspthreadman.h>
+#include <malloc.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "HeapBudget.h"
+
+// Soft per-class budgets; together they leave room for fonts, the item
+// lists and the string pool in the 4 MB heap.
+static const size_t BUDGET_KB[HB_CLASSES] = {
+    1536,   // textures: background, checkboxes, the selection icon
+    768,    // I/O buffers: one 512 KB copy buffer plus a fallback
+    640,    // catalog entries
+    384,    // directory listings, folder sizes
+};
+static const char* const CLASS_NAMES[HB_CLASSES] = { "tex", "io", "cat", "cache" };
+static const size_t HEAP_LOW = 256 * 1024;   // trim caches when less than this is free
+
+enum {
+    SLAB_SIZE     = 4096,   // also the slab alignment: an object's slab is its address rounded down
+    SMALL_STEP    = 8,
+    SMALL_CLASSES = SMALL_MAX / SMALL_STEP,
+    MAX_SHRINKERS = 8,
+    TICK_PERIOD   = 30,     // frames between unprompted checks
+    EMPTY_SLABS_KEPT = 16,  // empty slabs hbTick() leaves for reuse
+    WORKER_RETRIES   = 10,  // a worker out of memory waits this many times for the UI thread to trim
+    WORKER_RETRY_US  = 50 * 1000
+};
+
+namespace {
+struct Shrinker { HeapClass cls; HeapShrinker fn; void* ctx; };
+
+// Slab header; objects of one size class follow it.
+struct Slab {
+    Slab*    next;          // class list of slabs with free objects
+    Slab*    prev;
+    void*    free;          // free objects in this slab
+    unsigned used;          // objects handed out
+};
+const size_t SLAB_HDR = (sizeof(Slab) + SMALL_STEP - 1) & ~(size_t)(SMALL_STEP - 1);
+
+// Plain zero-initialised data (no constructor): usable during static
+// initialisation, before hbInit() has created the lock.
+struct HeapState {
+    size_t   used[HB_CLASSES];
+    size_t   peak[HB_CLASSES];
+    size_t   heapTotal, heapPeak;
+    size_t   smallSlabs, smallUsed;
+    Slab*    partial[SMALL_CLASSES];   // slabs with at least one free object
+    unsigned emptySlabs;
+    Shrinker shrinkers[MAX_SHRINKERS];
+    int      nShrinkers;
+    unsigned trims, failures, tick;
+    volatile bool pressure;   // raised by any thread, handled by hbTick()
+    bool     locked;          // hbInit() created the lock; it guards everything above
+    SceLwMutexWorkarea lock;  // user-mode mutex: no syscall unless contended
+    SceUID   uiThread;
+    HeapFatalFn onFatal;
+};
+HeapState g;
+
+struct HeapGuard {
+    HeapGuard()  { if (g.locked) sceKernelLockLwMutex(&g.lock, 1, nullptr); }
+    ~HeapGuard() { if (g.locked) sceKernelUnlockLwMutex(&g.lock, 1); }
+};
+}
+
+static size_t budget(int c) { return BUDGET_KB[c] * 1024; }
+
+// Caller holds the lock.
+static void charge(HeapClass c, ptrdiff_t delta) {
+    if (c >= HB_CLASSES) return;
+    g.used[c] += delta;
+    if (g.used[c] > g.peak[c]) g.peak[c] = g.used[c];
+    if (g.used[c] > budget(c)) g.pressure = true;
+}
+
+static size_t heapUsed() {
+    const struct mallinfo mi = mallinfo();
+    return (size_t)mi.uordblks;
+}
+static size_t heapFree() {
+    const size_t u = heapUsed();
+    if (u > g.heapPeak) g.heapPeak = u;
+    return (u < g.heapTotal) ? g.heapTotal - u : 0;
+}
+static bool onUiThread() {
+    return g.uiThread > 0 && sceKernelGetThreadId() == g.uiThread;
+}
+
+// Give empty slabs back to malloc, keeping up to `keep` for reuse.
+static void releaseEmptySlabs(unsigned keep) {
+    HeapGuard lk;
+    for (int k = 0; k < SMALL_CLASSES && g.emptySlabs > keep; ++k) {
+        for (Slab* s = g.partial[k]; s && g.emptySlabs > keep; ) {
+            Slab* next = s->next;
+            if (s->used == 0) {
+                if (s->prev) s->prev->next = s->next; else g.partial[k] = s->next;
+                if (s->next) s->next->prev = s->prev;
+                free(s);
+                g.smallSlabs -= SLAB_SIZE;
+                --g.emptySlabs;
+            }
+            s = next;
+        }
+    }
+}
+
+static bool relieved(HeapClass c, size_t want) {
+    if (c != HB_CLASSES) { HeapGuard lk; return g.used[c] <= budget(c); }
+    return heapFree() >= want + HEAP_LOW;
+}
+
+// Run shrinkers until class c is back under budget, or for HB_CLASSES until
+// the heap has `want` bytes plus the low-water mark free. Pooled nodes the
+// shrinkers free only turn into heap once their slab is empty, so empty
+// slabs are released after each one. UI thread only, never under the lock.
+static void trim(HeapClass c, size_t want) {
+    bool ran = false;
+    for (int i = 0; i < g.nShrinkers && !relieved(c, want); ++i) {
+        const Shrinker& s = g.shrinkers[i];
+        if (c != HB_CLASSES && s.cls != c) continue;
+        s.fn(s.ctx);
+        releaseEmptySlabs(0);
+        ran = true;
+    }
+    if (ran) ++g.trims;
+}
+
+// malloc()/memalign() that tries to make room before failing: the UI
+// thread trims, a worker raises pressure and waits for hbTick() to do it.
+static void* allocRetry(size_t n, size_t align) {
+    void* p = align ? memalign(align, n) : malloc(n);
+    if (p) return p;
+    if (onUiThread()) {
+        trim(HB_CLASSES, n);
+        return align ? memalign(align, n) : malloc(n);
+    }
+    for (int i = 0; !p && i < WORKER_RETRIES; ++i) {
+        g.pressure = true;
+        sceKernelDelayThread(WORKER_RETRY_US);
+        p = align ? memalign(align, n) : malloc(n);
+    }
+    return p;
+}
+
+void hbInit(size_t heapBytes) {
+    g.heapTotal = heapBytes;
+    g.uiThread  = sceKernelGetThreadId();
+    if (!g.locked) g.locked = sceKernelCreateLwMutex(&g.lock, "KFE_HeapLock", 0, 0, nullptr) >= 0;
+}
+
+void* hbAlloc(HeapClass c, size_t n, size_t align) {
+    const bool ui = onUiThread();
+    bool over;
+    {
+        HeapGuard lk;
+        over = g.used[c] + n > budget(c);
+    }
+    if (over) {
+        if (ui) trim(c, n);
+        else    g.pressure = true;
+    }
+    void* p = align ? memalign(align, n) : malloc(n);
+    if (!p && ui) {
+        trim(HB_CLASSES, n);
+        p = align ? memalign(align, n) : malloc(n);
+    }
+    HeapGuard lk;
+    if (p) charge(c, (ptrdiff_t)n);
+    else { ++g.failures; g.pressure = true; }
+    return p;
+}
+
+void hbFree(HeapClass c, void* p, size_t n) {
+    if (!p) return;
+    free(p);
+    HeapGuard lk;
+    charge(c, -(ptrdiff_t)n);
+}
+
+void hbCharge(HeapClass c, ptrdiff_t delta) {
+    HeapGuard lk;
+    charge(c, delta);
+}
+
+void hbAddShrinker(HeapClass c, HeapShrinker fn, void* ctx) {
+    if (g.nShrinkers >= MAX_SHRINKERS) return;
+    g.shrinkers[g.nShrinkers++] = Shrinker{ c, fn, ctx };
+}
+
+void hbTick() {
+    if (++g.tick % TICK_PERIOD && !g.pressure) return;
+    g.pressure = false;
+    for (int c = 0; c < HB_CLASSES; ++c)
+        if (!relieved((HeapClass)c, 0)) trim((HeapClass)c, 0);
+    if (heapFree() < HEAP_LOW) trim(HB_CLASSES, 0);
+    releaseEmptySlabs(EMPTY_SLABS_KEPT);
+}
+
+void hbGetStats(HeapStats& out) {
+    const size_t u = heapUsed();
+    HeapGuard lk;
+    for (int c = 0; c < HB_CLASSES; ++c) {
+        out.used[c]   = g.used[c];
+        out.peak[c]   = g.peak[c];
+        out.budget[c] = budget(c);
+    }
+    if (u > g.heapPeak) g.heapPeak = u;
+    out.heapUsed   = u;
+    out.heapPeak   = g.heapPeak;
+    out.heapTotal  = g.heapTotal;
+    out.smallSlabs = g.smallSlabs;
+    out.smallUsed  = g.smallUsed;
+    out.trims      = g.trims;
+    out.failures   = g.failures;
+}
+
+unsigned hbFailures() { return g.failures; }
+
+void hbSetFatalHandler(HeapFatalFn fn) { g.onFatal = fn; }
+
+void hbOutOfMemory(size_t n) {
+    {
+        HeapGuard lk;
+        ++g.failures;
+    }
+    if (g.onFatal) g.onFatal(n);
+    sceKernelExitGame();
+    for (;;) sceKernelSleepThread();
+}
+
+const char* hbClassName(HeapClass c) {
+    return (c < HB_CLASSES) ? CLASS_NAMES[c] : "heap";
+}
+
+// Take an object from class k (lock held); nullptr if no slab has one.
+static void* takeSmall(unsigned k, size_t sz, HeapClass c) {
+    Slab* s = g.partial[k];
+    if (!s) return nullptr;
+    void* p = s->free;
+    s->free = *(void**)p;
+    if (s->used++ == 0) --g.emptySlabs;
+    if (!s->free) {                          // full: off the list until something is freed
+        g.partial[k] = s->next;
+        if (s->next) s->next->prev = nullptr;
+        s->next = s->prev = nullptr;
+    }
+    g.smallUsed += sz;
+    charge(c, (ptrdiff_t)sz);
+    return p;
+}
+
+void* smallAlloc(size_t n, HeapClass c) {
+    if (n == 0) n = 1;
+    if (n > SMALL_MAX) {
+        void* p = allocRetry(n, 0);
+        HeapGuard lk;
+        if (p) charge(c, (ptrdiff_t)n);
+        else { ++g.failures; g.pressure = true; }
+        return p;
+    }
+    const unsigned k  = (unsigned)((n - 1) / SMALL_STEP);
+    const size_t   sz = (size_t)(k + 1) * SMALL_STEP;
+    {
+        HeapGuard lk;
+        if (void* p = takeSmall(k, sz, c)) return p;
+    }
+
+    // New slab, allocated outside the lock: trimming frees pooled nodes.
+    Slab* s = (Slab*)allocRetry(SLAB_SIZE, SLAB_SIZE);
+    HeapGuard lk;
+    if (!s) { ++g.failures; g.pressure = true; return nullptr; }
+    s->used = 0;
+    s->free = nullptr;
+    for (size_t off = SLAB_HDR + ((SLAB_SIZE - SLAB_HDR) / sz - 1) * sz; ; off -= sz) {   // carve, lowest address on top
+        *(void**)((char*)s + off) = s->free;
+        s->free = (char*)s + off;
+        if (off == SLAB_HDR) break;
+    }
+    s->prev = nullptr;
+    s->next = g.partial[k];
+    if (s->next) s->next->prev = s;
+    g.partial[k] = s;
+    g.smallSlabs += SLAB_SIZE;
+    ++g.emptySlabs;
+    return takeSmall(k, sz, c);
+}
+
+void smallFree(void* p, size_t n, HeapClass c) {
+    if (!p) return;
+    if (n == 0) n = 1;
+    if (n > SMALL_MAX) {
+        free(p);
+        HeapGuard lk;
+        charge(c, -(ptrdiff_t)n);
+        return;
+    }
+    const unsigned k  = (unsigned)((n - 1) / SMALL_STEP);
+    const size_t   sz = (size_t)(k + 1) * SMALL_STEP;
+    Slab* s = (Slab*)((uintptr_t)p & ~(uintptr_t)(SLAB_SIZE - 1));
+
+    HeapGuard lk;
+    if (!s->free) {                          // was full: back on its class list
+        s->prev = nullptr;
+        s->next = g.partial[k];
+        if (s->next) s->next->prev = s;
+        g.partial[k] = s;
+    }
+    *(void**)p = s->free;
+    s->free = p;
+    if (--s->used == 0) ++g.emptySlabs;      // released by trim() / hbTick()
+    g.smallUsed -= sz;
+    charge(c, -(ptrdiff_t)sz);
+}
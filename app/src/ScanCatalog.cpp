@@ -0,0 +1,230 @@
+// ScanCatalog.cpp
+// Persistent per-device metadata catalog. Lets scanDevice serve titles,
+// disc IDs, folder sizes and container layouts for unchanged entries
+// without re-opening (and re-decoding) every image on each scan.
+//
+// File layout (little-endian), <dev>KFE_catalog.bin:
+//   u32 magic 'KFEC', u32 version, u32 count, then per entry:
+//   u16 pathLen, path, u64 keySize, u64 mtimeKey, u64 bytes,
+//   u8 kind, u8 format, u8 align, u8 method, u32 blockSize, u32 indexOff,
+//   u16 titleLen, title, u8 discIdLen, discId
+
+#include <pspiofilemgr.h>
+#include <pspthreadman.h>
+#include <string.h>
+#include <vector>
+
+#include "ScanCatalog.h"
+#include "DirCache.h"
+#include "ByteIO.h"
+
+static const uint32_t CATALOG_MAGIC   = 0x4345464B; // 'KFEC'
+static const uint32_t CATALOG_VERSION = 1;
+static const char*    CATALOG_NAME    = "KFE_catalog.bin";
+
+uint64_t packDateTime(const ScePspDateTime& dt) {
+    // 14b year | 4b month | 5b day | 5b hour | 6b min | 6b sec | 20b usec
+    uint64_t k = (uint64_t)(dt.year & 0x3FFF);
+    k = (k << 4)  | (dt.month  & 0xF);
+    k = (k << 5)  | (dt.day    & 0x1F);
+    k = (k << 5)  | (dt.hour   & 0x1F);
+    k = (k << 6)  | (dt.minute & 0x3F);
+    k = (k << 6)  | (dt.second & 0x3F);
+    k = (k << 20) | (dt.microsecond & 0xFFFFF);
+    return k;
+}
+
+ScePspDateTime unpackDateTime(uint64_t k) {
+    ScePspDateTime dt;
+    memset(&dt, 0, sizeof(dt));
+    dt.microsecond = (unsigned int)(k & 0xFFFFF);  k >>= 20;
+    dt.second      = (unsigned short)(k & 0x3F);   k >>= 6;
+    dt.minute      = (unsigned short)(k & 0x3F);   k >>= 6;
+    dt.hour        = (unsigned short)(k & 0x1F);   k >>= 5;
+    dt.day         = (unsigned short)(k & 0x1F);   k >>= 5;
+    dt.month       = (unsigned short)(k & 0xF);    k >>= 4;
+    dt.year        = (unsigned short)(k & 0x3FFF);
+    return dt;
+}
+
+ScanCatalog::ScanCatalog() {
+    _lock = sceKernelCreateSema("KFE_CatalogLock", 0, 1, 1, nullptr);
+}
+
+ScanCatalog::~ScanCatalog() {
+    if (_lock >= 0) sceKernelDeleteSema(_lock);
+}
+
+ScanCatalog::Guard::Guard(SceUID i) : id(i) { if (id >= 0) sceKernelWaitSema(id, 1, nullptr); }
+ScanCatalog::Guard::~Guard() { if (id >= 0) sceKernelSignalSema(id, 1); }
+
+void ScanCatalog::open(const std::string& dev) {
+    Guard g(_lock);
+    if (dev == _dev) return;
+    if (_dirty) saveLocked();
+    _entries.clear();
+    _dirty = false;
+    _dev = dev;
+    resetStats();
+    load();
+}
+
+bool ScanCatalog::load() {
+    if (_dev.empty()) return false;
+    std::string path = _dev + CATALOG_NAME;
+    SceUID fd = sceIoOpen(path.c_str(), PSP_O_RDONLY, 0);
+    if (fd < 0) return false;
+
+    int end = sceIoLseek32(fd, 0, PSP_SEEK_END);
+    sceIoLseek32(fd, 0, PSP_SEEK_SET);
+    if (end <= 12 || end > 4 * 1024 * 1024) { sceIoClose(fd); return false; }
+
+    std::vector<uint8_t> buf((size_t)end);
+    int got = sceIoRead(fd, buf.data(), (SceSize)buf.size());
+    sceIoClose(fd);
+    if (got != end) return false;
+
+    Reader r(buf.data(), buf.size());
+    if (r.u32() != CATALOG_MAGIC || r.u32() != CATALOG_VERSION) return false;
+    uint32_t count = r.u32();
+
+    _entries.reserve(count);
+    for (uint32_t i = 0; i < count && r.ok; ++i) {
+        std::string path; r.str(path, r.u16());
+        CatalogEntry e;
+        e.keySize          = r.u64();
+        e.mtimeKey         = r.u64();
+        e.bytes            = r.u64();
+        e.kind             = r.u8();
+        e.params.format    = r.u8();
+        e.params.align     = r.u8();
+        e.params.method    = r.u8();
+        e.params.blockSize = r.u32();
+        e.params.indexOff  = r.u32();
+        r.str(e.title,  r.u16());
+        r.str(e.discId, r.u8());
+        if (r.ok) _entries[path] = e;   // a truncated tail simply drops the partial record
+    }
+    return true;
+}
+
+bool ScanCatalog::save() {
+    Guard g(_lock);
+    return saveLocked();
+}
+
+bool ScanCatalog::saveLocked() {
+    if (_dev.empty() || !_dirty) return true;
+
+    std::vector<uint8_t> b;
+    b.reserve(16 + _entries.size() * 96);
+    putU32(b, CATALOG_MAGIC);
+    putU32(b, CATALOG_VERSION);
+    putU32(b, (uint32_t)_entries.size());
+    for (auto& kv : _entries) {
+        const CatalogEntry& e = kv.second;
+        putU16(b, (uint16_t)kv.first.size()); putStr(b, kv.first);
+        putU64(b, e.keySize);
+        putU64(b, e.mtimeKey);
+        putU64(b, e.bytes);
+        putU8 (b, e.kind);
+        putU8 (b, e.params.format);
+        putU8 (b, e.params.align);
+        putU8 (b, e.params.method);
+        putU32(b, e.params.blockSize);
+        putU32(b, e.params.indexOff);
+        putU16(b, (uint16_t)e.title.size());  putStr(b, e.title);
+        putU8 (b, (uint8_t)e.discId.size());  putStr(b, e.discId);
+    }
+
+    std::string path = _dev + CATALOG_NAME;
+    SceUID fd = sceIoOpen(path.c_str(), PSP_O_WRONLY | PSP_O_CREAT | PSP_O_TRUNC, 0666);
+    if (fd < 0) return false;
+    int w = sceIoWrite(fd, b.data(), (SceSize)b.size());
+    sceIoClose(fd);
+    gDirCache.invalidateEntry(path);
+    if (w != (int)b.size()) return false;
+    _dirty = false;
+    return true;
+}
+
+bool ScanCatalog::lookup(const std::string& path, uint64_t keySize, uint64_t mtimeKey, CatalogEntry& out) {
+    Guard g(_lock);
+    auto it = _entries.find(path);
+    if (it == _entries.end() || it->second.keySize != keySize || it->second.mtimeKey != mtimeKey) {
+        ++_misses;
+        return false;
+    }
+    ++_hits;
+    it->second.seen = true;
+    out = it->second;
+    return true;
+}
+
+void ScanCatalog::store(const std::string& path, const CatalogEntry& e) {
+    Guard g(_lock);
+    CatalogEntry& dst = _entries[path];
+    dst = e;
+    dst.seen = true;
+    _dirty = true;
+}
+
+void ScanCatalog::setBytes(const std::string& path, uint64_t mtimeKey, uint64_t bytes) {
+    Guard g(_lock);
+    auto it = _entries.find(path);
+    if (it == _entries.end() || it->second.mtimeKey != mtimeKey || it->second.bytes == bytes) return;
+    it->second.bytes = bytes;
+    _dirty = true;
+}
+
+void ScanCatalog::touch(const std::string& path, uint64_t newMtimeKey) {
+    Guard g(_lock);
+    auto it = _entries.find(path);
+    if (it == _entries.end() || it->second.mtimeKey == newMtimeKey) return;
+    it->second.mtimeKey = newMtimeKey;
+    _dirty = true;
+}
+
+void ScanCatalog::rename(const std::string& from, const std::string& to) {
+    Guard g(_lock);
+    auto it = _entries.find(from);
+    if (it == _entries.end()) return;
+    CatalogEntry e = it->second;
+    _entries.erase(it);
+    _entries[to] = e;
+    _dirty = true;
+}
+
+void ScanCatalog::renamePrefix(const std::string& fromDir, const std::string& toDir) {
+    Guard g(_lock);
+    std::vector<std::pair<std::string, CatalogEntry>> moved;
+    for (auto it = _entries.begin(); it != _entries.end(); ) {
+        if (it->first.compare(0, fromDir.size(), fromDir) == 0) {
+            moved.emplace_back(toDir + it->first.substr(fromDir.size()), it->second);
+            it = _entries.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    for (auto& m : moved) _entries[m.first] = m.second;
+    if (!moved.empty()) _dirty = true;
+}
+
+void ScanCatalog::erase(const std::string& path) {
+    Guard g(_lock);
+    if (_entries.erase(path)) _dirty = true;
+}
+
+void ScanCatalog::beginScan() {
+    Guard g(_lock);
+    for (auto& kv : _entries) kv.second.seen = false;
+    resetStats();
+}
+
+void ScanCatalog::pruneUnseen() {
+    Guard g(_lock);
+    for (auto it = _entries.begin(); it != _entries.end(); ) {
+        if (!it->second.seen) { it = _entries.erase(it); _dirty = true; }
+        else ++it;
+    }
+}
@@ -0,0 +1,85 @@
+// Session.cpp
+// Last-session snapshot for a warm start (see Session.h).
+//
+// File layout (little-endian), ms0:/KFE_session.bin (ef0:/ if ms0 is absent):
+//   u32 magic 'KFES', u32 version, u8 devLen, device, u8 view, u8 showTitles,
+//   u16 catLen, category, u32 selected, u32 scroll, u32 rowCount, then per row:
+//   u16 pathLen, path
+
+#include <pspiofilemgr.h>
+#include <string.h>
+
+#include "Session.h"
+#include "DirCache.h"
+#include "ByteIO.h"
+
+static const uint32_t SESSION_MAGIC   = 0x5345464B; // 'KFES'
+static const uint32_t SESSION_VERSION = 1;
+static const char* const SESSION_PATHS[] = { "ms0:/KFE_session.bin", "ef0:/KFE_session.bin" };
+
+bool sessionLoad(SessionSnapshot& out) {
+    SceUID fd = -1;
+    for (const char* p : SESSION_PATHS)
+        if ((fd = sceIoOpen(p, PSP_O_RDONLY, 0)) >= 0) break;
+    if (fd < 0) return false;
+
+    int end = sceIoLseek32(fd, 0, PSP_SEEK_END);
+    sceIoLseek32(fd, 0, PSP_SEEK_SET);
+    if (end <= 8 || end > 1024 * 1024) { sceIoClose(fd); return false; }
+
+    std::vector<uint8_t> buf((size_t)end);
+    int got = sceIoRead(fd, buf.data(), (SceSize)buf.size());
+    sceIoClose(fd);
+    if (got != end) return false;
+
+    Reader r(buf.data(), buf.size());
+    if (r.u32() != SESSION_MAGIC || r.u32() != SESSION_VERSION) return false;
+    r.str(out.device, r.u8());
+    out.view       = r.u8();
+    out.showTitles = r.u8() != 0;
+    r.str(out.category, r.u16());
+    out.selected   = (int32_t)r.u32();
+    out.scroll     = (int32_t)r.u32();
+    const uint32_t count = r.u32();
+    if (!r.ok) return false;
+    out.rows.clear();
+    out.rows.reserve(count);
+    for (uint32_t i = 0; i < count && r.ok; ++i) {
+        std::string path; r.str(path, r.u16());
+        if (r.ok) out.rows.push_back(path);
+    }
+    return !out.device.empty();
+}
+
+bool sessionSave(const SessionSnapshot& s) {
+    std::vector<uint8_t> b;
+    size_t est = 32 + s.device.size() + s.category.size();
+    for (auto& p : s.rows) est += 2 + p.size();
+    b.reserve(est);
+    putU32(b, SESSION_MAGIC);
+    putU32(b, SESSION_VERSION);
+    putU8 (b, (uint8_t)s.device.size());     putStr(b, s.device);
+    putU8 (b, s.view);
+    putU8 (b, s.showTitles ? 1 : 0);
+    putU16(b, (uint16_t)s.category.size());  putStr(b, s.category);
+    putU32(b, (uint32_t)s.selected);
+    putU32(b, (uint32_t)s.scroll);
+    putU32(b, (uint32_t)s.rows.size());
+    for (auto& p : s.rows) { putU16(b, (uint16_t)p.size()); putStr(b, p); }
+
+    for (const char* p : SESSION_PATHS) {
+        SceUID fd = sceIoOpen(p, PSP_O_WRONLY | PSP_O_CREAT | PSP_O_TRUNC, 0666);
+        if (fd < 0) continue;
+        int w = sceIoWrite(fd, b.data(), (SceSize)b.size());
+        sceIoClose(fd);
+        gDirCache.invalidateEntry(p);
+        return w == (int)b.size();
+    }
+    return false;
+}
+
+void sessionClear() {
+    for (const char* p : SESSION_PATHS) {
+        if (sceIoRemove(p) >= 0) gDirCache.invalidateEntry(p);
+    }
+}
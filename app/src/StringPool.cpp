@@ -0,0 +1,104 @@
+// StringPool.cpp
+// Interned string storage for the item lists (see StringPool.h). Keeps
+// per-item heap use to a fixed-size record plus shared, packed text.
+
+#include <pspthreadman.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "StringPool.h"
+
+StringPool gStrings;
+
+static uint32_t fnv1a(const char* s, size_t n) {
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < n; ++i) { h ^= (uint8_t)s[i]; h *= 16777619u; }
+    return h;
+}
+
+StringPool::StringPool() {
+    memset(_blocks, 0, sizeof(_blocks));
+    _blocks[0] = (char*)malloc(BLOCK_SIZE);
+    if (_blocks[0]) { _blocks[0][0] = '\0'; _nBlocks = 1; _used = 1; }   // ID 0 = ""
+    _table.assign(1024, 0);
+    _lock = sceKernelCreateSema("KFE_StrPoolLock", 0, 1, 1, nullptr);
+}
+
+StringPool::~StringPool() {
+    for (uint32_t i = 0; i < _nBlocks; ++i) free(_blocks[i]);
+    if (_lock >= 0) sceKernelDeleteSema(_lock);
+}
+
+size_t StringPool::bytes() const {
+    return (size_t)_nBlocks * BLOCK_SIZE + _table.size() * sizeof(uint32_t);
+}
+
+// Length first: strnlen stops at the entry's NUL, so neither call reads past
+// the stored text (or the end of its block) when the entry is shorter.
+bool StringPool::equals(uint32_t id, const char* s, size_t n) const {
+    const char* p = str(id);
+    return strnlen(p, n + 1) == n && memcmp(p, s, n) == 0;
+}
+
+void StringPool::grow() {
+    std::vector<uint32_t> old;
+    old.swap(_table);
+    _table.assign(old.size() * 2, 0);
+    const size_t mask = _table.size() - 1;
+    for (uint32_t id : old) {
+        if (!id) continue;
+        const char* p = str(id);
+        size_t i = fnv1a(p, strlen(p)) & mask;
+        while (_table[i]) i = (i + 1) & mask;
+        _table[i] = id;
+    }
+}
+
+uint32_t StringPool::find(const char* s, size_t n) const {
+    if (n == 0 || !_nBlocks) return 0;
+    if (n > MAX_LEN) n = MAX_LEN;
+    const uint32_t h = fnv1a(s, n);
+
+    if (_lock >= 0) sceKernelWaitSema(_lock, 1, nullptr);
+    const size_t mask = _table.size() - 1;
+    uint32_t id = 0;
+    for (size_t i = h & mask; _table[i]; i = (i + 1) & mask)
+        if (equals(_table[i], s, n)) { id = _table[i]; break; }
+    if (_lock >= 0) sceKernelSignalSema(_lock, 1);
+    return id;
+}
+
+uint32_t StringPool::intern(const char* s, size_t n) {
+    if (n == 0 || !_nBlocks) return 0;
+    if (n > MAX_LEN) n = MAX_LEN;
+    const uint32_t h = fnv1a(s, n);
+
+    if (_lock >= 0) sceKernelWaitSema(_lock, 1, nullptr);
+    size_t mask = _table.size() - 1;
+    size_t i = h & mask;
+    while (_table[i]) {
+        if (equals(_table[i], s, n)) {
+            uint32_t id = _table[i];
+            if (_lock >= 0) sceKernelSignalSema(_lock, 1);
+            return id;
+        }
+        i = (i + 1) & mask;
+    }
+
+    uint32_t id = 0;
+    if (_used + n + 1 > BLOCK_SIZE && _nBlocks < MAX_BLOCKS) {
+        char* b = (char*)malloc(BLOCK_SIZE);
+        if (b) { _blocks[_nBlocks++] = b; _used = 0; }
+    }
+    if (_used + n + 1 <= BLOCK_SIZE) {
+        char* dst = _blocks[_nBlocks - 1] + _used;
+        memcpy(dst, s, n);
+        dst[n] = '\0';
+        id = ((_nBlocks - 1) << BLOCK_SHIFT) | _used;
+        _used += (uint32_t)n + 1;
+        _table[i] = id;
+        if (++_count * 2 > _table.size()) grow();
+    }
+    if (_lock >= 0) sceKernelSignalSema(_lock, 1);
+    return id;   // 0 ("") only when the pool is out of memory
+}
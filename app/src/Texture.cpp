@@ -2,10 +2,14 @@
 #include <pspgu.h>
 #include <string.h>
 #include <malloc.h>
+#include "HeapBudget.h"
 
 #define STB_IMAGE_IMPLEMENTATION
 #include <stb_image.h>   // you already have this in ../libs/include
 
+static int potOf(int v) { int p = 1; while (p < v) p <<= 1; return p; }
+static size_t pixelBytes(int tw, int th) { return (size_t)tw * th * 4; }
+
 Texture* texLoadPNG(const char* path) {
     int w=0, h=0, comp=0;
     unsigned char* pix = stbi_load(path, &w, &h, &comp, STBI_rgb_alpha);
@@ -16,7 +20,7 @@ Texture* texLoadPNG(const char* path) {
     int th = 1; while (th < h) th <<= 1;
 
     // 16-byte align for GU
-    uint32_t* p2buf = (uint32_t*)memalign(16, tw * th * 4);
+    uint32_t* p2buf = (uint32_t*)hbAlloc(HB_Textures, pixelBytes(tw, th), 16);
     if (!p2buf) { stbi_image_free(pix); return nullptr; }
     memset(p2buf, 0, tw * th * 4);
 
@@ -25,8 +29,8 @@ Texture* texLoadPNG(const char* path) {
     }
     stbi_image_free(pix);
 
-    Texture* t = (Texture*)malloc(sizeof(Texture));
-    if (!t) { free(p2buf); return nullptr; }
+    Texture* t = (Texture*)hbAlloc(HB_Textures, sizeof(Texture));
+    if (!t) { hbFree(HB_Textures, p2buf, pixelBytes(tw, th)); return nullptr; }
     t->width  = w;
     t->height = h;
     t->stride = tw;
@@ -36,8 +40,8 @@ Texture* texLoadPNG(const char* path) {
 
 void texFree(Texture* t) {
     if (!t) return;
-    if (t->data) free(t->data);
-    free(t);
+    if (t->data) hbFree(HB_Textures, t->data, pixelBytes(t->stride, potOf(t->height)));
+    hbFree(HB_Textures, t, sizeof(Texture));
 }
 
 Texture* texLoadPNGFromMemory(const unsigned char* data, int len) {
@@ -48,15 +52,15 @@ Texture* texLoadPNGFromMemory(const unsigned char* data, int len) {
     int tw = 1; while (tw < w) tw <<= 1;
     int th = 1; while (th < h) th <<= 1;
 
-    uint32_t* p2buf = (uint32_t*)memalign(16, tw * th * 4);
+    uint32_t* p2buf = (uint32_t*)hbAlloc(HB_Textures, pixelBytes(tw, th), 16);
     if (!p2buf) { stbi_image_free(pix); return nullptr; }
     memset(p2buf, 0, tw * th * 4);
 
     for (int y = 0; y < h; ++y) memcpy(p2buf + y * tw, pix + y * w * 4, w * 4);
     stbi_image_free(pix);
 
-    Texture* t = (Texture*)malloc(sizeof(Texture));
-    if (!t) { free(p2buf); return nullptr; }
+    Texture* t = (Texture*)hbAlloc(HB_Textures, sizeof(Texture));
+    if (!t) { hbFree(HB_Textures, p2buf, pixelBytes(tw, th)); return nullptr; }
     t->width  = w;
     t->height = h;
     t->stride = tw;
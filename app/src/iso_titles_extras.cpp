@@ -5,10 +5,13 @@
 //   - CSO v1 / ZSO (global method) and CSO v2 (per-block method, per maxcso docs)
 //   - JSO (LZO / zlib; robust probing)
 //   - DAX (8K deflate frames)
+// All of them are read through one BlockDevice (shared block cache and
+// read-ahead); only block decoding is per format.
 //
 // PSP/PSPSDK-friendly (sceIo*, SceUID, etc.)
 
 #include <pspiofilemgr.h>
+#include <pspthreadman.h>
 #include <string>
 #include <vector>
 #include <string.h>
@@ -21,6 +24,7 @@ extern "C" {
 }
 
 #include "lz4.h"
+#include "iso_titles_extras.h"
 
 #ifndef ISO_SECTOR
 #define ISO_SECTOR 2048
@@ -76,7 +80,7 @@ struct SFOIndex {
 };
 #pragma pack(pop)
 
-static bool sfoExtractTitle(const uint8_t* data, size_t size, std::string& outTitle) {
+bool sfoExtractString(const uint8_t* data, size_t size, const char* wantKey, std::string& out) {
     if (!data || size < sizeof(SFOHeader)) return false;
     const SFOHeader* h = (const SFOHeader*)data;
     if (h->magic != 0x46535000) return false; // 'PSF\0'
@@ -88,20 +92,24 @@ static bool sfoExtractTitle(const uint8_t* data, size_t size, std::string& outTi
 
     for (uint32_t i=0;i<h->indexCount;i++) {
         const char* key = keys + idx[i].keyOffset;
-        if (key && strcmp(key, "TITLE") == 0) {
+        if (key && strcmp(key, wantKey) == 0) {
             const uint8_t* v = vals + idx[i].dataOffset;
             uint32_t len = idx[i].dataLen;
             if ((size_t)(v - data) + len <= size) {
                 std::string s((const char*)v, (const char*)v + len);
                 while (!s.empty() && (s.back() == '\0' || s.back() == ' ')) s.pop_back();
-                outTitle = s;
-                return !outTitle.empty();
+                out = s;
+                return !out.empty();
             }
         }
     }
     return false;
 }
 
+static bool sfoExtractTitle(const uint8_t* data, size_t size, std::string& outTitle) {
+    return sfoExtractString(data, size, "TITLE", outTitle);
+}
+
 // ================================================================
 // ISO-9660 helpers used once we can read sectors
 // ================================================================
@@ -131,291 +139,480 @@ static bool isoReadDirRec(const uint8_t* p, size_t n, size_t off,
 }
 
 template<typename ReadSectorsFn>
-static bool isoFindEntry(ReadSectorsFn readSectors,
-                         void* ctx,
-                         const IsoDirRec& dir,
-                         const char* target,
-                         IsoDirRec& out)
+static bool isoFindEntries(ReadSectorsFn readSectors,
+                           void* ctx,
+                           const IsoDirRec& dir,
+                           const char* const* targets,
+                           IsoDirRec* outs,
+                           bool* found,
+                           int count)
 {
     uint32_t bytes = ((dir.size + ISO_SECTOR - 1)/ISO_SECTOR)*ISO_SECTOR;
     std::vector<uint8_t> buf(bytes);
     if (!readSectors(ctx, dir.lba, bytes/ISO_SECTOR, buf.data())) return false;
 
+    int left = 0;
+    for (int i = 0; i < count; ++i) { found[i] = false; if (targets[i]) ++left; }
+
     size_t pos = 0;
-    while (pos < bytes) {
+    while (pos < bytes && left > 0) {
         if (buf[pos] == 0) { pos = ((pos/ISO_SECTOR)+1)*ISO_SECTOR; continue; }
         IsoDirRec r{}; std::string nm; bool isDir=false;
         if (!isoReadDirRec(buf.data(), bytes, pos, r, nm, isDir)) break;
-        if (!nm.empty() && strcasecmp(nm.c_str(), target) == 0) { out = r; return true; }
+        if (!nm.empty()) {
+            for (int i = 0; i < count; ++i) {
+                if (!targets[i] || found[i] || strcasecmp(nm.c_str(), targets[i]) != 0) continue;
+                outs[i] = r; found[i] = true; --left;
+                break;
+            }
+        }
         pos += buf[pos];
     }
-    return false;
+    return left == 0;
 }
 
 template<typename ReadSectorsFn>
-static bool readTitleViaSectors(ReadSectorsFn readSectors, void* ctx, std::string& outTitle)
+static bool isoFindEntry(ReadSectorsFn readSectors,
+                         void* ctx,
+                         const IsoDirRec& dir,
+                         const char* target,
+                         IsoDirRec& out)
 {
-    // PVD @ sector 16
-    std::vector<uint8_t> pvd(ISO_SECTOR);
-    if (!readSectors(ctx, 16, 1, pvd.data())) return false;
-    if (!(pvd[0]==1 && memcmp(&pvd[1],"CD001",5)==0 && pvd[6]==1)) return false;
+    bool found = false;
+    return isoFindEntries(readSectors, ctx, dir, &target, &out, &found, 1);
+}
 
-    // root dir @156
-    IsoDirRec root{}; { std::string nm; bool isDir=false;
-        if (!isoReadDirRec(pvd.data(), ISO_SECTOR, 156, root, nm, isDir)) return false; }
+// ----------------------------------------------------------------
+// Metadata read-ahead. On PSP discs the PVD, the path tables and the
+// root and PSP_GAME directory extents normally sit within a few
+// sectors after LBA 16, so one large read up front replaces the
+// dependent PVD -> root -> PSP_GAME round-trips.
+// ----------------------------------------------------------------
+#define ISO_META_LBA     16
+#define ISO_META_SECTORS 16   // 32 KB window: LBA 16..31
+#define ISO_META_GAP     8    // PARAM.SFO/ICON0.PNG this close are fetched in one read
 
-    // PSP_GAME/PARAM.SFO
-    IsoDirRec pspGame{}; if (!isoFindEntry(readSectors, ctx, root, "PSP_GAME", pspGame)) return false;
-    IsoDirRec param{};   if (!isoFindEntry(readSectors, ctx, pspGame, "PARAM.SFO", param)) return false;
-    if (param.size == 0 || param.size > 512*1024) return false;
+template<typename ReadSectorsFn>
+struct IsoMetaWindow {
+    ReadSectorsFn        readSectors;
+    void*                ctx;
+    std::vector<uint8_t> buf;
+    uint32_t             count = 0;   // sectors held, starting at ISO_META_LBA
+
+    IsoMetaWindow(ReadSectorsFn fn, void* c) : readSectors(fn), ctx(c) {}
+
+    // A tiny image (or a reader that fails past EOF) falls back to the PVD alone.
+    bool prime() {
+        buf.resize(ISO_META_SECTORS * ISO_SECTOR);
+        if (readSectors(ctx, ISO_META_LBA, ISO_META_SECTORS, buf.data())) { count = ISO_META_SECTORS; return true; }
+        if (readSectors(ctx, ISO_META_LBA, 1, buf.data()))                { count = 1; return true; }
+        return false;
+    }
+    const uint8_t* pvd() const { return buf.data(); }
 
-    uint32_t need = ((param.size + ISO_SECTOR - 1)/ISO_SECTOR)*ISO_SECTOR;
-    std::vector<uint8_t> sfo(need);
-    if (!readSectors(ctx, param.lba, need/ISO_SECTOR, sfo.data())) return false;
+    bool read(uint32_t lba, uint32_t n, uint8_t* out) {
+        if (lba >= ISO_META_LBA && lba + n <= ISO_META_LBA + count) {
+            memcpy(out, buf.data() + (lba - ISO_META_LBA) * ISO_SECTOR, n * ISO_SECTOR);
+            return true;
+        }
+        return readSectors(ctx, lba, n, out);
+    }
+};
 
-    return sfoExtractTitle(sfo.data(), param.size, outTitle);
-}
+static inline uint32_t isoSectorsFor(uint32_t size) { return (size + ISO_SECTOR - 1) / ISO_SECTOR; }
 
+// PARAM.SFO (title / DISC_ID) and ICON0.PNG in one walk: the window
+// covers PVD/root/PSP_GAME, a single PSP_GAME listing finds both files,
+// and when they are adjacent on disc both come back in one read.
+// Pass nullptr for what you don't need. Returns false if anything asked
+// for is missing; whatever was found is still filled in.
 template<typename ReadSectorsFn>
-static bool readIconViaSectors(ReadSectorsFn readSectors, void* ctx, std::vector<uint8_t>& outVec)
+static bool readMetaViaSectors(ReadSectorsFn readSectors, void* ctx,
+                               std::string* outTitle, std::string* outDiscId,
+                               std::vector<uint8_t>* outIcon)
 {
-    outVec.clear();
+    if (outIcon) outIcon->clear();
+    const bool wantSfo = outTitle || outDiscId;
 
-    // PVD @16
-    std::vector<uint8_t> pvd(ISO_SECTOR);
-    if (!readSectors(ctx, 16, 1, pvd.data())) return false;
+    IsoMetaWindow<ReadSectorsFn> win(readSectors, ctx);
+    if (!win.prime()) return false;
+    const uint8_t* pvd = win.pvd();
     if (!(pvd[0]==1 && memcmp(&pvd[1],"CD001",5)==0 && pvd[6]==1)) return false;
 
+    auto rd = [&win](void*, uint32_t l, uint32_t c, uint8_t* o)->bool{ return win.read(l, c, o); };
+
     // root dir @156
     IsoDirRec root{}; { std::string nm; bool isDir=false;
-        if (!isoReadDirRec(pvd.data(), ISO_SECTOR, 156, root, nm, isDir)) return false; }
-
-    IsoDirRec pspGame{}; if (!isoFindEntry(readSectors, ctx, root, "PSP_GAME", pspGame)) return false;
-    IsoDirRec icon{};    if (!isoFindEntry(readSectors, ctx, pspGame, "ICON0.PNG", icon)) return false;
-    if (!icon.size || icon.size > 1024*1024) return false;
-
-    uint32_t need = ((icon.size + ISO_SECTOR - 1)/ISO_SECTOR)*ISO_SECTOR;
-    std::vector<uint8_t> tmp(need);
-    if (!readSectors(ctx, icon.lba, need/ISO_SECTOR, tmp.data())) return false;
-
-    outVec.assign(tmp.begin(), tmp.begin() + icon.size);
-    return true;
-}
+        if (!isoReadDirRec(pvd, ISO_SECTOR, 156, root, nm, isDir)) return false; }
+
+    IsoDirRec pspGame{}; if (!isoFindEntry(rd, ctx, root, "PSP_GAME", pspGame)) return false;
+
+    const char* names[2] = { wantSfo ? "PARAM.SFO" : nullptr, outIcon ? "ICON0.PNG" : nullptr };
+    IsoDirRec   recs[2]  = {};
+    bool        found[2] = { false, false };
+    isoFindEntries(rd, ctx, pspGame, names, recs, found, 2);
+    if (found[0] && (recs[0].size == 0 || recs[0].size > 512*1024)) found[0] = false;
+    if (found[1] && (recs[1].size == 0 || recs[1].size > 1024*1024)) found[1] = false;
+
+    // Fetch: one spanning read when the two files are neighbours.
+    std::vector<uint8_t> data[2];
+    if (found[0] && found[1]) {
+        int a = recs[0].lba <= recs[1].lba ? 0 : 1, b = 1 - a;
+        uint32_t aEnd = recs[a].lba + isoSectorsFor(recs[a].size);
+        uint32_t bEnd = recs[b].lba + isoSectorsFor(recs[b].size);
+        if (recs[b].lba >= aEnd && recs[b].lba - aEnd <= ISO_META_GAP) {
+            std::vector<uint8_t> span((bEnd - recs[a].lba) * ISO_SECTOR);
+            if (win.read(recs[a].lba, bEnd - recs[a].lba, span.data())) {
+                data[a].assign(span.begin(), span.begin() + recs[a].size);
+                size_t bOff = (size_t)(recs[b].lba - recs[a].lba) * ISO_SECTOR;
+                data[b].assign(span.begin() + bOff, span.begin() + bOff + recs[b].size);
+            }
+        }
+    }
+    for (int i = 0; i < 2; ++i) {
+        if (!found[i] || !data[i].empty()) continue;
+        uint32_t n = isoSectorsFor(recs[i].size);
+        data[i].resize(n * ISO_SECTOR);
+        if (!win.read(recs[i].lba, n, data[i].data())) { found[i] = false; data[i].clear(); continue; }
+        data[i].resize(recs[i].size);
+    }
 
-// ================================================================
-// Plain ISO title
-// ================================================================
-bool readIsoTitle(const std::string& isoPath, std::string& outTitle) {
-    SceUID fd = sceIoOpen(isoPath.c_str(), PSP_O_RDONLY, 0);
-    if (fd < 0) return false;
-    auto readSec = [](void* vfd, uint32_t lba, uint32_t cnt, uint8_t* out)->bool{
-        return readAt((SceUID)(intptr_t)vfd, lba * ISO_SECTOR, out, cnt * ISO_SECTOR);
-    };
-    bool ok = readTitleViaSectors(readSec, (void*)(intptr_t)fd, outTitle);
-    sceIoClose(fd);
+    bool ok = true;
+    if (wantSfo) {
+        if (!found[0]) ok = false;
+        else {
+            if (outDiscId) sfoExtractString(data[0].data(), data[0].size(), "DISC_ID", *outDiscId);
+            if (outTitle && !sfoExtractTitle(data[0].data(), data[0].size(), *outTitle)) ok = false;
+        }
+    }
+    if (outIcon) {
+        if (!found[1]) ok = false;
+        else outIcon->swap(data[1]);
+    }
     return ok;
 }
 
 // ================================================================
-// CSO/ZSO reader — includes **CSO v2 per-block method** support
-// and a proper block cache for 2K/4K/16K blocks.
+// Block device: one reader for every container. A backend only knows
+// how to decode block n of its format (blockSize bytes); the device
+// owns the file, the block index, a small LRU of decoded blocks, a
+// read-ahead window over the raw file and the decompression scratch,
+// so every format gets the same caching.
 // ================================================================
-#pragma pack(push,1)
-struct CISOHeader {
-    uint32_t magic;        // 'CISO' or 'ZISO'
-    uint32_t header_size;  // offset to index table (v2 requires 0x18)
-    uint64_t total_bytes;  // uncompressed size
-    uint32_t block_size;   // usually 2048 or 16384
-    uint8_t  version;      // 0/1, or 2 (experimental v2)
-    uint8_t  align;        // index_shift (left shift for offsets)
-    uint8_t  reserved[2];
+#define DEV_CACHE_BYTES (64 * 1024)   // decoded blocks kept (at most BlockLru::SLOTS)
+#define DEV_READAHEAD   (32 * 1024)   // raw bytes fetched once a walk goes sequential
+
+// The last few decoded blocks; a multi-sector read (PARAM.SFO,
+// ICON0.PNG) decodes each block once.
+struct BlockLru {
+    enum { SLOTS = 4 };
+    uint32_t block_size = 0;
+    int      nslots = 0;
+    int32_t  blk[SLOTS];          // block index held by each slot, -1 = empty
+    uint32_t used[SLOTS];         // last-use tick
+    uint32_t tick = 0;
+    std::vector<uint8_t> data;    // nslots * block_size
+
+    // (Re)size for bs-byte blocks; drops everything cached.
+    void init(uint32_t bs) {
+        block_size = bs;
+        nslots = (int)(DEV_CACHE_BYTES / bs);
+        if (nslots < 1) nslots = 1;
+        if (nslots > SLOTS) nslots = SLOTS;
+        data.resize((size_t)nslots * bs);
+        for (int i = 0; i < SLOTS; ++i) { blk[i] = -1; used[i] = 0; }
+    }
+    const uint8_t* find(uint32_t b) {
+        for (int i = 0; i < nslots; ++i)
+            if (blk[i] == (int32_t)b) { used[i] = ++tick; return slot(i); }
+        return nullptr;
+    }
+    // Least recently used slot; call fill() on it once the block is in.
+    int victim() {
+        int v = 0;
+        for (int i = 1; i < nslots; ++i) if (used[i] < used[v]) v = i;
+        blk[v] = -1;
+        return v;
+    }
+    uint8_t* slot(int i) { return data.data() + (size_t)i * block_size; }
+    void fill(int i, uint32_t b) { blk[i] = (int32_t)b; used[i] = ++tick; }
+};
+
+// The offset table compressed formats start with: one uint32 per block
+// plus one for the end. Small tables are loaded whole on first use,
+// large ones a window at a time.
+enum {
+    INDEX_WHOLE_MAX = 16 * 1024,   // entries (64 KB)
+    INDEX_WINDOW    = 1024         // entries (4 KB)
+};
+
+struct BlockIndex {
+    uint32_t off   = 0;            // file offset of entry 0
+    uint32_t count = 0;            // entries in the file (blocks + 1)
+    uint32_t first = 0;            // entries [first, first + e.size()) are loaded
+    std::vector<uint32_t> e;
 };
-#pragma pack(pop)
 
-struct CompressedIso {
-    SceUID   fd = -1;
-    bool     isZSO = false;       // ZISO = LZ4 for compressed blocks (v1 semantics)
-    uint8_t  version = 0;         // 0/1 = v1, 2 = v2
-    bool     isCisoV2 = false;    // true when magic 'CISO' and version==2
-    uint32_t block_size = ISO_SECTOR;
-    uint8_t  align = 0;
-    uint32_t index_off = 0;
-    uint32_t file_size = 0;       // for end-guard
-
-    // block cache
-    int32_t  cached_block = -1;
-    std::vector<uint8_t> blockBuf;
+// One inflate context per device, reset between blocks rather than set up
+// and torn down for each. The wrapping that last worked (raw DEFLATE or
+// zlib) is tried first, so a file pays for a wrong guess once.
+struct Inflater {
+    z_stream zs;
+    int      wbits = -MAX_WBITS;   // raw DEFLATE first
+    bool     ready = false;
+
+    Inflater() { memset(&zs, 0, sizeof(zs)); }
+    ~Inflater() { if (ready) inflateEnd(&zs); }
+    Inflater(const Inflater&) = delete;
+    Inflater& operator=(const Inflater&) = delete;
 };
 
-static bool inflateRawOrZlib(const uint8_t* in, uint32_t inLen, uint8_t* out, uint32_t outLen){
-    // Try raw DEFLATE first
-    {
-        z_stream zs; memset(&zs, 0, sizeof(zs));
-        zs.next_in = (Bytef*)in;  zs.avail_in  = inLen;
-        zs.next_out= out;         zs.avail_out = outLen;
-        if (inflateInit2(&zs, -MAX_WBITS) == Z_OK) {
-            int ret = inflate(&zs, Z_FINISH);
-            bool ok = (ret == Z_STREAM_END) && (zs.total_out == outLen);
-            inflateEnd(&zs);
-            if (ok) return true;
+struct BlockDevice;
+typedef bool (*BlockDecodeFn)(BlockDevice& dev, uint32_t blk, uint8_t* out);
+
+struct BlockDevice {
+    SceUID        fd = -1;
+    uint32_t      fileSize = 0;
+    DiscParams    params;            // format, block size, align, method, index offset
+    BlockDecodeFn decode = nullptr;  // nullptr: plain ISO, sectors come straight from the file
+    BlockIndex    index;
+    BlockLru      cache;
+
+    // Compressed blocks are stored back to back: once reads continue where
+    // the last one ended, one DEV_READAHEAD read feeds the next blocks.
+    std::vector<uint8_t> ra;
+    uint32_t      raOff = 0, raLen = 0;
+    uint32_t      nextOff = 0;       // end of the last raw read
+    std::vector<uint8_t> in;         // compressed input the window did not cover
+    Inflater      inflater;
+};
+
+// n raw bytes at off, from the read-ahead window when it covers them.
+static const uint8_t* devInput(BlockDevice& dev, uint32_t off, uint32_t n) {
+    const bool sequential = (off == dev.nextOff);
+    dev.nextOff = off + n;
+    if (dev.raLen && off >= dev.raOff && off + n <= dev.raOff + dev.raLen)
+        return dev.ra.data() + (off - dev.raOff);
+
+    if (sequential && n < DEV_READAHEAD && off < dev.fileSize) {
+        uint32_t len = dev.fileSize - off;
+        if (len > DEV_READAHEAD) len = DEV_READAHEAD;
+        if (len >= n) {
+            dev.ra.resize(DEV_READAHEAD);
+            dev.raLen = 0;
+            if (!readAt(dev.fd, off, dev.ra.data(), len)) return nullptr;
+            dev.raOff = off; dev.raLen = len;
+            return dev.ra.data();
         }
     }
-    // Fallback: zlib-wrapped
-    {
-        z_stream zs; memset(&zs, 0, sizeof(zs));
-        zs.next_in = (Bytef*)in;  zs.avail_in  = inLen;
-        zs.next_out= out;         zs.avail_out = outLen;
-        if (inflateInit(&zs) == Z_OK) {
-            int ret = inflate(&zs, Z_FINISH);
-            bool ok = (ret == Z_STREAM_END) && (zs.total_out == outLen);
-            inflateEnd(&zs);
-            if (ok) return true;
+    if (dev.in.size() < n) dev.in.resize(n);
+    return readAt(dev.fd, off, dev.in.data(), n) ? dev.in.data() : nullptr;
+}
+
+static bool devReadRaw(BlockDevice& dev, uint32_t off, uint8_t* out, uint32_t n) {
+    const uint8_t* p = devInput(dev, off, n);
+    if (!p) return false;
+    memcpy(out, p, n);
+    return true;
+}
+
+// Point the index at off with `entries` entries (0 = unknown), never past
+// the end of the file. Entries already loaded from the same offset are
+// kept, so probing several layouts reads the table once.
+static bool indexSetup(BlockDevice& dev, uint32_t off, uint64_t entries) {
+    BlockIndex& ix = dev.index;
+    if (dev.fileSize > off) {
+        const uint32_t fit = (dev.fileSize - off) / 4;
+        if (!entries || entries > fit) entries = fit;
+    }
+    if (!entries) return false;
+    if (off != ix.off) { ix.e.clear(); ix.first = 0; }
+    ix.off   = off;
+    ix.count = (uint32_t)entries;
+    return true;
+}
+
+static bool indexLoad(BlockDevice& dev, uint32_t first, uint32_t n) {
+    BlockIndex& ix = dev.index;
+    ix.e.resize(n);
+    if (!readAt(dev.fd, ix.off + first * 4, ix.e.data(), (size_t)n * 4)) { ix.e.clear(); return false; }
+    ix.first = first;
+    return true;
+}
+
+// Index entries of block blk and the next one (its end).
+static bool indexPair(BlockDevice& dev, uint32_t blk, uint32_t& i0, uint32_t& i1) {
+    BlockIndex& ix = dev.index;
+    if (blk >= ix.count) return false;
+    const bool haveNext = (blk + 1 < ix.count);
+    const uint32_t last = blk + (haveNext ? 1 : 0);
+    if (blk < ix.first || last >= ix.first + (uint32_t)ix.e.size()) {
+        bool ok;
+        if (ix.count <= INDEX_WHOLE_MAX) ok = indexLoad(dev, 0, ix.count);
+        else {
+            uint32_t n = ix.count - blk;
+            if (n > INDEX_WINDOW) n = INDEX_WINDOW;
+            ok = indexLoad(dev, blk, n);
         }
+        if (!ok) return false;
     }
-    return false;
+    i0 = ix.e[blk - ix.first];
+    if (haveNext) { i1 = ix.e[blk + 1 - ix.first]; return true; }
+    // Last index missing: use file size as end pointer.
+    if (!dev.fileSize) return false;
+    i1 = ((dev.fileSize >> dev.params.align) & 0x7FFFFFFF);
+    return true;
 }
 
-static bool cisoOpen(const std::string& path, CompressedIso& out) {
-    out.fd = sceIoOpen(path.c_str(), PSP_O_RDONLY, 0);
-    if (out.fd < 0) return false;
+// Decoded block blk, from the cache or through the backend.
+static const uint8_t* devBlock(BlockDevice& dev, uint32_t blk) {
+    if (const uint8_t* hit = dev.cache.find(blk)) return hit;
+    const int v = dev.cache.victim();
+    if (!dev.decode(dev, blk, dev.cache.slot(v))) return nullptr;
+    dev.cache.fill(v, blk);
+    return dev.cache.slot(v);
+}
 
-    CISOHeader h{};
-    if (!readAt(out.fd, 0, &h, sizeof(h))) { sceIoClose(out.fd); return false; }
+// Sector lba of a compressed image, inside its cached block.
+static const uint8_t* devSector(BlockDevice& dev, uint32_t lba) {
+    const uint32_t spb = dev.params.blockSize / ISO_SECTOR;  // sectors per block
+    const uint8_t* block = devBlock(dev, lba / spb);
+    return block ? block + (lba % spb) * ISO_SECTOR : nullptr;
+}
 
-    if (h.magic == 0x4F534943 /* 'CISO' */) { out.isZSO = false; out.version = h.version; out.isCisoV2 = (h.version == 2); }
-    else if (h.magic == 0x4F53495A /* 'ZISO' */) { out.isZSO = true; out.version = h.version; out.isCisoV2 = false; }
-    else { sceIoClose(out.fd); return false; }
+static bool devReadSectors(void* vdev, uint32_t lba, uint32_t count, uint8_t* out) {
+    BlockDevice& dev = *(BlockDevice*)vdev;
+    // Plain ISO requests are already one contiguous read.
+    if (!dev.decode) return readAt(dev.fd, lba * ISO_SECTOR, out, count * ISO_SECTOR);
+    for (uint32_t i = 0; i < count; ++i) {
+        const uint8_t* s = devSector(dev, lba + i);
+        if (!s) return false;
+        memcpy(out + i * ISO_SECTOR, s, ISO_SECTOR);
+    }
+    return true;
+}
 
-    if (h.block_size == 0) { sceIoClose(out.fd); return false; }
-    out.block_size = h.block_size;
-    out.align      = h.align;
-    out.index_off  = h.header_size ? (uint32_t)h.header_size : (uint32_t)sizeof(h);
+// True when the current params decode a PVD at LBA 16.
+static bool devProbe(BlockDevice& dev) {
+    const uint32_t bs = dev.params.blockSize;
+    if (bs < ISO_SECTOR || (bs % ISO_SECTOR) != 0) return false;
+    dev.cache.init(bs);
+    const uint8_t* pvd = devSector(dev, 16);
+    return pvd && pvd[0]==1 && memcmp(&pvd[1],"CD001",5)==0 && pvd[6]==1;
+}
 
-    // Record file size (for end-guard)
-    SceIoStat st{};
-    if (sceIoGetstat(path.c_str(), &st) >= 0) out.file_size = (uint32_t)st.st_size;
+// A layout remembered from an earlier open, checked against the PVD. The
+// metadata walk starts at LBA 16, so the check costs no extra decode.
+static bool devTryKnown(BlockDevice& dev, const DiscParams* known, BlockDecodeFn decode) {
+    if (!known || !indexSetup(dev, known->indexOff, 0)) return false;
+    dev.params = *known;
+    dev.decode = decode;
+    return devProbe(dev);
+}
 
-    // Prepare cache buffer
-    out.blockBuf.resize(out.block_size);
-    out.cached_block = -1;
+// One block with the given wrapping (wbits < 0: raw DEFLATE, > 0: zlib).
+static bool inflateAs(Inflater& z, int wbits, const uint8_t* in, uint32_t inLen, uint8_t* out, uint32_t outLen){
+    if (!z.ready) {
+        if (inflateInit2(&z.zs, wbits) != Z_OK) return false;
+        z.ready = true;
+    } else if (inflateReset2(&z.zs, wbits) != Z_OK) {
+        return false;
+    }
+    z.zs.next_in = (Bytef*)in;  z.zs.avail_in  = inLen;
+    z.zs.next_out= out;         z.zs.avail_out = outLen;
+    int ret = inflate(&z.zs, Z_FINISH);
+    return (ret == Z_STREAM_END) && (z.zs.total_out == outLen);
+}
 
+static bool inflateRawOrZlib(Inflater& z, const uint8_t* in, uint32_t inLen, uint8_t* out, uint32_t outLen){
+    if (inflateAs(z, z.wbits, in, inLen, out, outLen)) return true;
+    const int other = (z.wbits < 0) ? MAX_WBITS : -MAX_WBITS;
+    if (!inflateAs(z, other, in, inLen, out, outLen)) return false;
+    z.wbits = other;
     return true;
 }
 
-static void cisoClose(CompressedIso& ci) {
-    if (ci.fd >= 0) sceIoClose(ci.fd);
-    ci.fd = -1;
-    ci.blockBuf.clear();
-    ci.cached_block = -1;
-}
+// ================================================================
+// CSO/ZSO backend — includes **CSO v2 per-block method** support
+// (2K/4K/16K blocks).
+// ================================================================
+#pragma pack(push,1)
+struct CISOHeader {
+    uint32_t magic;        // 'CISO' or 'ZISO'
+    uint32_t header_size;  // offset to index table (v2 requires 0x18)
+    uint64_t total_bytes;  // uncompressed size
+    uint32_t block_size;   // usually 2048 or 16384
+    uint8_t  version;      // 0/1, or 2 (experimental v2)
+    uint8_t  align;        // index_shift (left shift for offsets)
+    uint8_t  reserved[2];
+};
+#pragma pack(pop)
 
-// Decompress/populate a full block into ci.blockBuf (size = block_size).
-static bool cisoFillBlock(CompressedIso& ci, uint32_t blkIdx) {
-    // Each block corresponds to block_size bytes of uncompressed data.
-    // Index table is per *block*, not per 2048 sector.
+// Decompress block blkIdx (block_size bytes of uncompressed data; the
+// index table is per *block*, not per 2048 sector).
+static bool cisoDecode(BlockDevice& dev, uint32_t blkIdx, uint8_t* out) {
+    const DiscParams& p = dev.params;
+    const uint32_t bs = p.blockSize;
     uint32_t i0 = 0, i1 = 0;
-    uint32_t idxOff = ci.index_off + blkIdx * 4;
-    if (!readAt(ci.fd, idxOff,     &i0, 4)) return false;
-    if (!readAt(ci.fd, idxOff + 4, &i1, 4)) {
-        // Last index missing: use file size as end pointer.
-        if (!ci.file_size) return false;
-        i1 = ((ci.file_size >> ci.align) & 0x7FFFFFFF);
-    }
+    if (!indexPair(dev, blkIdx, i0, i1)) return false;
 
-    uint32_t off0 = (i0 & 0x7FFFFFFF) << ci.align;
-    uint32_t off1 = (i1 & 0x7FFFFFFF) << ci.align;
-    if (ci.file_size && (off1 <= off0 || off1 > ci.file_size)) off1 = ci.file_size;
+    uint32_t off0 = (i0 & 0x7FFFFFFF) << p.align;
+    uint32_t off1 = (i1 & 0x7FFFFFFF) << p.align;
+    if (dev.fileSize && (off1 <= off0 || off1 > dev.fileSize)) off1 = dev.fileSize;
 
     uint32_t compSize = (off1 > off0) ? (off1 - off0) : 0;
 
-    if (ci.isCisoV2) {
-        // v2 rule: size >= block_size ⇒ stored, regardless of MSB
-        bool stored = (compSize >= ci.block_size);
-        if (stored) {
-            if (compSize < ci.block_size) return false;
-            return readAt(ci.fd, off0, ci.blockBuf.data(), ci.block_size);
-        }
+    bool stored, methodLZ4;
+    if (p.format == DF_CSO && p.method == 2) {
+        // v2 rule: size >= block_size ⇒ stored, regardless of MSB;
         // compressed: MSB set ⇒ LZ4, clear ⇒ deflate
-        bool methodLZ4 = (i0 & 0x80000000u) != 0;
-        if (compSize == 0 || compSize > 1024*1024) return false;
-        std::vector<uint8_t> in(compSize);
-        if (!readAt(ci.fd, off0, in.data(), compSize)) return false;
-
-        if (methodLZ4) {
-            int r = LZ4_decompress_safe((const char*)in.data(), (char*)ci.blockBuf.data(),
-                                        (int)compSize, (int)ci.block_size);
-            return r == (int)ci.block_size;
-        } else {
-            return inflateRawOrZlib(in.data(), compSize, ci.blockBuf.data(), ci.block_size);
-        }
+        stored    = (compSize >= bs);
+        methodLZ4 = (i0 & 0x80000000u) != 0;
     } else {
         // v1/ZSO semantics: MSB = stored; compressed method is global (ZSO=LZ4, CISO=deflate)
-        bool stored = (i0 & 0x80000000u) != 0;
-
-        if (stored || compSize == ci.block_size) {
-            if (compSize < ci.block_size) return false;
-            return readAt(ci.fd, off0, ci.blockBuf.data(), ci.block_size);
-        }
-
-        if (compSize == 0 || compSize > 1024*1024) return false;
-
-        std::vector<uint8_t> in(compSize);
-        if (!readAt(ci.fd, off0, in.data(), compSize)) return false;
-
-        if (ci.isZSO) {
-            int r = LZ4_decompress_safe((const char*)in.data(), (char*)ci.blockBuf.data(),
-                                        (int)compSize, (int)ci.block_size);
-            return r == (int)ci.block_size;
-        } else {
-            return inflateRawOrZlib(in.data(), compSize, ci.blockBuf.data(), ci.block_size);
-        }
+        stored    = (i0 & 0x80000000u) != 0 || compSize == bs;
+        methodLZ4 = (p.format == DF_ZSO);
     }
-}
-
-// Sector API that serves 2048-byte slices from the cached block.
-static bool cisoReadSectors(CompressedIso& ci, uint32_t lba, uint32_t count, uint8_t* buf) {
-    if (ci.block_size < ISO_SECTOR || (ci.block_size % ISO_SECTOR) != 0) return false;
-    const uint32_t spb = ci.block_size / ISO_SECTOR;  // sectors per block
-
-    for (uint32_t i = 0; i < count; ++i) {
-        uint32_t L      = lba + i;
-        uint32_t blkIdx = L / spb;
-        uint32_t sub    = L % spb;
-
-        if ((int32_t)blkIdx != ci.cached_block) {
-            if (!cisoFillBlock(ci, blkIdx)) return false;
-            ci.cached_block = (int32_t)blkIdx;
-        }
-        memcpy(buf + i * ISO_SECTOR, ci.blockBuf.data() + sub * ISO_SECTOR, ISO_SECTOR);
+    if (stored) {
+        if (compSize < bs) return false;
+        return devReadRaw(dev, off0, out, bs);
     }
-    return true;
-}
+    if (compSize == 0 || compSize > 1024*1024) return false;
 
-bool readCompressedIsoTitle(const std::string& path, std::string& outTitle) {
-    CompressedIso ci;
-    if (!cisoOpen(path, ci)) return false;
+    const uint8_t* in = devInput(dev, off0, compSize);
+    if (!in) return false;
+    if (methodLZ4)
+        return LZ4_decompress_safe((const char*)in, (char*)out, (int)compSize, (int)bs) == (int)bs;
+    return inflateRawOrZlib(dev.inflater, in, compSize, out, bs);
+}
 
-    auto readSec = [](void* vci, uint32_t l, uint32_t c, uint8_t* o)->bool{
-        return cisoReadSectors(*(CompressedIso*)vci, l, c, o);
-    };
-    bool ok = readTitleViaSectors(readSec, &ci, outTitle);
-    cisoClose(ci);
-    return ok;
+static bool cisoOpen(BlockDevice& dev) {
+    CISOHeader h{};
+    if (!readAt(dev.fd, 0, &h, sizeof(h))) return false;
+
+    DiscParams& p = dev.params;
+    if (h.magic == 0x4F534943 /* 'CISO' */)      p.format = DF_CSO;
+    else if (h.magic == 0x4F53495A /* 'ZISO' */) p.format = DF_ZSO;   // LZ4 for compressed blocks (v1 semantics)
+    else return false;
+
+    if (h.block_size == 0) return false;
+    p.blockSize = h.block_size;
+    p.align     = h.align;
+    p.method    = h.version;   // 0/1 = v1, 2 = v2
+    p.indexOff  = h.header_size ? (uint32_t)h.header_size : (uint32_t)sizeof(h);
+    dev.decode  = cisoDecode;
+
+    // Index size: blocks + 1 from the header, never past the end of the file.
+    uint64_t entries = h.total_bytes ? (h.total_bytes + p.blockSize - 1) / p.blockSize + 1 : 0;
+    if (!indexSetup(dev, p.indexOff, entries)) return false;
+    dev.cache.init(p.blockSize);
+    return true;
 }
 
 // ================================================================
-// JSO reader — robust "probe" opener for multiple variants
+// JSO backend — robust "probe" opener for multiple variants
 // ================================================================
-struct JsoCtx {
-    SceUID   fd;
-    uint32_t index_off;
-    uint32_t block_size;
-    uint8_t  align;   // shift for offsets (0..4)
-    uint8_t  method;  // 1=zlib, 2=lzo
-    uint32_t file_size;
-};
-
-static bool jsoDecompress(const uint8_t* in, uint32_t inLen, uint8_t* out, uint32_t outLen, uint8_t method){
+static bool jsoDecompress(Inflater& z, const uint8_t* in, uint32_t inLen, uint8_t* out, uint32_t outLen, uint8_t method){
     if (method == 2) { // LZO
         lzo_uint out_len = outLen;
         int r = lzo1x_decompress_safe(in, inLen, out, &out_len, NULL);
@@ -423,61 +620,62 @@ static bool jsoDecompress(const uint8_t* in, uint32_t inLen, uint8_t* out, uint3
         // fall through to try zlib if header lied
     }
     // method == 1 (zlib) or fallback
-    return inflateRawOrZlib(in, inLen, out, outLen);
+    return inflateRawOrZlib(z, in, inLen, out, outLen);
 }
 
-static bool jsoReadBlock(JsoCtx* ctx, uint32_t blkIdx, uint8_t* out) {
+static bool jsoDecode(BlockDevice& dev, uint32_t blkIdx, uint8_t* out) {
+    const DiscParams& p = dev.params;
     uint32_t i0=0, i1=0;
-    if (!readAt(ctx->fd, ctx->index_off + blkIdx*4,     &i0, 4)) return false;
-    if (!readAt(ctx->fd, ctx->index_off + (blkIdx+1)*4, &i1, 4)) return false;
+    if (!indexPair(dev, blkIdx, i0, i1)) return false;
 
     bool stored = (i0 & 0x80000000u) != 0;
-    uint32_t off0 = (i0 & 0x7FFFFFFFu) << ctx->align;
-    uint32_t off1 = (i1 & 0x7FFFFFFFu) << ctx->align;
-    if (off1 <= off0 || off1 > ctx->file_size) off1 = ctx->file_size;
+    uint32_t off0 = (i0 & 0x7FFFFFFFu) << p.align;
+    uint32_t off1 = (i1 & 0x7FFFFFFFu) << p.align;
+    if (off1 <= off0 || off1 > dev.fileSize) off1 = dev.fileSize;
 
     uint32_t compSize = (off1 > off0) ? (off1 - off0) : 0;
 
     if (stored) {
-        if (compSize < ctx->block_size) return false;
-        return readAt(ctx->fd, off0, out, ctx->block_size);
+        if (compSize < p.blockSize) return false;
+        return devReadRaw(dev, off0, out, p.blockSize);
     }
 
     if (compSize == 0 || compSize > 1024*1024) return false;
 
-    std::vector<uint8_t> in(compSize);
-    if (!readAt(ctx->fd, off0, in.data(), compSize)) return false;
+    const uint8_t* in = devInput(dev, off0, compSize);
+    if (!in) return false;
 
-    if (jsoDecompress(in.data(), compSize, out, ctx->block_size, ctx->method))
+    if (jsoDecompress(dev.inflater, in, compSize, out, p.blockSize, p.method))
         return true;
 
     // Some JSO writers fail to mark stored, but compSize == block_size → treat as raw
-    if (compSize == ctx->block_size)
-        return readAt(ctx->fd, off0, out, ctx->block_size);
-
+    if (compSize == p.blockSize) {
+        memcpy(out, in, compSize);
+        return true;
+    }
     return false;
 }
 
-static bool jsoReadSectors(void* vctx, uint32_t lba, uint32_t count, uint8_t* out) {
-    JsoCtx* ctx = (JsoCtx*)vctx;
-    if (ctx->block_size < ISO_SECTOR || (ctx->block_size % ISO_SECTOR) != 0) return false;
-
-    const uint32_t spb = ctx->block_size / ISO_SECTOR;  // sectors per compressed block
-    std::vector<uint8_t> block(ctx->block_size);
-
-    for (uint32_t i = 0; i < count; ++i) {
-        uint32_t L      = lba + i;
-        uint32_t blkIdx = L / spb;
-        uint32_t sub    = L % spb;
-
-        if (!jsoReadBlock(ctx, blkIdx, block.data())) return false;
-        memcpy(out + i * ISO_SECTOR, block.data() + sub * ISO_SECTOR, ISO_SECTOR);
-    }
-    return true;
-}
+// JISO header as the common compressors write it; the index follows it.
+#pragma pack(push,1)
+struct JISOHeader {
+    uint32_t magic;          // 'JISO'
+    uint8_t  unk0, unk1;
+    uint16_t block_size;     // bytes per block
+    uint8_t  block_headers;  // 0 = none
+    uint8_t  unk2;
+    uint8_t  method;         // 0 = LZO, 1 = zlib
+    uint8_t  unk3;
+    uint32_t total_bytes;    // uncompressed size
+    uint8_t  md5[16];
+    uint32_t header_size;    // index offset (0x30)
+};
+#pragma pack(pop)
 
-// Probe for index offset by using a simple structural heuristic.
-static bool jsoFindIndexOffset(const uint8_t* hdr, uint32_t hdrSize, uint32_t fsize, uint32_t& index_off_out) {
+// Probe for index offset by using a simple structural heuristic; the
+// first entry points just past the table, which gives its length.
+static bool jsoFindIndexOffset(const uint8_t* hdr, uint32_t hdrSize, uint32_t fsize,
+                               uint32_t& index_off_out, uint32_t& entries_out) {
     uint32_t limit = (hdrSize < 0x800) ? hdrSize : 0x800;
     for (uint32_t s = 0x10; s + 8 <= limit; s += 4) {
         uint32_t a = le32(hdr + s);
@@ -485,6 +683,7 @@ static bool jsoFindIndexOffset(const uint8_t* hdr, uint32_t hdrSize, uint32_t fs
             uint32_t blocks_plus1 = (a - s) / 4;
             if (blocks_plus1 > 16 && blocks_plus1 < 4u*1024u*1024u) {
                 index_off_out = s;
+                entries_out   = blocks_plus1;
                 return true;
             }
         }
@@ -492,181 +691,206 @@ static bool jsoFindIndexOffset(const uint8_t* hdr, uint32_t hdrSize, uint32_t fs
     return false;
 }
 
-static bool jsoOpen(SceUID fd, JsoCtx*& outCtx) {
-    outCtx = nullptr;
+static bool jsoOpen(BlockDevice& dev, const DiscParams* known) {
     (void)lzo_init(); // safe to call multiple times
+    if (devTryKnown(dev, known, jsoDecode)) return true;
 
     uint8_t hdr[0x400] = {0};
-    if (!readAt(fd, 0, hdr, sizeof(hdr))) return false;
+    if (!readAt(dev.fd, 0, hdr, sizeof(hdr))) return false;
     if (memcmp(hdr, "JISO", 4) != 0) return false;
+    if (!dev.fileSize) return false;
+
+    DiscParams& p = dev.params;
+    p.format   = DF_JSO;
+    dev.decode = jsoDecode;
+
+    // The header's own fields first; the probe below covers writers that
+    // fill them in differently.
+    JISOHeader jh;
+    memcpy(&jh, hdr, sizeof(jh));
+    if (jh.block_size && jh.block_headers == 0 && jh.method <= 1 &&
+        jh.header_size >= sizeof(jh) && jh.header_size < dev.fileSize) {
+        uint64_t entries = jh.total_bytes ? ((uint64_t)jh.total_bytes + jh.block_size - 1) / jh.block_size + 1 : 0;
+        p.blockSize = jh.block_size; p.align = 0; p.method = jh.method ? 1 : 2;
+        p.indexOff  = jh.header_size;
+        if (indexSetup(dev, p.indexOff, entries) && devProbe(dev)) return true;
+    }
 
-    uint32_t fsize = fileSize32(fd);
-    if (!fsize) return false;
-
-    uint32_t index_off = 0;
-    if (!jsoFindIndexOffset(hdr, sizeof(hdr), fsize, index_off)) index_off = 0x20;
+    uint32_t index_off = 0, entries = 0;
+    if (!jsoFindIndexOffset(hdr, sizeof(hdr), dev.fileSize, index_off, entries)) index_off = 0x20;
+    if (!indexSetup(dev, index_off, entries)) return false;
 
     const uint32_t blockCands[] = { 2048, 4096, 8192 };
     const uint8_t  alignCands[] = { 0, 1, 2, 3, 4 };
     const uint8_t  methodCands[] = { 2 /*LZO*/, 1 /*zlib*/ };
 
+    p.indexOff = index_off;
     for (uint32_t bs : blockCands) {
         for (uint8_t al : alignCands) {
             for (uint8_t m : methodCands) {
-                JsoCtx* ctx = new JsoCtx();
-                ctx->fd         = fd;
-                ctx->index_off  = index_off;
-                ctx->block_size = bs;
-                ctx->align      = al;
-                ctx->method     = m;
-                ctx->file_size  = fsize;
-
-                std::vector<uint8_t> pvd(ISO_SECTOR);
-                if (jsoReadSectors(ctx, 16, 1, pvd.data()) &&
-                    pvd[0]==1 && memcmp(&pvd[1],"CD001",5)==0 && pvd[6]==1) {
-                    outCtx = ctx;
-                    return true;
-                }
-                delete ctx;
+                p.blockSize = bs; p.align = al; p.method = m;
+                if (devProbe(dev)) return true;
             }
         }
     }
     return false;
 }
-static void jsoClose(JsoCtx*& ctx) { if (ctx) { delete ctx; ctx=nullptr; } }
-
-bool readJsoTitle(const std::string& path, std::string& outTitle) {
-    SceUID fd = sceIoOpen(path.c_str(), PSP_O_RDONLY, 0);
-    if (fd < 0) return false;
-    JsoCtx* ctx = nullptr;
-    bool ok = jsoOpen(fd, ctx) && readTitleViaSectors(jsoReadSectors, ctx, outTitle);
-    if (ctx) jsoClose(ctx);
-    sceIoClose(fd);
-    return ok;
-}
-bool readJsoIconPNG(const std::string& path, std::vector<uint8_t>& outVec) {
-    SceUID fd = sceIoOpen(path.c_str(), PSP_O_RDONLY, 0);
-    if (fd < 0) return false;
-    JsoCtx* ctx = nullptr;
-    bool ok = jsoOpen(fd, ctx) && readIconViaSectors(jsoReadSectors, ctx, outVec);
-    if (ctx) jsoClose(ctx);
-    sceIoClose(fd);
-    return ok;
-}
 
 // ================================================================
-// DAX reader — pragmatic variant detector (8K deflate frames)
+// DAX backend — pragmatic variant detector (8K deflate frames)
 // ================================================================
-struct DaxCtx {
-    SceUID   fd;
-    uint32_t index_off;
-    uint32_t block_size; // 8K typical
-    uint8_t  align;      // shift for offsets (often 0..4)
-    bool     msbStored;  // whether high bit of index marks "stored"
-};
-
-static bool daxDecompress(const uint8_t* in, uint32_t inLen, uint8_t* out, uint32_t outLen){
-    return inflateRawOrZlib(in, inLen, out, outLen);
+static bool daxDecompress(Inflater& z, const uint8_t* in, uint32_t inLen, uint8_t* out, uint32_t outLen){
+    return inflateRawOrZlib(z, in, inLen, out, outLen);
 }
 
-static bool daxReadBlock(DaxCtx* ctx, uint32_t lba, uint8_t* out) {
-    uint32_t sectorsPerFrame = ctx->block_size / ISO_SECTOR; // usually 4
-    uint32_t frameIndex = lba / sectorsPerFrame;
-    uint32_t sub        = lba % sectorsPerFrame;
-
-    uint32_t idxOff = ctx->index_off + frameIndex*4;
+// Whole frame frameIndex (block_size bytes) into out. params.method 1 =
+// the high bit of an index entry marks a stored frame.
+static bool daxDecode(BlockDevice& dev, uint32_t frameIndex, uint8_t* out) {
+    const DiscParams& p = dev.params;
     uint32_t i0=0, i1=0;
-    if (!readAt(ctx->fd, idxOff,   &i0, 4)) return false;
-    if (!readAt(ctx->fd, idxOff+4, &i1, 4)) return false;
+    if (!indexPair(dev, frameIndex, i0, i1)) return false;
 
-    uint32_t off0 = (i0 & 0x7FFFFFFF) << ctx->align;
-    uint32_t off1 = (i1 & 0x7FFFFFFF) << ctx->align;
+    uint32_t off0 = (i0 & 0x7FFFFFFF) << p.align;
+    uint32_t off1 = (i1 & 0x7FFFFFFF) << p.align;
     uint32_t compSize = (off1 > off0) ? (off1 - off0) : 0;
-    bool stored = ctx->msbStored ? ((i0 & 0x80000000u) != 0) : false;
+    bool stored = p.method ? ((i0 & 0x80000000u) != 0) : false;
 
     if (compSize == 0 || compSize > 1*1024*1024) return false;
 
-    std::vector<uint8_t> frameBuf(ctx->block_size);
-    if (stored) {
-        if (!readAt(ctx->fd, off0, frameBuf.data(), ctx->block_size)) return false;
-    } else {
-        std::vector<uint8_t> in(compSize);
-        if (!readAt(ctx->fd, off0, in.data(), compSize)) return false;
-        if (!daxDecompress(in.data(), compSize, frameBuf.data(), ctx->block_size)) return false;
-    }
-
-    memcpy(out, frameBuf.data() + sub*ISO_SECTOR, ISO_SECTOR);
-    return true;
-}
-
-static bool daxReadSectors(void* vctx, uint32_t lba, uint32_t count, uint8_t* out) {
-    DaxCtx* ctx = (DaxCtx*)vctx;
-    for (uint32_t i = 0; i < count; ++i)
-        if (!daxReadBlock(ctx, lba + i, out + i*ISO_SECTOR)) return false;
-    return true;
+    if (stored) return devReadRaw(dev, off0, out, p.blockSize);
+    const uint8_t* in = devInput(dev, off0, compSize);
+    return in && daxDecompress(dev.inflater, in, compSize, out, p.blockSize);
 }
 
-static bool daxTryProbe(SceUID fd, uint32_t headerSize, uint32_t blockSize, uint8_t align, bool msbStored, DaxCtx*& out) {
-    DaxCtx* ctx = new DaxCtx();
-    ctx->fd = fd; ctx->index_off = headerSize; ctx->block_size = blockSize;
-    ctx->align = align; ctx->msbStored = msbStored;
-
-    std::vector<uint8_t> pvd(ISO_SECTOR);
-    bool ok = daxReadSectors(ctx, 16, 1, pvd.data())
-              && pvd[0]==1 && memcmp(&pvd[1],"CD001",5)==0 && pvd[6]==1;
-    if (!ok) { delete ctx; return false; }
-    out = ctx; return true;
-}
+#pragma pack(push,1)
+struct DAXHeader {
+    uint32_t magic;        // 'DAX\0'
+    uint32_t total_bytes;  // uncompressed size
+    uint32_t version;      // 0 or 1
+    uint32_t nc_areas;     // non-compressed areas (version 1)
+    uint32_t reserved[4];
+};                         // frame index follows
+#pragma pack(pop)
 
-static bool daxOpen(SceUID fd, DaxCtx*& outCtx) {
-    outCtx = nullptr;
+static bool daxOpen(BlockDevice& dev, const DiscParams* known) {
+    if (devTryKnown(dev, known, daxDecode)) return true;
 
-    uint8_t hdr[64]; if (!readAt(fd, 0, hdr, sizeof(hdr))) return false;
+    uint8_t hdr[64]; if (!readAt(dev.fd, 0, hdr, sizeof(hdr))) return false;
     bool magicDAX = (memcmp(hdr, "DAX", 3) == 0);
     bool magicDAX0 = (memcmp(hdr, "DAX\0", 4) == 0) || (memcmp(hdr, "DAX ", 4) == 0);
     const uint32_t DAX_FRAME = 8*1024;
 
+    // The header's layout (index at 0x20, unshifted) is tried first, with
+    // both readings of the high bit.
     struct Candidate { uint32_t hsz; uint8_t align; bool msb; } cands[] = {
-        { 0x20, 0, true }, { 0x20, 1, true }, { 0x20, 2, true },
+        { 0x20, 0, true }, { 0x20, 0, false},
+        { 0x20, 1, true }, { 0x20, 2, true },
         { 0x18, 0, true }, { 0x18, 1, true }, { 0x18, 2, true },
         { 0x24, 0, true }, { 0x24, 1, true }, { 0x24, 2, true },
-        { 0x20, 0, false}, { 0x20, 1, false}, { 0x20, 2, false}
+        { 0x20, 1, false}, { 0x20, 2, false}
     };
 
     if (!magicDAX && !magicDAX0) return false;
 
+    // Frames + 1 from the header bounds index reads at its offset.
+    DAXHeader dh;
+    memcpy(&dh, hdr, sizeof(dh));
+    const uint64_t hdrEntries = (dh.version <= 1 && dh.total_bytes)
+                              ? ((uint64_t)dh.total_bytes + DAX_FRAME - 1) / DAX_FRAME + 1 : 0;
+
+    DiscParams& p = dev.params;
+    p.format    = DF_DAX;
+    p.blockSize = DAX_FRAME;
+    dev.decode  = daxDecode;
     for (auto &c : cands) {
-        DaxCtx* ctx = nullptr;
-        if (daxTryProbe(fd, c.hsz, DAX_FRAME, c.align, c.msb, ctx)) {
-            outCtx = ctx;
-            return true;
-        }
+        if (!indexSetup(dev, c.hsz, c.hsz == sizeof(DAXHeader) ? hdrEntries : 0)) continue;
+        p.indexOff = c.hsz; p.align = c.align; p.method = c.msb ? 1 : 0;
+        if (devProbe(dev)) return true;
     }
     return false;
 }
-static void daxClose(DaxCtx*& ctx){ if (ctx){ delete ctx; ctx=nullptr; } }
 
-bool readDaxTitle(const std::string& path, std::string& outTitle) {
-    SceUID fd = sceIoOpen(path.c_str(), PSP_O_RDONLY, 0);
-    if (fd < 0) return false;
-    DaxCtx* ctx = nullptr;
-    bool ok = daxOpen(fd, ctx) && readTitleViaSectors(daxReadSectors, ctx, outTitle);
-    if (ctx) daxClose(ctx);
-    sceIoClose(fd);
+// ================================================================
+// Device open / close
+// ================================================================
+static void devClose(BlockDevice& dev) {
+    if (dev.fd >= 0) sceIoClose(dev.fd);
+    dev.fd = -1;
+}
+
+// Open path as a `format` image (CSO also accepts ZSO and vice versa;
+// the header decides). known: a JSO/DAX layout from an earlier open, tried
+// before any probing. On success dev.params holds the detected layout.
+static bool devOpen(const std::string& path, uint8_t format, BlockDevice& dev, const DiscParams* known = nullptr) {
+    dev.fd = sceIoOpen(path.c_str(), PSP_O_RDONLY, 0);
+    if (dev.fd < 0) return false;
+    if (format != DF_ISO) dev.fileSize = fileSize32(dev.fd);
+
+    bool ok = false;
+    switch (format) {
+    case DF_ISO:
+        dev.params.format    = DF_ISO;
+        dev.params.blockSize = ISO_SECTOR;
+        ok = true;
+        break;
+    case DF_CSO: case DF_ZSO: ok = cisoOpen(dev); break;
+    case DF_JSO:              ok = jsoOpen(dev, known); break;
+    case DF_DAX:              ok = daxOpen(dev, known); break;
+    }
+    if (ok && dev.decode && (dev.params.blockSize < ISO_SECTOR || dev.params.blockSize % ISO_SECTOR)) ok = false;
+    if (!ok) devClose(dev);
     return ok;
 }
-bool readDaxIconPNG(const std::string& path, std::vector<uint8_t>& outVec) {
-    SceUID fd = sceIoOpen(path.c_str(), PSP_O_RDONLY, 0);
-    if (fd < 0) return false;
-    DaxCtx* ctx = nullptr;
-    bool ok = daxOpen(fd, ctx) && readIconViaSectors(daxReadSectors, ctx, outVec);
-    if (ctx) daxClose(ctx);
-    sceIoClose(fd);
-    return ok;
+
+// ================================================================
+// Remembered layouts. JSO and DAX headers don't reliably describe the
+// layout, so what an open settles on is kept per path (and seeded from
+// the catalog) and the next open of that file skips probing.
+// ================================================================
+#define DISC_PARAMS_SLOTS 64
+
+namespace {
+struct RememberedParams { std::string path; DiscParams params; };
+
+struct ParamsCache {
+    SceUID           lock;
+    RememberedParams slot[DISC_PARAMS_SLOTS];
+    unsigned         next = 0;   // round-robin replacement
+    ParamsCache() { lock = sceKernelCreateSema("KFE_DiscParams", 0, 1, 1, nullptr); }
+};
+ParamsCache gParams;
+
+struct ParamsGuard {
+    ParamsGuard()  { if (gParams.lock >= 0) sceKernelWaitSema(gParams.lock, 1, nullptr); }
+    ~ParamsGuard() { if (gParams.lock >= 0) sceKernelSignalSema(gParams.lock, 1); }
+};
+}
+
+static inline bool isProbedFormat(uint8_t f) { return f == DF_JSO || f == DF_DAX; }
+static inline bool sameParams(const DiscParams& a, const DiscParams& b) {
+    return a.format == b.format && a.align == b.align && a.method == b.method &&
+           a.blockSize == b.blockSize && a.indexOff == b.indexOff;
+}
+
+static bool recallParams(const std::string& path, uint8_t format, DiscParams& out) {
+    ParamsGuard g;
+    for (const RememberedParams& r : gParams.slot)
+        if (r.params.format == format && r.path == path) { out = r.params; return true; }
+    return false;
+}
+
+void discRememberParams(const std::string& path, const DiscParams& params) {
+    if (!isProbedFormat(params.format) || !params.blockSize) return;
+    ParamsGuard g;
+    for (RememberedParams& r : gParams.slot)
+        if (r.path == path) { r.params = params; return; }
+    RememberedParams& r = gParams.slot[gParams.next++ % DISC_PARAMS_SLOTS];
+    r.path   = path;
+    r.params = params;
 }
 
 // ================================================================
-// Public convenience: pick the right extractor for ICON0
+// Public convenience: pick the container by extension
 // ================================================================
 static char toLowerC(char c){ return (c>='A'&&c<='Z')? (char)(c-'A'+'a'):c; }
 static bool endsWithNoCase(const std::string& s, const char* ext){
@@ -676,35 +900,66 @@ static bool endsWithNoCase(const std::string& s, const char* ext){
     return true;
 }
 
-bool ExtractIcon0PNG(const std::string& path, std::vector<uint8_t>& outVec) {
-    outVec.clear();
-
-    if (endsWithNoCase(path, ".iso")) {
-        SceUID fd = sceIoOpen(path.c_str(), PSP_O_RDONLY, 0);
-        if (fd < 0) return false;
-        auto readSec = [](void* vfd, uint32_t lba, uint32_t cnt, uint8_t* out)->bool{
-            return readAt((SceUID)(intptr_t)vfd, lba * ISO_SECTOR, out, cnt * ISO_SECTOR);
-        };
-        bool ok = readIconViaSectors(readSec, (void*)(intptr_t)fd, outVec);
-        sceIoClose(fd); return ok;
-    }
+static uint8_t discFormatOf(const std::string& path) {
+    if (endsWithNoCase(path, ".iso")) return DF_ISO;
+    if (endsWithNoCase(path, ".cso")) return DF_CSO;
+    if (endsWithNoCase(path, ".zso")) return DF_ZSO;
+    if (endsWithNoCase(path, ".jso")) return DF_JSO;
+    if (endsWithNoCase(path, ".dax")) return DF_DAX;
+    return DF_UNKNOWN;
+}
 
-    if (endsWithNoCase(path, ".cso") || endsWithNoCase(path, ".zso")) {
-        CompressedIso ci; if (!cisoOpen(path, ci)) return false;
-        auto readSec = [](void* vci, uint32_t lba, uint32_t cnt, uint8_t* out)->bool{
-            return cisoReadSectors(*(CompressedIso*)vci, lba, cnt, out);
-        };
-        bool ok = readIconViaSectors(readSec, &ci, outVec);
-        cisoClose(ci); return ok;
-    }
+// ================================================================
+// Public: title + DISC_ID + ICON0 + detected container layout in one open
+// ================================================================
+static bool readMetaAs(const std::string& path, uint8_t format, std::string* outTitle, std::string* outDiscId,
+                       DiscParams* outParams, std::vector<uint8_t>* outIcon) {
+    if (outTitle)  outTitle->clear();
+    if (outDiscId) outDiscId->clear();
+    if (outIcon)   outIcon->clear();
+    if (outParams) *outParams = DiscParams();
+
+    DiscParams known;
+    const bool haveKnown = isProbedFormat(format) && recallParams(path, format, known);
+
+    BlockDevice dev;
+    if (!devOpen(path, format, dev, haveKnown ? &known : nullptr)) return false;
+    if (outParams) *outParams = dev.params;
+    if (isProbedFormat(format) && (!haveKnown || !sameParams(known, dev.params)))
+        discRememberParams(path, dev.params);
+    bool ok = readMetaViaSectors(devReadSectors, &dev, outTitle, outDiscId, outIcon);
+    devClose(dev);
+    return ok;
+}
 
-    if (endsWithNoCase(path, ".dax")) {
-        return readDaxIconPNG(path, outVec);
-    }
+bool readDiscMeta(const std::string& path, std::string* outTitle, std::string* outDiscId,
+                  DiscParams* outParams, std::vector<uint8_t>* outIcon) {
+    return readMetaAs(path, discFormatOf(path), outTitle, outDiscId, outParams, outIcon);
+}
 
-    if (endsWithNoCase(path, ".jso")) {
-        return readJsoIconPNG(path, outVec);
-    }
+bool readDiscInfo(const std::string& path, std::string& outTitle, std::string& outDiscId, DiscParams& outParams) {
+    return readDiscMeta(path, &outTitle, &outDiscId, &outParams, nullptr);
+}
 
-    return false;
+bool ExtractIcon0PNG(const std::string& path, std::vector<uint8_t>& outVec) {
+    return readDiscMeta(path, nullptr, nullptr, nullptr, &outVec);
+}
+
+bool readIsoTitle(const std::string& path, std::string& outTitle) {
+    return readMetaAs(path, DF_ISO, &outTitle, nullptr, nullptr, nullptr);
+}
+bool readCompressedIsoTitle(const std::string& path, std::string& outTitle) {
+    return readMetaAs(path, DF_CSO, &outTitle, nullptr, nullptr, nullptr);
+}
+bool readJsoTitle(const std::string& path, std::string& outTitle) {
+    return readMetaAs(path, DF_JSO, &outTitle, nullptr, nullptr, nullptr);
+}
+bool readDaxTitle(const std::string& path, std::string& outTitle) {
+    return readMetaAs(path, DF_DAX, &outTitle, nullptr, nullptr, nullptr);
+}
+bool readJsoIconPNG(const std::string& path, std::vector<uint8_t>& outVec) {
+    return readMetaAs(path, DF_JSO, nullptr, nullptr, nullptr, &outVec);
+}
+bool readDaxIconPNG(const std::string& path, std::vector<uint8_t>& outVec) {
+    return readMetaAs(path, DF_DAX, nullptr, nullptr, nullptr, &outVec);
 }